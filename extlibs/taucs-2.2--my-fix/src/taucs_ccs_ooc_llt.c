@@ -2941,6 +2941,154 @@ int taucs_dtl(ooc_factor_llt_panelchoice) (taucs_ccs_matrix * A, taucs_io_handle
 	return 0;
 }
 
+/*************************************************************/
+
+/* log determinant and in-core copy of an ooc factor         */
+
+/*************************************************************/
+
+int taucs_dtl(ooc_log_determinant) (void *vL, double *logdet) {
+	taucs_io_handle *handle = (taucs_io_handle *) vL;
+	taucs_datatype *sn_block;
+	int n_sn, sn, jp;
+	int *sn_size;
+
+	/*
+	 * only the diagonal blocks are needed, so this streams through the file one supernode at the time
+	 */
+	taucs_io_read(handle, 0, 1, 1, TAUCS_INT, &n_sn);
+	sn_size = (int *) taucs_malloc((n_sn + 1) * sizeof(int));
+	if (!sn_size) {
+		taucs_printf("taucs_ooc_log_determinant: out of memory\n");
+		return -1;
+	}
+	taucs_io_read(handle, 3, 1, n_sn, TAUCS_INT, sn_size);
+
+	*logdet = 0.0;
+	for (sn = 0; sn < n_sn; sn++) {
+		if (sn_size[sn] == 0)
+			continue;
+
+		sn_block = (taucs_datatype *) taucs_malloc(sn_size[sn] * sn_size[sn] * sizeof(taucs_datatype));
+		if (!sn_block) {
+			taucs_free(sn_size);
+			taucs_printf("taucs_ooc_log_determinant: out of memory\n");
+			return -1;
+		}
+		taucs_io_read(handle, IO_BASE + n_sn + 2 * sn, sn_size[sn], sn_size[sn], TAUCS_CORE_DATATYPE, sn_block);
+		for (jp = 0; jp < sn_size[sn]; jp++) {
+			*logdet += log(taucs_re(sn_block[sn_size[sn] * jp + jp]));
+		}
+		taucs_free(sn_block);
+	}
+	*logdet *= 2.0;
+
+	taucs_free(sn_size);
+	return 0;
+}
+
+taucs_ccs_matrix *taucs_dtl(ooc_factor_to_ccs) (void *vL) {
+	taucs_io_handle *handle = (taucs_io_handle *) vL;
+	taucs_ccs_matrix *C;
+	taucs_datatype *sn_block, *up_block;
+	int n, n_sn, sn, ip, jp, j, next, nnz, sn_size, up_size, max_sn_len, max_up_len;
+	int *sn_sizes, *sn_up_sizes, *sn_struct, *len;
+
+	taucs_io_read(handle, 5, 1, 1, TAUCS_INT, &n);
+	taucs_io_read(handle, 0, 1, 1, TAUCS_INT, &n_sn);
+
+	sn_sizes = (int *) taucs_malloc((n_sn + 1) * sizeof(int));
+	sn_up_sizes = (int *) taucs_malloc((n_sn + 1) * sizeof(int));
+	sn_struct = (int *) taucs_malloc((n + 1) * sizeof(int));
+	len = (int *) taucs_calloc(n + 1, sizeof(int));
+	if (!sn_sizes || !sn_up_sizes || !sn_struct || !len) {
+		taucs_free(sn_sizes);
+		taucs_free(sn_up_sizes);
+		taucs_free(sn_struct);
+		taucs_free(len);
+		taucs_printf("taucs_ooc_factor_to_ccs: out of memory\n");
+		return NULL;
+	}
+	taucs_io_read(handle, 3, 1, n_sn, TAUCS_INT, sn_sizes);
+	taucs_io_read(handle, 4, 1, n_sn, TAUCS_INT, sn_up_sizes);
+
+	/*
+	 * the row structure of each supernode is sorted, so column jp in supernode sn holds sn_up_size - jp elements
+	 */
+	nnz = 0;
+	max_sn_len = max_up_len = 1;
+	for (sn = 0; sn < n_sn; sn++) {
+		taucs_io_read(handle, IO_BASE + sn, 1, sn_up_sizes[sn], TAUCS_INT, sn_struct);
+		for (jp = 0; jp < sn_sizes[sn]; jp++) {
+			len[sn_struct[jp]] = sn_up_sizes[sn] - jp;
+			nnz += sn_up_sizes[sn] - jp;
+		}
+		max_sn_len = max(max_sn_len, sn_sizes[sn] * sn_sizes[sn]);
+		max_up_len = max(max_up_len, (sn_up_sizes[sn] - sn_sizes[sn]) * sn_sizes[sn]);
+	}
+
+	/*
+	 * one buffer for the blocks, large enough for the largest supernode 
+	 */
+	C = taucs_dtl(ccs_create) (n, n, nnz);
+	sn_block = (taucs_datatype *) taucs_malloc(max_sn_len * sizeof(taucs_datatype));
+	up_block = (taucs_datatype *) taucs_malloc(max_up_len * sizeof(taucs_datatype));
+	if (!C || !sn_block || !up_block) {
+		if (C)
+			taucs_ccs_free(C);
+		taucs_free(sn_block);
+		taucs_free(up_block);
+		taucs_free(sn_sizes);
+		taucs_free(sn_up_sizes);
+		taucs_free(sn_struct);
+		taucs_free(len);
+		taucs_printf("taucs_ooc_factor_to_ccs: out of memory\n");
+		return NULL;
+	}
+	C->flags |= TAUCS_TRIANGULAR | TAUCS_LOWER;
+
+	(C->colptr)[0] = 0;
+	for (j = 1; j <= n; j++)
+		(C->colptr)[j] = (C->colptr)[j - 1] + len[j - 1];
+
+	for (sn = 0; sn < n_sn; sn++) {
+		sn_size = sn_sizes[sn];
+		up_size = sn_up_sizes[sn] - sn_size;
+		if (sn_size == 0)
+			continue;
+
+		taucs_io_read(handle, IO_BASE + sn, 1, sn_size + up_size, TAUCS_INT, sn_struct);
+		taucs_io_read(handle, IO_BASE + n_sn + 2 * sn, sn_size, sn_size, TAUCS_CORE_DATATYPE, sn_block);
+		if (up_size > 0) {
+			taucs_io_read(handle, IO_BASE + n_sn + 2 * sn + 1, up_size, sn_size, TAUCS_CORE_DATATYPE, up_block);
+		}
+
+		for (jp = 0; jp < sn_size; jp++) {
+			j = sn_struct[jp];
+			next = (C->colptr)[j];
+			for (ip = jp; ip < sn_size; ip++) {
+				(C->rowind)[next] = sn_struct[ip];
+				(C->taucs_values)[next] = sn_block[sn_size * jp + ip];
+				next++;
+			}
+			for (ip = 0; ip < up_size; ip++) {
+				(C->rowind)[next] = sn_struct[sn_size + ip];
+				(C->taucs_values)[next] = up_block[up_size * jp + ip];
+				next++;
+			}
+		}
+	}
+
+	taucs_free(sn_block);
+	taucs_free(up_block);
+	taucs_free(sn_sizes);
+	taucs_free(sn_up_sizes);
+	taucs_free(sn_struct);
+	taucs_free(len);
+
+	return C;
+}
+
 #else							       /* TAUCS_CORE_GENRAL */
 
 /*************************************************************/
@@ -3038,6 +3186,67 @@ int taucs_ooc_solve_llt(void *L /* actual type: taucs_io_handle* */ ,
 	return -1;
 }
 
+int taucs_ooc_log_determinant(void *L /* actual type: taucs_io_handle* */ ,
+			      double *logdet)
+{
+	int flags;
+
+	taucs_io_read((taucs_io_handle *) L, 6, 1, 1, TAUCS_INT, &flags);
+
+#ifdef TAUCS_CONFIG_DREAL
+	if (flags & TAUCS_DOUBLE)
+		return taucs_dooc_log_determinant(L, logdet);
+#endif
+
+#ifdef TAUCS_CONFIG_SREAL
+	if (flags & TAUCS_SINGLE)
+		return taucs_sooc_log_determinant(L, logdet);
+#endif
+
+#ifdef TAUCS_CONFIG_DCOMPLEX
+	if (flags & TAUCS_DCOMPLEX)
+		return taucs_zooc_log_determinant(L, logdet);
+#endif
+
+#ifdef TAUCS_CONFIG_SCOMPLEX
+	if (flags & TAUCS_SCOMPLEX)
+		return taucs_cooc_log_determinant(L, logdet);
+#endif
+
+	assert(0);
+	return -1;
+}
+
+taucs_ccs_matrix *taucs_ooc_factor_to_ccs(void *L /* actual type: taucs_io_handle* */ )
+{
+	int flags;
+
+	taucs_io_read((taucs_io_handle *) L, 6, 1, 1, TAUCS_INT, &flags);
+
+#ifdef TAUCS_CONFIG_DREAL
+	if (flags & TAUCS_DOUBLE)
+		return taucs_dooc_factor_to_ccs(L);
+#endif
+
+#ifdef TAUCS_CONFIG_SREAL
+	if (flags & TAUCS_SINGLE)
+		return taucs_sooc_factor_to_ccs(L);
+#endif
+
+#ifdef TAUCS_CONFIG_DCOMPLEX
+	if (flags & TAUCS_DCOMPLEX)
+		return taucs_zooc_factor_to_ccs(L);
+#endif
+
+#ifdef TAUCS_CONFIG_SCOMPLEX
+	if (flags & TAUCS_SCOMPLEX)
+		return taucs_cooc_factor_to_ccs(L);
+#endif
+
+	assert(0);
+	return NULL;
+}
+
 #endif							       /* TAUCS_CORE_GENRAL */
 
 /*************************************************************/
@@ -795,7 +795,9 @@ static void taucs_ccs_metis(taucs_ccs_matrix * m, int **perm, int **invperm, cha
 	options_flag[4] = 0;				       /* no debug */
 	options_flag[5] = 1;				       /* default */
 	options_flag[6] = 0; 				       /* THIS IS SLOW if non-zero. global nodes */
-	options_flag[7] = 3;				       /* number of separators */
+	options_flag[7] = 3;				       /* number of separators, or as given by "metis:<nseps>" */
+	if (!strncmp(which, "metis:", 6) && atoi(which + 6) > 0)
+		options_flag[7] = atoi(which + 6);
 
 	METIS_NodeND(&n, xadj, adj, &num_flag, options_flag, *perm, *invperm);
 
@@ -855,7 +857,7 @@ void taucs_ccs_order(taucs_ccs_matrix * m, int **perm, int **invperm, char *whic
 	if (!strcmp(which, "mmd") || !strcmp(which, "amd") || !strcmp(which, "md") || !strcmp(which, "amdbar") ||
 	    !strcmp(which, "amdc") || !strcmp(which, "amdbarc"))
 		taucs_ccs_amd(m, perm, invperm, which);
-	else if (!strcmp(which, "metis"))
+	else if (!strcmp(which, "metis") || !strncmp(which, "metis:", 6))
 		taucs_ccs_metis(m, perm, invperm, which);
 	else if (!strcmp(which, "genmmd"))
 		taucs_ccs_genmmd(m, perm, invperm, which);
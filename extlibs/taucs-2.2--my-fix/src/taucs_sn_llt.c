@@ -15,6 +15,12 @@
 #define TAUCS_CORE_CILK
 #include "taucs.h"
 
+#if defined(_OPENMP) && !defined(TAUCS_CILK)
+#include <string.h>
+#include <omp.h>
+#define TAUCS_OMP
+#endif
+
 #ifdef TAUCS_CILK
 #pragma lang -C
 #endif
@@ -534,9 +540,25 @@ typedef struct {
 	taucs_datatype *f1;
 	taucs_datatype *f2;
 	taucs_datatype *u;
+	size_t u_cap;					       /* allocated length of u, when taken from a pool */
 
 } supernodal_frontal_matrix;
 
+/*
+ * a small per-thread cache of update-matrix buffers, so that threads reuse the memory of the update matrices they have
+ * already extend-added instead of going to the allocator for each front. each pool holds at most FRONTAL_POOL_SIZE
+ * buffers and at most FRONTAL_POOL_BYTES bytes.
+ */
+#define FRONTAL_POOL_SIZE 8
+#define FRONTAL_POOL_BYTES ((size_t) 8 * 1024 * 1024)
+
+typedef struct {
+	int n;
+	size_t bytes;
+	size_t cap[FRONTAL_POOL_SIZE];
+	taucs_datatype *buf[FRONTAL_POOL_SIZE];
+} supernodal_frontal_pool;
+
 #define SFM_F1 f1
 #define SFM_F2 f2
 #define SFM_U   u
@@ -561,6 +583,8 @@ typedef struct {
 
 	int *up_blocks_ld;				       /* lda of update blocks */
 	taucs_datatype **up_blocks;			       /* update blocks */
+
+	void *shared;					       /* GMRFLib: the symbolic part is shared with other copies, if non-NULL */
 } supernodal_factor_matrix;
 
 #ifdef TAUCS_CORE_GENERAL
@@ -755,6 +779,7 @@ static supernodal_factor_matrix *multifrontal_supernodal_create()
 	L->sn_blocks = NULL;
 	L->up_blocks_ld = NULL;
 	L->up_blocks = NULL;
+	L->shared = NULL;
 
 	return L;
 }
@@ -962,7 +987,80 @@ taucs_datatype *taucs_dtl(supernodal_factor_get_diag) (void *vL) {
 
 /*************************************************************/
 
-static supernodal_frontal_matrix *supernodal_frontal_create(int *firstcol_in_supernode, int sn_size, int n, int *rowind)
+static taucs_datatype *supernodal_frontal_pool_get(supernodal_frontal_pool * pool, size_t len, size_t * cap)
+{
+	int i, best = -1;
+	taucs_datatype *p;
+
+	/*
+	 * best fit, but do not hand out buffers more than twice the size we need 
+	 */
+	if (pool) {
+		for (i = 0; i < pool->n; i++) {
+			if (pool->cap[i] >= len && pool->cap[i] <= 2 * len && (best < 0 || pool->cap[i] < pool->cap[best]))
+				best = i;
+		}
+	}
+	if (best < 0) {
+		*cap = len;
+		return (taucs_datatype *) taucs_calloc(len, sizeof(taucs_datatype));
+	}
+
+	p = pool->buf[best];
+	*cap = pool->cap[best];
+	pool->bytes -= pool->cap[best] * sizeof(taucs_datatype);
+	pool->n--;
+	pool->buf[best] = pool->buf[pool->n];
+	pool->cap[best] = pool->cap[pool->n];
+	memset(p, 0, len * sizeof(taucs_datatype));
+
+	return p;
+}
+
+static void supernodal_frontal_pool_put(supernodal_frontal_pool * pool, taucs_datatype * p, size_t cap)
+{
+	int i, largest;
+	size_t bytes = cap * sizeof(taucs_datatype);
+
+	if (!p)
+		return;
+	if (!pool || bytes > FRONTAL_POOL_BYTES) {
+		taucs_free(p);
+		return;
+	}
+
+	/*
+	 * make room by evicting the largest buffers first, as they are the ones that hold on to most memory 
+	 */
+	while (pool->n == FRONTAL_POOL_SIZE || pool->bytes + bytes > FRONTAL_POOL_BYTES) {
+		for (i = 1, largest = 0; i < pool->n; i++) {
+			if (pool->cap[i] > pool->cap[largest])
+				largest = i;
+		}
+		taucs_free(pool->buf[largest]);
+		pool->bytes -= pool->cap[largest] * sizeof(taucs_datatype);
+		pool->n--;
+		pool->buf[largest] = pool->buf[pool->n];
+		pool->cap[largest] = pool->cap[pool->n];
+	}
+	pool->buf[pool->n] = p;
+	pool->cap[pool->n] = cap;
+	pool->bytes += bytes;
+	pool->n++;
+}
+
+static void supernodal_frontal_pool_clear(supernodal_frontal_pool * pool)
+{
+	int i;
+
+	for (i = 0; i < pool->n; i++)
+		taucs_free(pool->buf[i]);
+	pool->n = 0;
+	pool->bytes = 0;
+}
+
+static supernodal_frontal_matrix *supernodal_frontal_create_pool(int *firstcol_in_supernode, int sn_size, int n, int *rowind,
+								 supernodal_frontal_pool * pool)
 {
 	supernodal_frontal_matrix *tmp;
 
@@ -987,6 +1085,7 @@ static supernodal_frontal_matrix *supernodal_frontal_create(int *firstcol_in_sup
 	 */
 
 	tmp->SFM_F1 = tmp->SFM_F2 = tmp->SFM_U = NULL;
+	tmp->u_cap = 0;
 
 	if (tmp->sn_size)
 		tmp->SFM_F1 = (taucs_datatype *) taucs_calloc((tmp->sn_size) * (tmp->sn_size), sizeof(taucs_datatype));
@@ -995,7 +1094,7 @@ static supernodal_frontal_matrix *supernodal_frontal_create(int *firstcol_in_sup
 		tmp->SFM_F2 = (taucs_datatype *) taucs_calloc((tmp->up_size) * (tmp->sn_size), sizeof(taucs_datatype));
 
 	if (tmp->up_size)
-		tmp->SFM_U = (taucs_datatype *) taucs_calloc((tmp->up_size) * (tmp->up_size), sizeof(taucs_datatype));
+		tmp->SFM_U = supernodal_frontal_pool_get(pool, (size_t) (tmp->up_size) * (tmp->up_size), &(tmp->u_cap));
 
 	if ((tmp->SFM_F1 == NULL && tmp->sn_size)
 	    || (tmp->SFM_F2 == NULL && tmp->sn_size && tmp->up_size)
@@ -1011,7 +1110,12 @@ static supernodal_frontal_matrix *supernodal_frontal_create(int *firstcol_in_sup
 	return tmp;
 }
 
-static void supernodal_frontal_free(supernodal_frontal_matrix * to_del)
+static supernodal_frontal_matrix *supernodal_frontal_create(int *firstcol_in_supernode, int sn_size, int n, int *rowind)
+{
+	return supernodal_frontal_create_pool(firstcol_in_supernode, sn_size, n, rowind, NULL);
+}
+
+static void supernodal_frontal_free_pool(supernodal_frontal_matrix * to_del, supernodal_frontal_pool * pool)
 {
 	/*
 	 * SFM_F1 and SFM_F2 are moved to the factor, but this function may be called before they are moved. 
@@ -1020,11 +1124,16 @@ static void supernodal_frontal_free(supernodal_frontal_matrix * to_del)
 	if (to_del) {
 		taucs_free(to_del->SFM_F1);
 		taucs_free(to_del->SFM_F2);
-		taucs_free(to_del->SFM_U);
+		supernodal_frontal_pool_put(pool, to_del->SFM_U, to_del->u_cap);
 		taucs_free(to_del);
 	}
 }
 
+static void supernodal_frontal_free(supernodal_frontal_matrix * to_del)
+{
+	supernodal_frontal_free_pool(to_del, NULL);
+}
+
 /*************************************************************/
 
 /* factor a frontal matrix                                   */
@@ -1941,6 +2050,210 @@ cilk static supernodal_frontal_matrix *recursive_multifrontal_supernodal_factor_
 	return my_matrix;
 }
 
+#ifdef TAUCS_OMP
+
+/*
+ * OpenMP version of the recursive multifrontal factorization.  The spawn points of the Cilk code become tasks, but only for
+ * subtrees of the supernodal elimination tree with enough work; smaller subtrees are factored serially by the thread that
+ * reaches them.  Each thread has its own bitmap and pool of update matrices.  The children of a node are extend-added in the
+ * same order as in the serial code, so the factor is identical.
+ */
+#define TAUCS_OMP_TASKS_PER_THREAD 8
+#define TAUCS_OMP_MIN_TASK_FLOPS   1.0e5
+
+static double supernodal_subtree_flops(int sn, int is_root, supernodal_factor_matrix * snL, double *subtree_flops)
+{
+	int child;
+	double flops = 0.0;
+
+	for (child = snL->first_child[sn]; child != -1; child = snL->next_child[child])
+		flops += supernodal_subtree_flops(child, FALSE, snL, subtree_flops);
+
+	if (!is_root) {
+		double s = (double) (snL->sn_size)[sn];
+		double u = (double) ((snL->sn_up_size)[sn] - (snL->sn_size)[sn]);
+
+		/*
+		 * potrf, trsm, herk and the extend-add into the parent 
+		 */
+		flops += s * s * s / 3.0 + u * s * s + u * u * s + u * u / 2.0;
+	}
+	subtree_flops[sn] = flops;
+
+	return flops;
+}
+
+static void extend_add_pool(supernodal_frontal_matrix * child_matrix,
+			    supernodal_frontal_matrix ** my_matrix_ptr,
+			    int is_root, int *v, int sn_size, int sn_up_size, int *rowind, int *bitmap, supernodal_frontal_pool * pool,
+			    int *fail)
+{
+	int failed;
+
+	/*
+	 * 'fail' is shared between the tasks 
+	 */
+#pragma omp atomic read
+	failed = *fail;
+	if (!failed && !is_root) {
+		if (!(*my_matrix_ptr)) {
+			*my_matrix_ptr = supernodal_frontal_create_pool(v, sn_size, sn_up_size, rowind, pool);
+			if (!(*my_matrix_ptr)) {
+#pragma omp atomic write
+				*fail = TRUE;
+			}
+		}
+		if (*my_matrix_ptr)
+			multifrontal_supernodal_front_extend_add(*my_matrix_ptr, child_matrix, bitmap);
+	}
+	supernodal_frontal_free_pool(child_matrix, pool);
+}
+
+static supernodal_frontal_matrix *recursive_multifrontal_supernodal_factor_llt_omp(int sn,	/* this supernode */
+										   int is_root,	/* is v the root? */
+										   int **bitmaps,
+										   supernodal_frontal_pool * pools,
+										   taucs_ccs_matrix * A,
+										   supernodal_factor_matrix * snL,
+										   double *subtree_flops, double cutoff, int *fail)
+{
+	supernodal_frontal_matrix *my_matrix = NULL, **child_matrix = NULL;
+	int child, k, nchild = 0, tid, failed;
+	int *v = NULL, sn_size = -1, sn_up_size = 0, *rowind = NULL;
+	int *first_child = snL->first_child;
+	int *next_child = snL->next_child;
+
+	if (!is_root) {
+		sn_size = snL->sn_size[sn];
+		sn_up_size = snL->sn_up_size[sn];
+		v = &(snL->sn_struct[sn][0]);
+		rowind = snL->sn_struct[sn];
+	}
+
+	if (is_root || subtree_flops[sn] >= cutoff) {
+		for (child = first_child[sn]; child != -1; child = next_child[child])
+			nchild++;
+		child_matrix = (supernodal_frontal_matrix **) taucs_calloc((nchild > 0 ? nchild : 1), sizeof(supernodal_frontal_matrix *));
+		if (!child_matrix) {
+#pragma omp atomic write
+			*fail = TRUE;
+			return NULL;
+		}
+		for (child = first_child[sn], k = 0; child != -1; child = next_child[child], k++) {
+			if (subtree_flops[child] >= cutoff) {
+#pragma omp task firstprivate(child, k)
+				child_matrix[k] =
+				    recursive_multifrontal_supernodal_factor_llt_omp(child, FALSE, bitmaps, pools, A, snL, subtree_flops, cutoff, fail);
+			} else {
+				child_matrix[k] =
+				    recursive_multifrontal_supernodal_factor_llt_omp(child, FALSE, bitmaps, pools, A, snL, subtree_flops, cutoff, fail);
+			}
+		}
+#pragma omp taskwait
+
+		tid = omp_get_thread_num();
+		for (k = 0; k < nchild; k++) {
+			extend_add_pool(child_matrix[k], &my_matrix, is_root, v, sn_size, sn_up_size, rowind, bitmaps[tid], &(pools[tid]), fail);
+		}
+		taucs_free(child_matrix);
+	} else {
+		tid = omp_get_thread_num();
+		for (child = first_child[sn]; child != -1; child = next_child[child]) {
+			supernodal_frontal_matrix *ret_matrix;
+
+			ret_matrix =
+			    recursive_multifrontal_supernodal_factor_llt_omp(child, FALSE, bitmaps, pools, A, snL, subtree_flops, cutoff, fail);
+			extend_add_pool(ret_matrix, &my_matrix, is_root, v, sn_size, sn_up_size, rowind, bitmaps[tid], &(pools[tid]), fail);
+#pragma omp atomic read
+			failed = *fail;
+			if (failed)
+				break;
+		}
+	}
+
+	tid = omp_get_thread_num();
+#pragma omp atomic read
+	failed = *fail;
+	if (failed) {
+		supernodal_frontal_free_pool(my_matrix, &(pools[tid]));
+		return NULL;
+	}
+
+	/*
+	 * in case we have no children, we allocate now 
+	 */
+	if (!is_root && !my_matrix) {
+		my_matrix = supernodal_frontal_create_pool(v, sn_size, sn_up_size, rowind, &(pools[tid]));
+		if (!my_matrix) {
+#pragma omp atomic write
+			*fail = TRUE;
+			return NULL;
+		}
+	}
+
+	if (!is_root) {
+		if (multifrontal_supernodal_front_factor(sn, v, sn_size, A, my_matrix, bitmaps[tid], snL)) {
+			/*
+			 * nonpositive pivot 
+			 */
+#pragma omp atomic write
+			*fail = TRUE;
+			supernodal_frontal_free_pool(my_matrix, &(pools[tid]));
+			return NULL;
+		}
+	}
+	return my_matrix;
+}
+
+static void recursive_multifrontal_supernodal_factor_llt_omp_caller(int n_sn, taucs_ccs_matrix * A, supernodal_factor_matrix * snL, int *fail)
+{
+	int i, nt = omp_get_max_threads();
+	int **bitmaps;
+	double *subtree_flops, cutoff;
+	supernodal_frontal_pool *pools;
+
+	subtree_flops = (double *) taucs_malloc((n_sn + 1) * sizeof(double));
+	pools = (supernodal_frontal_pool *) taucs_calloc(nt, sizeof(supernodal_frontal_pool));
+	bitmaps = (int **) taucs_calloc(nt, sizeof(int *));
+	if (!subtree_flops || !pools || !bitmaps) {
+		*fail = TRUE;
+	} else {
+		for (i = 0; i < nt; i++) {
+			bitmaps[i] = (int *) taucs_malloc((A->n + 1) * sizeof(int));
+			if (!bitmaps[i])
+				*fail = TRUE;
+		}
+	}
+
+	if (!(*fail)) {
+		supernodal_subtree_flops(n_sn, TRUE, snL, subtree_flops);
+		cutoff = subtree_flops[n_sn] / (TAUCS_OMP_TASKS_PER_THREAD * nt);
+		if (cutoff < TAUCS_OMP_MIN_TASK_FLOPS)
+			cutoff = TAUCS_OMP_MIN_TASK_FLOPS;
+
+#pragma omp parallel num_threads(nt)
+		{
+#pragma omp single
+			{
+				recursive_multifrontal_supernodal_factor_llt_omp(n_sn, TRUE, bitmaps, pools, A, snL, subtree_flops, cutoff, fail);
+			}
+		}
+	}
+
+	if (bitmaps) {
+		for (i = 0; i < nt; i++)
+			taucs_free(bitmaps[i]);
+	}
+	if (pools) {
+		for (i = 0; i < nt; i++)
+			supernodal_frontal_pool_clear(&(pools[i]));
+	}
+	taucs_free(bitmaps);
+	taucs_free(pools);
+	taucs_free(subtree_flops);
+}
+#endif							       /* TAUCS_OMP */
+
 cilk void *taucs_dtl(ccs_factor_llt_mf) (taucs_ccs_matrix * A) {
 	void *p;
 
@@ -1959,6 +2272,16 @@ cilk static void recursive_multifrontal_supernodal_factor_llt_caller(int n_sn,	/
 	int i, j;
 	supernodal_frontal_matrix *always_null;
 
+#ifdef TAUCS_OMP
+	/*
+	 * only if the parallel region would get more than one thread 
+	 */
+	if (omp_get_max_threads() > 1 && (!omp_in_parallel() || omp_get_active_level() < omp_get_max_active_levels())) {
+		recursive_multifrontal_supernodal_factor_llt_omp_caller(n_sn, A, snL, fail);
+		return;
+	}
+#endif
+
 	maps = (int **) taucs_malloc(Cilk_active_size * sizeof(int *));
 	if (!maps) {
 		taucs_supernodal_factor_free(snL);
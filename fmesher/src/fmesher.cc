@@ -8,6 +8,10 @@
 #include <string>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "fmesher.hh"
 
 #ifndef WHEREAMI
@@ -49,6 +53,7 @@ using fmesh::MeshC;
 using fmesh::Point;
 using fmesh::PointRaw;
 using fmesh::SparseMatrix;
+using fmesh::SparseMatrixCSR;
 using fmesh::Vector3;
 using fmesh::constrMetaT;
 using fmesh::constrT;
@@ -101,35 +106,159 @@ void print_SM_old(string filename,
 
 
 
+/*!
+  Position of (x,y) along a Hilbert curve on a (2^order)x(2^order) grid.
+ */
+static unsigned long long hilbert_index(unsigned int x,
+					unsigned int y,
+					int order)
+{
+  unsigned long long d = 0;
+  unsigned int n = 1U << order;
+  for (unsigned int s = n/2; s>0; s /= 2) {
+    unsigned int rx = (x & s) > 0;
+    unsigned int ry = (y & s) > 0;
+    d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+    if (ry == 0) { /* Rotate the quadrant. */
+      if (rx == 1) {
+	x = n-1 - x;
+	y = n-1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+
+/*!
+  Order the points along a Hilbert curve in the two coordinates with
+  the largest spread, so that consecutive points are close in space.
+ */
+static void hilbert_order(const Matrix<double>& points,
+			  std::vector<size_t>& order)
+{
+  const int hilbert_order_bits = 16;
+  size_t n = points.rows();
+  order.resize(n);
+  if (n == 0)
+    return;
+
+  double lo[3];
+  double hi[3];
+  for (int d=0; d<3; d++) {
+    lo[d] = hi[d] = points[0][d];
+  }
+  for (size_t i=1; i<n; i++) {
+    for (int d=0; d<3; d++) {
+      if (points[i][d] < lo[d]) lo[d] = points[i][d];
+      if (points[i][d] > hi[d]) hi[d] = points[i][d];
+    }
+  }
+  /* Pick the two dimensions with the largest extent. */
+  int dim[3] = {0, 1, 2};
+  for (int a=0; a<2; a++)
+    for (int b=a+1; b<3; b++)
+      if (hi[dim[b]]-lo[dim[b]] > hi[dim[a]]-lo[dim[a]])
+	std::swap(dim[a], dim[b]);
+
+  double scale[2];
+  for (int d=0; d<2; d++) {
+    double range = hi[dim[d]]-lo[dim[d]];
+    scale[d] = (range > 0.0 ?
+		((1U << hilbert_order_bits) - 1) / range :
+		0.0);
+  }
+
+  std::vector< std::pair<unsigned long long, size_t> > key(n);
+  for (size_t i=0; i<n; i++) {
+    unsigned int x = (unsigned int)((points[i][dim[0]]-lo[dim[0]])*scale[0]);
+    unsigned int y = (unsigned int)((points[i][dim[1]]-lo[dim[1]])*scale[1]);
+    key[i] = std::make_pair(hilbert_index(x, y, hilbert_order_bits), i);
+  }
+  std::sort(key.begin(), key.end());
+  for (size_t i=0; i<n; i++)
+    order[i] = key[i].second;
+}
+
+
+/*!
+  Batch point location.
+
+  The points are visited in Hilbert curve order, and each point is
+  located by walking from the triangle of the previous point.  When
+  the walk fails (non-convex domains, or points outside the mesh) the
+  TriangleLocator is used instead.  With OpenMP, the sorted sequence
+  is split into contiguous blocks, one per thread, each walking from
+  its own start dart.
+ */
 void map_points_to_mesh(const Mesh& M,
 			const Matrix<double>& points,
 			Matrix<int>& point2T,
 			Matrix<double>& point2bary)
 {
-  int t;
-  Point s;
-  Point b;
   int the_dimensions[] = {0,1};
   std::vector<int> dimensions(the_dimensions,
 			      the_dimensions +
 			      sizeof(the_dimensions) / sizeof(int) );
   TriangleLocator locator(&M, dimensions, true);
 
-  for (size_t i=0; i<points.rows(); i++) {
-    s[0] = points[i][0];
-    s[1] = points[i][1];
-    s[2] = points[i][2];
-    t = locator.locate(s);
-    if (t>=0) { /* Point located. */
-      M.barycentric(Dart(M,t),s,b); /* Coordinates relative to
-					   canonical vertex
-					   ordering. */
-      point2T(i,0) = t;
-      point2bary(i,0) = b[0];
-      point2bary(i,1) = b[1];
-      point2bary(i,2) = b[2];
-    } else { /* Point not found. */
-      point2T(i,0) = -1;
+  std::vector<size_t> order;
+  hilbert_order(points, order);
+  long n = (long)order.size();
+  if (n>0) { /* Make sure no thread needs to resize the output. */
+    point2T(n-1,0);
+    point2bary(n-1,2);
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    int thread = 0;
+    int nthreads = 1;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+    nthreads = omp_get_num_threads();
+#endif
+    long first = (n * thread) / nthreads;
+    long last = (n * (thread+1)) / nthreads;
+    Dart d0; /* Thread-local start of the walk. */
+    Dart d;
+    Point s;
+    Point b;
+    for (long k=first; k<last; k++) {
+      size_t i = order[k];
+      s[0] = points[i][0];
+      s[1] = points[i][1];
+      s[2] = points[i][2];
+      int t = -1;
+      if (!d0.isnull()) {
+	d = M.locate_point(d0,s);
+	if (!d.isnull()) {
+	  M.barycentric(Dart(M,d.t()),s,b);
+	  if ((b[0] >= -10.0*MESH_EPSILON) &&
+	      (b[1] >= -10.0*MESH_EPSILON) &&
+	      (b[2] >= -10.0*MESH_EPSILON))
+	    t = d.t();
+	}
+      }
+      if (t<0) {
+	t = locator.locate(s);
+	if (t>=0)
+	  M.barycentric(Dart(M,t),s,b);
+      }
+      if (t>=0) { /* Point located. */
+	/* Coordinates relative to canonical vertex ordering. */
+	point2T(i,0) = t;
+	point2bary(i,0) = b[0];
+	point2bary(i,1) = b[1];
+	point2bary(i,2) = b[2];
+
+	d0 = Dart(M,t); /* Bet on the next point being close. */
+      } else { /* Point not found. */
+	point2T(i,0) = -1;
+      }
     }
   }
 }
@@ -140,15 +269,18 @@ void map_points_to_mesh_convex(const Mesh& M,
 			       Matrix<int>& point2T,
 			       Matrix<double>& point2bary)
 {
+  std::vector<size_t> order;
+  hilbert_order(points, order);
   Dart d0(M);
   Dart d;
   Point s;
   Point b;
-  for (size_t i=0; i<points.rows(); i++) {
+  for (size_t k=0; k<order.size(); k++) {
+    size_t i = order[k];
     s[0] = points[i][0];
     s[1] = points[i][1];
     s[2] = points[i][2];
-    d = M.locate_point(Dart(M),s);
+    d = M.locate_point(d0,s);
     if (!d.isnull()) { /* Point located. */
       M.barycentric(Dart(M,d.t()),s,b); /* Coordinates relative to
 					   canonical vertex
@@ -1326,11 +1458,10 @@ int main(int argc, char* argv[])
   int fem_order_max = args_info.fem_arg;
   if (fem_order_max>=0) {
     LOG("fem output." << std::endl)
-    SparseMatrix<double>& C0 = matrices.SD("c0").clear();
-    SparseMatrix<double>& C1 = matrices.SD("c1").clear();
-    SparseMatrix<double>& B1 = matrices.SD("b1").clear();
-    SparseMatrix<double>& G  = matrices.SD("g1").clear();
-    SparseMatrix<double>& K  = matrices.SD("k1").clear();
+    SparseMatrixCSR<double> C0;
+    SparseMatrixCSR<double> C1;
+    SparseMatrixCSR<double> B1;
+    SparseMatrixCSR<double> G;
     /* K1=G1-B1, K2=K1*inv(C0)*K1, ... */
     Matrix<double>& Tareas  = matrices.DD("ta").clear();
     
@@ -1338,7 +1469,13 @@ int main(int argc, char* argv[])
 
     matrices.attach(string("va"),new Matrix<double>(diag(C0)),true);
     
-    K = G-B1;
+    SparseMatrixCSR<double> K = G-B1;
+
+    matrices.SDcsr("c0") = C0;
+    matrices.SDcsr("c1") = C1;
+    matrices.SDcsr("b1") = B1;
+    matrices.SDcsr("g1") = G;
+    matrices.SDcsr("k1") = K;
     
     matrices.matrixtype("c0",fmesh::IOMatrixtype_diagonal);
     matrices.matrixtype("c1",fmesh::IOMatrixtype_symmetric);
@@ -1353,50 +1490,51 @@ int main(int argc, char* argv[])
     matrices.output("va");
     matrices.output("ta");
     
-    SparseMatrix<double> C0inv = inverse(C0,true);
-    SparseMatrix<double> tmp = G*C0inv;
-    SparseMatrix<double>* a;
-    SparseMatrix<double>* b = &G;
+    SparseMatrixCSR<double> C0inv = inverse(C0,true);
+    SparseMatrixCSR<double> tmp = G*C0inv;
+    SparseMatrixCSR<double> a;
+    SparseMatrixCSR<double> b = G;
     for (size_t i=1; int(i) < fem_order_max; i++) {
       std::stringstream ss;
       ss << i+1;
       std::string Gname = "g"+ss.str();
       a = b;
-      b = &(matrices.SD(Gname).clear());
-      *b = tmp*(*a);
+      b = tmp*a;
+      matrices.SDcsr(Gname) = b;
       matrices.matrixtype(Gname,fmesh::IOMatrixtype_symmetric);
       matrices.output(Gname);
     }
     tmp = C0inv*K;
-    b = &K;
+    b = K;
     for (size_t i=1; int(i) < fem_order_max; i++) {
       std::stringstream ss;
       ss << i+1;
       std::string Kname = "k"+ss.str();
       a = b;
-      b = &(matrices.SD(Kname).clear());
-      *b = (*a)*tmp;
+      b = a*tmp;
+      matrices.SDcsr(Kname) = b;
       matrices.matrixtype(Kname,fmesh::IOMatrixtype_general);
       matrices.output(Kname);
     }
 
     if (aniso_names.size()>0) {
-      SparseMatrix<double>& Gani  = matrices.SD("g1aniso").clear();
+      SparseMatrixCSR<double> Gani;
       M.calcQblocksAni(Gani,
 		       matrices.DD(aniso_names[0]),
 		       matrices.DD(aniso_names[1]));
+      matrices.SDcsr("g1aniso") = Gani;
       matrices.output("g1aniso");
 
-      SparseMatrix<double> tmp = Gani*C0inv;
-      SparseMatrix<double>* a;
-      SparseMatrix<double>* b = &Gani;
+      SparseMatrixCSR<double> tmp = Gani*C0inv;
+      SparseMatrixCSR<double> a;
+      SparseMatrixCSR<double> b = Gani;
       for (size_t i=1; int(i) < fem_order_max; i++) {
 	std::stringstream ss;
 	ss << i+1;
 	std::string Gname = "g"+ss.str()+"aniso";
 	a = b;
-	b = &(matrices.SD(Gname).clear());
-	*b = tmp*(*a);
+	b = tmp*a;
+	matrices.SDcsr(Gname) = b;
 	matrices.matrixtype(Gname,fmesh::IOMatrixtype_symmetric);
 	matrices.output(Gname);
       }
@@ -31,6 +31,8 @@ using fmesh::Int3;
 using fmesh::Mesh;
 using fmesh::Dart;
 using fmesh::MeshC;
+using fmesh::SparseMatrix;
+using fmesh::SparseMatrixCSR;
 
 const bool useVT = true;
 const bool useTTi = true;
@@ -775,6 +777,80 @@ int iohelper_test()
   return 0;
 }
 
+bool fem_csr_equal(const SparseMatrixCSR<double>& A,
+		   const SparseMatrix<double>& B)
+{
+  if ((A.rows() != B.rows()) || (A.cols() != B.cols()))
+    return false;
+  for (size_t r=0; r<A.rows(); r++)
+    for (size_t c=0; c<A.cols(); c++)
+      if (std::fabs(A(r,c)-B(r,c)) > 1e-12*(1.0+std::fabs(B(r,c))))
+	return false;
+  return true;
+}
+
+int fem_csr_test()
+{
+  PointRaw S[5] =
+    {{0.,0.,0.},
+     {1.,0.,0.},
+     {0.,1.,0.},
+     {1.,1.,0.},
+     {0.4,0.6,0.}};
+  Int3Raw TV[4] =
+    {{0,1,4},
+     {1,3,4},
+     {3,2,4},
+     {2,0,4}};
+
+  Mesh M(Mesh::Mtype_plane,0,useVT,useTTi);
+  M.S_set(Matrix3double(5,S));
+  M.TV_set(Matrix3int(4,TV));
+
+  SparseMatrixCSR<double> C0;
+  SparseMatrixCSR<double> C1;
+  SparseMatrixCSR<double> G;
+  SparseMatrixCSR<double> B1;
+  Matrix<double> Tareas;
+  M.calcQblocks(C0,C1,G,B1,Tareas);
+
+  SparseMatrix<double> C0s;
+  SparseMatrix<double> Gs;
+  SparseMatrix<double> B1s;
+  C0s = C0;
+  Gs = G;
+  B1s = B1;
+
+  int failed = 0;
+  SparseMatrixCSR<double> K = G-B1;
+  SparseMatrix<double> Ks = Gs-B1s;
+  if (!fem_csr_equal(K,Ks)) {
+    cout << "fem_csr_test: G-B1 differs" << endl;
+    failed++;
+  }
+
+  SparseMatrixCSR<double> C0inv = inverse(C0,true);
+  SparseMatrix<double> C0invs = inverse(C0s,true);
+  if (!fem_csr_equal((G*C0inv)*G,(Gs*C0invs)*Gs)) {
+    cout << "fem_csr_test: G*inv(C0)*G differs" << endl;
+    failed++;
+  }
+  if (!fem_csr_equal(K*(C0inv*K),Ks*(C0invs*Ks))) {
+    cout << "fem_csr_test: K*inv(C0)*K differs" << endl;
+    failed++;
+  }
+
+  /* CSR storage in a matrix collection, converted on demand. */
+  fmesh::MatrixC matrices;
+  matrices.SDcsr("g1") = G;
+  if (!fem_csr_equal(G,matrices.SD("g1"))) {
+    cout << "fem_csr_test: MatrixC CSR slot differs" << endl;
+    failed++;
+  }
+
+  return failed;
+}
+
 void make_globe_test()
 {
   fmesh::Mesh M;
@@ -803,6 +879,8 @@ int main()
     DT2D_test3();
     DTsphere_test();
   }
+  if (fem_csr_test() > 0)
+    return 1;
 
   return 0;
 }
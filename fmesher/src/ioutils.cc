@@ -194,7 +194,10 @@ namespace fmesh {
 	  ioh.binary(bin_).OH(output).OD(output);
 	} else {
 	  IOHelperSM<double> ioh;
-	  ioh.cD(&mcc.SD()).matrixtype(mcc.info.matrixtype);
+	  if (mcc.csr())
+	    ioh.cD(&mcc.SDcsr()).matrixtype(mcc.info.matrixtype);
+	  else
+	    ioh.cD(&mcc.SD()).matrixtype(mcc.info.matrixtype);
 	  ioh.binary(bin_).OH(output).OD(output);
 	}
     }
@@ -309,6 +312,19 @@ namespace fmesh {
     return coll_[name]->SD();
   }
 
+  SparseMatrixCSR<double>& MatrixC::attach(std::string name,
+					   SparseMatrixCSR<double>* M,
+					   bool transfer_ownership,
+					   IOMatrixtype matrixt)
+  {
+    free(name);
+    coll_.insert(collPairT(name,
+			   new MCC(matrixt,
+				   M,transfer_ownership)));
+    activate(name);
+    return coll_[name]->SDcsr();
+  }
+
   
   bool MatrixC::activate(std::string name)
   {
@@ -560,6 +576,8 @@ namespace fmesh {
 	else
 	  if (mcc.info.valuetype == IOValuetype_int)
 	    save_SM((output_prefix_+(*outi)),mcc.SI(),mcc.info,bin_out_);
+	  else if (mcc.csr())
+	    save_SM((output_prefix_+(*outi)),mcc.SDcsr(),mcc.info,bin_out_);
 	  else
 	    save_SM((output_prefix_+(*outi)),mcc.SD(),mcc.info,bin_out_);
       }
@@ -638,6 +656,19 @@ namespace fmesh {
     return attach(name,new SparseMatrix<double>());
   }
 
+  SparseMatrixCSR<double>& MatrixC::SDcsr(std::string name)
+  {
+    collT::iterator colli;
+    if (((colli = coll_.find(name)) != coll_.end()) &&
+	(colli->second->info.datatype == IODatatype_sparse) &&
+	(colli->second->info.valuetype == IOValuetype_double) &&
+	(colli->second->info.active) &&
+	(colli->second->csr())) {
+      return colli->second->SDcsr();
+    }
+    return attach(name,new SparseMatrixCSR<double>());
+  }
+
 
   
   void MatrixC::matrixtype(std::string name, IOMatrixtype matrixt)
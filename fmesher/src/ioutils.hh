@@ -73,6 +73,9 @@ namespace fmesh {
     template <class T>
     IOHeader& sparse(const SparseMatrix<T>& M,
 		     IOMatrixtype matrixt = IOMatrixtype_general);
+    template <class T>
+    IOHeader& sparse(const SparseMatrixCSR<T>& M,
+		     IOMatrixtype matrixt = IOMatrixtype_general);
     IOHeader& collection(const MatrixC& C);
     
     /* Constructor, that sets the valuetype matching T: */
@@ -203,13 +206,23 @@ namespace fmesh {
   public:
     const SparseMatrix<T> *cM_;
     SparseMatrix<T> *M_;
+    const SparseMatrixCSR<T> *cMcsr_; /*! Output only */
   public:
     /* Constructors: */
-    IOHelperSM() : IOHelper<T>() {};
-    IOHelperSM(const IOHeader& h) : IOHelper<T>(h) {};
+    IOHelperSM() : IOHelper<T>(), cMcsr_(NULL) {};
+    IOHelperSM(const IOHeader& h) : IOHelper<T>(h), cMcsr_(NULL) {};
     IOHelperSM<T>& cD(const SparseMatrix<T>* M) {
       cM_ = M;
       M_ = NULL;
+      cMcsr_ = NULL;
+      IOHelper<T>::h_.sparse(*M);
+      IOHelper<T>::colmajor();
+      return *this;
+    };
+    IOHelperSM<T>& cD(const SparseMatrixCSR<T>* M) {
+      cM_ = NULL;
+      M_ = NULL;
+      cMcsr_ = M;
       IOHelper<T>::h_.sparse(*M);
       IOHelper<T>::colmajor();
       return *this;
@@ -218,13 +231,17 @@ namespace fmesh {
     {
       cM_ = M;
       M_ = M;
+      cMcsr_ = NULL;
       IOHelper<T>::h_.sparse(*M);
       IOHelper<T>::colmajor();
       return *this;
     };
 
     IOHelperSM<T>& matrixtype(IOMatrixtype matrixt) {
-      IOHelper<T>::h_.sparse(*cM_,matrixt);
+      if (cMcsr_)
+	IOHelper<T>::h_.sparse(*cMcsr_,matrixt);
+      else
+	IOHelper<T>::h_.sparse(*cM_,matrixt);
       return *this;
     };
 
@@ -340,16 +357,17 @@ namespace fmesh {
     Matrix<double>* DD_;
     SparseMatrix<int>* SI_;
     SparseMatrix<double>* SD_;
+    SparseMatrixCSR<double>* SDcsr_; /*! Alternative storage for SD */
   public:
 
     MCC() : info(false,false,
 		 IODatatype_dense,IOValuetype_int,IOMatrixtype_general,
 		 false),
-	    DI_(NULL), DD_(NULL), SI_(NULL), SD_(NULL) {};
+	    DI_(NULL), DD_(NULL), SI_(NULL), SD_(NULL), SDcsr_(NULL) {};
     MCC(IODatatype data, IOValuetype value, IOMatrixtype matrixt,
 	void* M = NULL, bool isowner = true)
       : info(true,false,data,value,matrixt,isowner),
-	DI_(NULL), DD_(NULL), SI_(NULL), SD_(NULL) {
+	DI_(NULL), DD_(NULL), SI_(NULL), SD_(NULL), SDcsr_(NULL) {
       if (M) {
 	if (info.datatype==IODatatype_dense)
 	  if (info.valuetype==IOValuetype_int)
@@ -375,23 +393,48 @@ namespace fmesh {
 	    SD_ = new SparseMatrix<double>();
       }
     };
+    MCC(IOMatrixtype matrixt, SparseMatrixCSR<double>* M,
+	bool isowner = true)
+      : info(true,false,IODatatype_sparse,IOValuetype_double,matrixt,isowner),
+	DI_(NULL), DD_(NULL), SI_(NULL), SD_(NULL), SDcsr_(M) {
+      if (!M) {
+	info.owner = true;
+	SDcsr_ = new SparseMatrixCSR<double>();
+      }
+    };
     ~MCC() {
       if (info.owner) {
 	if (DI_) delete DI_;
 	if (DD_) delete DD_;
 	if (SI_) delete SI_;
 	if (SD_) delete SD_;
+	if (SDcsr_) delete SDcsr_;
       }
     };
 
+    /*! True if the sparse double matrix is held in CSR storage. */
+    bool csr() const { return (SDcsr_ != NULL); };
+
     Matrix<int>& DI() { return *DI_; };
     Matrix<double>& DD() { return *DD_; };
     SparseMatrix<int>& SI() { return *SI_; };
-    SparseMatrix<double>& SD() { return *SD_; };
+    SparseMatrix<double>& SD() {
+      /* Convert CSR storage on demand, since the caller may modify it. */
+      if (SDcsr_) {
+	SD_ = new SparseMatrix<double>();
+	*SD_ = *SDcsr_;
+	if (info.owner) delete SDcsr_;
+	SDcsr_ = NULL;
+	info.owner = true;
+      }
+      return *SD_;
+    };
+    SparseMatrixCSR<double>& SDcsr() { return *SDcsr_; };
     const Matrix<int>& DI() const { return *DI_; };
     const Matrix<double>& DD() const { return *DD_; };
     const SparseMatrix<int>& SI() const { return *SI_; };
     const SparseMatrix<double>& SD() const { return *SD_; };
+    const SparseMatrixCSR<double>& SDcsr() const { return *SDcsr_; };
   };
 
   class MatrixC {
@@ -460,6 +503,10 @@ namespace fmesh {
 			    SparseMatrix<T>* M,
 			    bool transfer_ownership = true,
 			    IOMatrixtype matrixt = IOMatrixtype_general);
+    SparseMatrixCSR<double>& attach(std::string name,
+				    SparseMatrixCSR<double>* M,
+				    bool transfer_ownership = true,
+				    IOMatrixtype matrixt = IOMatrixtype_general);
 
     MatrixC& free(std::string name);
 
@@ -467,6 +514,7 @@ namespace fmesh {
     Matrix<double>& DD(std::string name);
     SparseMatrix<int>& SI(std::string name);
     SparseMatrix<double>& SD(std::string name);
+    SparseMatrixCSR<double>& SDcsr(std::string name);
 
     void matrixtype(std::string name, IOMatrixtype matrixt);
 
@@ -102,6 +102,40 @@ namespace fmesh {
     return *this;
   }
 
+  template <class T>
+  IOHeader& IOHeader::sparse(const SparseMatrixCSR<T>& M,
+			     IOMatrixtype matrixt)
+  {
+    datatype = IODatatype_sparse;
+    matrixtype = matrixt;
+    elems = M.nnz(matrixt);
+    switch (matrixt) {
+    case IOMatrixtype_general:
+      rows = M.rows();
+      cols = M.cols();
+      break;
+    case IOMatrixtype_symmetric:
+      if (M.rows() <= M.cols()) {
+	rows = M.cols();
+	cols = M.cols();
+      } else {
+	rows = M.rows();
+	cols = M.rows();
+      }
+      break;
+    case IOMatrixtype_diagonal:
+      if (M.rows() <= M.cols()) {
+	rows = M.rows();
+	cols = M.rows();
+      } else {
+	rows = M.cols();
+	cols = M.cols();
+      }
+      break;
+    }
+    return *this;
+  }
+
 
 
 
@@ -355,19 +389,25 @@ namespace fmesh {
   {
     const IOHeader& h(IOHelper<T>::h_);
     const bool& bin_(IOHelper<T>::binary_);
-    if (!cM_) {
+    if (!(cM_ || cMcsr_)) {
       return *this;
     }
     if (h.storagetype == IOStoragetype_rowmajor) {
       Matrix1< SparseMatrixTriplet<T> > MT;
-      (*cM_).tolist(MT,h.matrixtype);
+      if (cMcsr_)
+	(*cMcsr_).tolist(MT,h.matrixtype);
+      else
+	(*cM_).tolist(MT,h.matrixtype);
       IOHelperM< SparseMatrixTriplet<T>
 		 >().cD(&MT).binary(bin_).rowmajor().OD(output);
     } else {
       Matrix1int Mr;
       Matrix1int Mc;
       Matrix1<T> Mv;
-      (*cM_).tolist(Mr,Mc,Mv,h.matrixtype);
+      if (cMcsr_)
+	(*cMcsr_).tolist(Mr,Mc,Mv,h.matrixtype);
+      else
+	(*cM_).tolist(Mr,Mc,Mv,h.matrixtype);
       IOHelperM<int>().cD(&Mr).binary(bin_).colmajor().OD(output);
       IOHelperM<int>().cD(&Mc).binary(bin_).colmajor().OD(output);
       IOHelperM<T>().cD(&Mv).binary(bin_).colmajor().OD(output);
@@ -516,6 +556,21 @@ namespace fmesh {
     ioh.binary(binary).OH(O).OD(O);
     O.close();
   }
+
+  template <class T>
+  void save_SM(std::string filename,
+	       const SparseMatrixCSR<T>& M,
+	       MCCInfo mccinfo,
+	       bool binary)
+  {
+    std::ofstream O;
+    O.open(filename.c_str(),
+	   (binary ? (std::ios::out | std::ios::binary) : std::ios::out));
+    IOHelperSM<T> ioh;
+    ioh.cD(&M).matrixtype(mccinfo.matrixtype);
+    ioh.binary(binary).OH(O).OD(O);
+    O.close();
+  }
   
   
   
@@ -2445,16 +2445,19 @@ namespace fmesh {
 
 
 
-  void Mesh::calcQblocks(SparseMatrix<double>& C0,
-			 SparseMatrix<double>& C1,
-			 SparseMatrix<double>& G1,
-			 SparseMatrix<double>& B1,
+  void Mesh::calcQblocks(SparseMatrixCSR<double>& C0,
+			 SparseMatrixCSR<double>& C1,
+			 SparseMatrixCSR<double>& G1,
+			 SparseMatrixCSR<double>& B1,
 			 Matrix<double>& Tareas) const
   {
-    C0.clear().rows(nV()).cols(nV());
-    C1.clear().rows(nV()).cols(nV());
-    G1.clear().rows(nV()).cols(nV());
-    B1.clear().rows(nV()).cols(nV());
+    SparseMatrixBuilder<double> C0b(nV(),nV());
+    SparseMatrixBuilder<double> C1b(nV(),nV());
+    SparseMatrixBuilder<double> G1b(nV(),nV());
+    SparseMatrixBuilder<double> B1b(nV(),nV());
+    C0b.reserve(3*nT());
+    C1b.reserve(9*nT());
+    G1b.reserve(9*nT());
     Tareas.clear().cols(1).rows(nT());
     Point e[3];
     for (int t = 0; t < (int)nT(); t++) {
@@ -2488,15 +2491,15 @@ namespace fmesh {
 
       double vij;
       for (int i=0; i<3; i++) {
-	C0(tv[i],tv[i]) += a/3.;
-	C1(tv[i],tv[i]) += a/6.;
-	G1(tv[i],tv[i]) += eij[i][i]/(4.*fa);
+	C0b.add(tv[i],tv[i],a/3.);
+	C1b.add(tv[i],tv[i],a/6.);
+	G1b.add(tv[i],tv[i],eij[i][i]/(4.*fa));
 	for (int j=i+1; j<3; j++) {
-	  C1(tv[i],tv[j]) += a/12.;
-	  C1(tv[j],tv[i]) += a/12.;
+	  C1b.add(tv[i],tv[j],a/12.);
+	  C1b.add(tv[j],tv[i],a/12.);
 	  vij = eij[i][j]/(4.*fa);
-	  G1(tv[i],tv[j]) += vij;
-	  G1(tv[j],tv[i]) += vij;
+	  G1b.add(tv[i],tv[j],vij);
+	  G1b.add(tv[j],tv[i],vij);
 	}
       }
 
@@ -2506,13 +2509,18 @@ namespace fmesh {
 	  for (int j=0; j<3; j++) {
 	    for (int k=0; k<3; k++) {
 	      if (b[k] && (i != k)) {
-		B1(tv[i],tv[j]) += eij[k][j]*vij;
+		B1b.add(tv[i],tv[j],eij[k][j]*vij);
 	      }
 	    }
 	  }
 	}
       }
     }
+
+    C0b.compress(C0);
+    C1b.compress(C1);
+    G1b.compress(G1);
+    B1b.compress(B1);
   }
   
 
@@ -2546,11 +2554,12 @@ namespace fmesh {
   }
 
 
-  void Mesh::calcQblocksAni(SparseMatrix<double>& G1,
+  void Mesh::calcQblocksAni(SparseMatrixCSR<double>& G1,
 			    const Matrix<double>& gamma,
 			    const Matrix<double>& vec) const
   {
-    G1.clear().rows(nV()).cols(nV());
+    SparseMatrixBuilder<double> G1b(nV(),nV());
+    G1b.reserve(9*nT());
     Matrix<double> Tareas;
     Tareas.clear().cols(1).rows(nT());
     Matrix3double vec_(vec);
@@ -2641,15 +2650,17 @@ namespace fmesh {
 
       double vij;
       for (int i=0; i<3; i++) {
-	G1(tv[i],tv[i]) += eij[i][i]/(4.*fa);
+	G1b.add(tv[i],tv[i],eij[i][i]/(4.*fa));
 	for (int j=i+1; j<3; j++) {
 	  vij = eij[i][j]/(4.*fa);
-	  G1(tv[i],tv[j]) += vij;
-	  G1(tv[j],tv[i]) += vij;
+	  G1b.add(tv[i],tv[j],vij);
+	  G1b.add(tv[j],tv[i],vij);
 	}
       }
 
     }
+
+    G1b.compress(G1);
   }
   
 
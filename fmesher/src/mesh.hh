@@ -253,12 +253,12 @@ namespace fmesh {
     /*!
       \brief Calculate FEM matrices.
      */
-    void calcQblocks(SparseMatrix<double>& C0,
-		     SparseMatrix<double>& C1,
-		     SparseMatrix<double>& G1,
-		     SparseMatrix<double>& B1,
+    void calcQblocks(SparseMatrixCSR<double>& C0,
+		     SparseMatrixCSR<double>& C1,
+		     SparseMatrixCSR<double>& G1,
+		     SparseMatrixCSR<double>& B1,
 		     Matrix<double>& Tareas) const;
-    void calcQblocksAni(SparseMatrix<double>& G1,
+    void calcQblocksAni(SparseMatrixCSR<double>& G1,
 			const Matrix<double>& gamma,
 			const Matrix<double>& vec) const;
     void calcGradientMatrices(SparseMatrix<double>** D) const;
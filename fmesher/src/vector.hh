@@ -50,6 +50,8 @@ namespace fmesh {
   template <class T> class Matrix3;
   template <class T> class SparseMatrixRow;
   template <class T> class SparseMatrix;
+  template <class T> class SparseMatrixCSR;
+  template <class T> class SparseMatrixBuilder;
 
   template <class T>
   Matrix<T> operator*(const SparseMatrix<T>& M1,
@@ -69,6 +71,18 @@ namespace fmesh {
   template <class T>
   Matrix<T> diag(const SparseMatrix<T>& M1);
 
+  template <class T>
+  SparseMatrixCSR<T> operator*(const SparseMatrixCSR<T>& M1,
+			       const SparseMatrixCSR<T>& M2);
+  template <class T>
+  SparseMatrixCSR<T> operator-(const SparseMatrixCSR<T>& M1,
+			       const SparseMatrixCSR<T>& M2);
+  template <class T>
+  SparseMatrixCSR<T> inverse(const SparseMatrixCSR<T>& M1,
+			     bool diagonal = false);
+  template <class T>
+  Matrix<T> diag(const SparseMatrixCSR<T>& M1);
+
 
 
   template<class T>
@@ -614,6 +628,8 @@ namespace fmesh {
       //      std::cout << "SM assignment" << std::endl;
       return *this;
     };
+    /*! Copy from compressed row storage. */
+    const SparseMatrix<T>& operator=(const SparseMatrixCSR<T>& from);
     SparseMatrix<T>& clear() {
       data_.clear();
       return *this;
@@ -781,6 +797,114 @@ namespace fmesh {
   };
 
 
+
+  /*!
+    \brief Sparse matrix in compressed sparse row storage.
+
+    Immutable sparsity pattern; build with SparseMatrixBuilder, or
+    convert from a SparseMatrix.  Columns are sorted within each row.
+   */
+  template <class T>
+  class SparseMatrixCSR {
+    friend class SparseMatrixBuilder<T>;
+  private:
+    static const T zero_;
+    size_t rows_;
+    size_t cols_;
+    std::vector<size_t> rowptr_; /*! rows_+1 offsets into col_ and val_ */
+    std::vector<int> col_;
+    std::vector<T> val_;
+  public:
+    SparseMatrixCSR(size_t set_rows = 0, size_t set_cols = 0)
+      : rows_(set_rows), cols_(set_cols),
+	rowptr_(set_rows+1, 0), col_(), val_() {};
+    SparseMatrixCSR(const SparseMatrix<T>& from);
+
+    SparseMatrixCSR<T>& clear() {
+      rows_ = 0;
+      cols_ = 0;
+      rowptr_.assign(1, 0);
+      col_.clear();
+      val_.clear();
+      return *this;
+    };
+
+    size_t rows(void) const { return rows_; };
+    size_t cols(void) const { return cols_; };
+
+    size_t nnz(int matrixt = 0) const;
+
+    /*! Row r occupies [rowbegin(r), rowend(r)) in col() and val(). */
+    size_t rowbegin(const size_t r) const { return rowptr_[r]; };
+    size_t rowend(const size_t r) const { return rowptr_[r+1]; };
+    int col(const size_t k) const { return col_[k]; };
+    const T& val(const size_t k) const { return val_[k]; };
+
+    /*! Element access, by binary search within the row. */
+    const T& operator()(const size_t r,  const size_t c) const;
+
+    /* Linear algebra */
+    friend
+    SparseMatrixCSR<T> operator*<T>(const SparseMatrixCSR<T>& M1,
+				    const SparseMatrixCSR<T>& M2);
+    friend
+    SparseMatrixCSR<T> operator-<T>(const SparseMatrixCSR<T>& M1,
+				    const SparseMatrixCSR<T>& M2);
+    friend
+    SparseMatrixCSR<T> inverse<T>(const SparseMatrixCSR<T>& M1,
+				  bool diagonal);
+
+    /*! To list, general, symmetric, or diagonal. */
+    int tolist(Matrix1< SparseMatrixTriplet<T> >& MT,
+	       int matrixt = 0) const;
+    /*! To list, general, symmetric, or diagonal. */
+    int tolist(Matrix1< int >& Tr,
+	       Matrix1< int >& Tc,
+	       Matrix1< T >& Tv,
+	       int matrixt = 0) const;
+
+    /*! \brief Store the matrix in a file. */
+    bool save(std::string filename,
+	      IOMatrixtype matrixt = IOMatrixtype_general,
+	      bool binary = true) const;
+  };
+
+
+  /*!
+    \brief Triplet front end for SparseMatrixCSR.
+
+    Elements are appended in any order, and duplicates are summed when
+    the matrix is compressed: a counting sort by row, then a sort by
+    column and reduce-by-key within each row.
+   */
+  template <class T>
+  class SparseMatrixBuilder {
+  private:
+    size_t rows_;
+    size_t cols_;
+    std::vector< SparseMatrixTriplet<T> > triplets_;
+    static bool col_less(const std::pair<int, T>& a,
+			 const std::pair<int, T>& b) {
+      return a.first < b.first;
+    };
+  public:
+    SparseMatrixBuilder(size_t set_rows = 0, size_t set_cols = 0)
+      : rows_(set_rows), cols_(set_cols), triplets_() {};
+
+    void reserve(size_t n) { triplets_.reserve(n); };
+    size_t size() const { return triplets_.size(); };
+
+    void add(int r, int c, const T& value) {
+      if (!((size_t)r < rows_)) rows_ = r+1;
+      if (!((size_t)c < cols_)) cols_ = c+1;
+      triplets_.push_back(SparseMatrixTriplet<T>(r, c, value));
+    };
+
+    /*! Build M, and release the triplet storage. */
+    SparseMatrixCSR<T>& compress(SparseMatrixCSR<T>& M);
+  };
+
+
   struct Vec {  
     static void copy(Point& s, const Point& s0)
     { s.copy(s0); };
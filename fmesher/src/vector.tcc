@@ -1,6 +1,7 @@
 #ifndef _FMESH_VECTOR_T_
 #define _FMESH_VECTOR_T_ 1
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include "vector.hh"
@@ -349,12 +350,300 @@ namespace fmesh {
 
 
 
+  template <class T>
+  const SparseMatrix<T>& SparseMatrix<T>::operator=(const SparseMatrixCSR<T>& from)
+  {
+    data_.clear();
+    cols_ = from.cols();
+    rows(from.rows());
+    for (size_t r=0; r<from.rows(); r++) {
+      typename RowType::DataType& row = data_[r].data_;
+      /* Columns are sorted, so each insertion is amortised constant time. */
+      for (size_t k=from.rowbegin(r); k<from.rowend(r); k++)
+	row.insert(row.end(),
+		   typename RowType::DataType::value_type(from.col(k),
+							  from.val(k)));
+    }
+    return *this;
+  }
+
+
+
+
+  template <class T>
+  SparseMatrixCSR<T>::SparseMatrixCSR(const SparseMatrix<T>& from)
+    : rows_(from.rows()), cols_(from.cols()),
+      rowptr_(from.rows()+1, 0), col_(), val_()
+  {
+    col_.reserve(from.nnz());
+    val_.reserve(from.nnz());
+    for (size_t r=0; r<rows_; r++) {
+      const SparseMatrixRow<T>& row = from[r];
+      for (typename SparseMatrixRow<T>::ColCIter c = row.begin();
+	   c != row.end();
+	   c++) {
+	col_.push_back(c->first);
+	val_.push_back(c->second);
+      }
+      rowptr_[r+1] = col_.size();
+    }
+  }
+
+  template <class T>
+  size_t SparseMatrixCSR<T>::nnz(int matrixt) const
+  {
+    if (matrixt == 0)
+      return col_.size();
+    size_t nnz_ = 0;
+    for (size_t r=0; r<rows_; r++)
+      for (size_t k=rowptr_[r]; k<rowptr_[r+1]; k++)
+	if ((matrixt == 1) ? ((int)r <= col_[k]) : ((int)r == col_[k]))
+	  nnz_++;
+    return nnz_;
+  }
+
+  template <class T>
+  const T& SparseMatrixCSR<T>::operator()(const size_t r,
+					  const size_t c) const
+  {
+    if (!(r < rows_))
+      return zero_;
+    typename std::vector<int>::const_iterator first = col_.begin()+rowptr_[r];
+    typename std::vector<int>::const_iterator last = col_.begin()+rowptr_[r+1];
+    typename std::vector<int>::const_iterator k =
+      std::lower_bound(first, last, (int)c);
+    if ((k != last) && (*k == (int)c))
+      return val_[k-col_.begin()];
+    return zero_;
+  }
+
+  template <class T>
+  int SparseMatrixCSR<T>::tolist(Matrix1< SparseMatrixTriplet<T> >& MT,
+				 int matrixt) const
+  {
+    int elem = 0;
+    for (size_t r=0; r<rows_; r++)
+      for (size_t k=rowptr_[r]; k<rowptr_[r+1]; k++)
+	if ((matrixt==0) ||
+	    ((matrixt==1) && ((int)r <= col_[k])) ||
+	    ((matrixt==2) && ((int)r == col_[k]))) {
+	  MT(elem) = SparseMatrixTriplet<T>(r, col_[k], val_[k]);
+	  elem++;
+	}
+    return elem;
+  }
+
+  template <class T>
+  int SparseMatrixCSR<T>::tolist(Matrix1< int >& Tr,
+				 Matrix1< int >& Tc,
+				 Matrix1< T >& Tv,
+				 int matrixt) const
+  {
+    int elem = 0;
+    for (size_t r=0; r<rows_; r++)
+      for (size_t k=rowptr_[r]; k<rowptr_[r+1]; k++)
+	if ((matrixt==0) ||
+	    ((matrixt==1) && ((int)r <= col_[k])) ||
+	    ((matrixt==2) && ((int)r == col_[k]))) {
+	  Tr(elem) = r;
+	  Tc(elem) = col_[k];
+	  Tv(elem) = val_[k];
+	  elem++;
+	}
+    return elem;
+  }
+
+  template <class T>
+  bool SparseMatrixCSR<T>::save(std::string filename,
+				IOMatrixtype matrixt,
+				bool binary) const
+  {
+    std::ofstream O;
+    if (binary)
+      O.open(filename.c_str(), std::ios::out | std::ios::binary);
+    else
+      O.open(filename.c_str(), std::ios::out);
+    if (!O.is_open()) 
+      return false;
+    IOHelperSM<T> ioh;
+    ioh.cD(this).binary(binary).matrixtype(matrixt);
+    ioh.OH(O).OD(O);
+    O.close();
+    return true;
+  }
+
+
+  template <class T>
+  SparseMatrixCSR<T>& SparseMatrixBuilder<T>::compress(SparseMatrixCSR<T>& M)
+  {
+    size_t n = triplets_.size();
+    M.rows_ = rows_;
+    M.cols_ = cols_;
+    M.rowptr_.assign(rows_+1, 0);
+
+    /* Counting sort by row. */
+    for (size_t i=0; i<n; i++)
+      M.rowptr_[triplets_[i].r+1]++;
+    for (size_t r=0; r<rows_; r++)
+      M.rowptr_[r+1] += M.rowptr_[r];
+    std::vector< std::pair<int, T> > elem(n);
+    {
+      std::vector<size_t> next(M.rowptr_.begin(), M.rowptr_.end()-1);
+      for (size_t i=0; i<n; i++) {
+	const SparseMatrixTriplet<T>& t = triplets_[i];
+	elem[next[t.r]++] = std::pair<int, T>(t.c, t.value);
+      }
+    }
+    std::vector< SparseMatrixTriplet<T> >().swap(triplets_);
+
+    /* Sort each row by column, and sum duplicates. */
+    M.col_.clear();
+    M.val_.clear();
+    M.col_.reserve(n);
+    M.val_.reserve(n);
+    size_t first = 0;
+    for (size_t r=0; r<rows_; r++) {
+      size_t last = M.rowptr_[r+1];
+      std::stable_sort(elem.begin()+first, elem.begin()+last,
+		SparseMatrixBuilder<T>::col_less);
+      M.rowptr_[r] = M.col_.size();
+      for (size_t k=first; k<last; k++) {
+	if ((k > first) && (elem[k].first == M.col_.back()))
+	  M.val_.back() += elem[k].second;
+	else {
+	  M.col_.push_back(elem[k].first);
+	  M.val_.push_back(elem[k].second);
+	}
+      }
+      first = last;
+    }
+    M.rowptr_[rows_] = M.col_.size();
+    return M;
+  }
+
+
+  template <class T>
+  Matrix<T> diag(const SparseMatrixCSR<T>& M1) {
+    Matrix<T> M(M1.rows(),1);
+    for (size_t i=0; ((i<M1.rows()) && (i<M1.cols())); i++) {
+      M(i,0) = M1(i,i);
+    }
+    return M;
+  };
+
+  /*!
+    Row-by-row (Gustavson) product, with a dense accumulator and
+    a column marker that are reused for all rows.
+   */
+  template <class T>
+  SparseMatrixCSR<T> operator*(const SparseMatrixCSR<T>& M1,
+			       const SparseMatrixCSR<T>& M2)
+  {
+    SparseMatrixCSR<T> M(M1.rows(), M2.cols());
+    std::vector<T> acc(M2.cols(), T());
+    std::vector<size_t> marker(M2.cols(), (size_t)-1);
+    std::vector<int> cols;
+    for (size_t i=0; i<M1.rows(); i++) {
+      cols.clear();
+      for (size_t ik=M1.rowptr_[i]; ik<M1.rowptr_[i+1]; ik++) {
+	size_t k = M1.col_[ik];
+	if (!(k < M2.rows()))
+	  break;
+	const T& M1ik = M1.val_[ik];
+	for (size_t kj=M2.rowptr_[k]; kj<M2.rowptr_[k+1]; kj++) {
+	  int j = M2.col_[kj];
+	  if (marker[j] != i) {
+	    marker[j] = i;
+	    acc[j] = T();
+	    cols.push_back(j);
+	  }
+	  acc[j] += M1ik * M2.val_[kj];
+	}
+      }
+      std::sort(cols.begin(), cols.end());
+      for (size_t jj=0; jj<cols.size(); jj++) {
+	M.col_.push_back(cols[jj]);
+	M.val_.push_back(acc[cols[jj]]);
+      }
+      M.rowptr_[i+1] = M.col_.size();
+    }
+    return M;
+  }
+
+  template <class T>
+  SparseMatrixCSR<T> operator-(const SparseMatrixCSR<T>& M1,
+			       const SparseMatrixCSR<T>& M2)
+  {
+    SparseMatrixCSR<T> M(M1.rows(), M1.cols());
+    M.col_.reserve(M1.nnz()+M2.nnz());
+    M.val_.reserve(M1.nnz()+M2.nnz());
+    for (size_t r=0; r<M1.rows(); r++) {
+      size_t k1 = M1.rowptr_[r];
+      size_t k2 = 0;
+      size_t k2end = 0;
+      if (r < M2.rows()) {
+	k2 = M2.rowptr_[r];
+	k2end = M2.rowptr_[r+1];
+	/* Columns outside M1 are ignored. */
+	while ((k2end > k2) && !((size_t)M2.col_[k2end-1] < M1.cols()))
+	  k2end--;
+      }
+      while ((k1 < M1.rowptr_[r+1]) || (k2 < k2end)) {
+	if ((k2 == k2end) ||
+	    ((k1 < M1.rowptr_[r+1]) && (M1.col_[k1] < M2.col_[k2]))) {
+	  M.col_.push_back(M1.col_[k1]);
+	  M.val_.push_back(M1.val_[k1]);
+	  k1++;
+	} else if ((k1 == M1.rowptr_[r+1]) || (M2.col_[k2] < M1.col_[k1])) {
+	  M.col_.push_back(M2.col_[k2]);
+	  M.val_.push_back(T()-M2.val_[k2]);
+	  k2++;
+	} else {
+	  M.col_.push_back(M1.col_[k1]);
+	  M.val_.push_back(M1.val_[k1]-M2.val_[k2]);
+	  k1++;
+	  k2++;
+	}
+      }
+      M.rowptr_[r+1] = M.col_.size();
+    }
+    return M;
+  }
+
+  template <class T>
+  SparseMatrixCSR<T> inverse(const SparseMatrixCSR<T>& M1,
+			     bool diagonal)
+  {
+    SparseMatrixCSR<T> M(M1.rows(), M1.cols());
+    if (!diagonal) {
+      /* NOT IMPLEMENTED */
+      return M;
+    }
+    for (size_t r=0; r<M1.rows(); r++) {
+      if (r < M1.cols()) {
+	const T& val = M1(r,r);
+	if (!(val==T())) {
+	  M.col_.push_back(r);
+	  M.val_.push_back(1/val);
+	}
+      }
+      M.rowptr_[r+1] = M.col_.size();
+    }
+    return M;
+  }
+
+
+
+
+
   template <class T>
   const T fmesh::Matrix<T>::zero_ = T();
   template <class T>
   const T fmesh::SparseMatrixRow<T>::zero_ = T();
   template <class T>
   const T fmesh::SparseMatrix<T>::zero_ = T();
+  template <class T>
+  const T fmesh::SparseMatrixCSR<T>::zero_ = T();
 
 
 } /* namespace fmesh */
@@ -1345,6 +1345,8 @@ int GMRFLib_ai_marginal_hidden(GMRFLib_density_tp ** density, GMRFLib_density_tp
 	GMRFLib_blockupdate_param_tp *blockpar = NULL;
 	GMRFLib_problem_tp *newp = NULL;
 	GMRFLib_store_tp *store = NULL;
+	GMRFLib_arena_tp *arena = NULL;
+	GMRFLib_arena_mark_tp arena_mark;
 
 #define COMPUTE_CPO_DENSITY						\
 	if (cpo_density) {						\
@@ -1353,7 +1355,7 @@ int GMRFLib_ai_marginal_hidden(GMRFLib_density_tp ** density, GMRFLib_density_tp
 			int itry, np_orig = 51, _debug = 0, _one = 1, _i, ex = 2; \
 			double cor_eps = GMRFLib_eps(0.75), cor_max;	\
 									\
-			work = Calloc(4*np_orig+ex, double); /* storage */ \
+			work = Arena_Calloc(arena, 4*np_orig+ex, double); /* storage */ \
 			for(itry = 0; itry < 2;	itry++)			\
 			{						\
 				int np = np_orig;			\
@@ -1402,7 +1404,6 @@ int GMRFLib_ai_marginal_hidden(GMRFLib_density_tp ** density, GMRFLib_density_tp
 				if (*cpo_density || itry == 1)		\
 					break;				\
 			}						\
-			Free(work);					\
 		} else {						\
 			if (ai_par->cpo_manual){			\
 				GMRFLib_density_duplicate(cpo_density, *density); \
@@ -1571,15 +1572,22 @@ int GMRFLib_ai_marginal_hidden(GMRFLib_density_tp ** density, GMRFLib_density_tp
 	GMRFLib_ghq_abscissas(&x_points, n_points);	       /* get the x-points */
 	qsort(x_points, (size_t) n_points, sizeof(double), GMRFLib_dcmp_abs);	/* sort them using ABS() */
 
-	log_density = Calloc(n_points, double);		       /* values of the log_density */
-	cond_mode = Calloc(n, double);
-	fixed_mode = Calloc(n, double);
+	/*
+	 * scratch storage from the thread-private arena, released at the end. this routine can run in parallel with a shared
+	 * ai_store, so the arena cannot live in the ai_store.
+	 */
+	arena = GMRFLib_arena_thread();
+	GMRFLib_arena_mark(arena, &arena_mark);
+
+	log_density = Arena_Calloc(arena, n_points, double);   /* values of the log_density */
+	cond_mode = Arena_Calloc(arena, n, double);
+	fixed_mode = Arena_Calloc(arena, n, double);
 	memcpy(cond_mode, ai_store->problem->mean_constr, n * sizeof(double));
 	memcpy(fixed_mode, ai_store->problem->mean_constr, n * sizeof(double));
 
-	fix = Calloc(n, char);
-	fixx = Calloc(n, char);
-	derivative = Calloc(n, double);
+	fix = Arena_Calloc(arena, n, char);
+	fixx = Arena_Calloc(arena, n, char);
+	derivative = Arena_Calloc(arena, n, double);
 
 	/*
 	 * the conditonal_mean is returned through 'derivative' 
@@ -1949,12 +1957,7 @@ int GMRFLib_ai_marginal_hidden(GMRFLib_density_tp ** density, GMRFLib_density_tp
 
 	COMPUTE_CPO_DENSITY;
 
-	Free(fixed_mode);
-	Free(fix);
-	Free(fixx);
-	Free(cond_mode);
-	Free(derivative);
-	Free(log_density);
+	GMRFLib_arena_release(arena, &arena_mark);
 	Free(optpar);
 	Free(blockpar);
 	if (free_ai_par) {
@@ -2621,6 +2624,7 @@ int GMRFLib_init_GMRF_approximation_store__intern(GMRFLib_problem_tp ** problem,
 	}
 
 	int iter, itmax = optpar->max_iter;
+	double *acoof = Calloc(IMAX(1, nidx), double), *bcoof = Calloc(IMAX(1, nidx), double), *ccoof = Calloc(IMAX(1, nidx), double);
 
 	/*
 	 * these tricks are currently disabled 
@@ -2644,31 +2648,27 @@ int GMRFLib_init_GMRF_approximation_store__intern(GMRFLib_problem_tp ** problem,
 		memcpy(cc, c, n * sizeof(double));
 
 		cc_is_negative = 0;
-#pragma omp parallel for private(i) schedule(static)
+		GMRFLib_2order_approx_batch(acoof, bcoof, ccoof, d, nidx, idxs, mode, loglFunc, loglFunc_arg, &(optpar->step_len),
+					    &(optpar->stencil));
 		for (i = 0; i < nidx; i++) {
-			int idx;
-			double bcoof, ccoof;
-
-			GMRFLib_thread_id = id;
-			idx = idxs[i];
-			GMRFLib_2order_approx(&(aa[idx]), &bcoof, &ccoof, d[idx], mode[idx], idx, mode, loglFunc, loglFunc_arg, &(optpar->step_len),
-					      &(optpar->stencil));
-			cc_is_negative = (cc_is_negative || ccoof < 0.0);	/* this line IS OK! also for multithread.. */
+			int idx = idxs[i];
+
+			aa[idx] = acoof[i];
+			cc_is_negative = (cc_is_negative || ccoof[i] < 0.0);
 			if (cc_positive) {
-				bb[idx] += bcoof;
-				cc[idx] += DMAX(cmin, ccoof);
+				bb[idx] += bcoof[i];
+				cc[idx] += DMAX(cmin, ccoof[i]);
 			} else {
-				if (ccoof > 0.0) {
-					bb[idx] += bcoof;
-					cc[idx] += ccoof;
+				if (ccoof[i] > 0.0) {
+					bb[idx] += bcoof[i];
+					cc[idx] += ccoof[i];
 				} else {
-					bb[idx] += bcoof;
-					// bb[idx] += cc_factor*bcoof; /* what to use?? if any...*/
-					cc[idx] += cc_factor * ccoof;
+					bb[idx] += bcoof[i];
+					// bb[idx] += cc_factor*bcoof[i]; /* what to use?? if any...*/
+					cc[idx] += cc_factor * ccoof[i];
 				}
 			}
 		}
-		GMRFLib_thread_id = id;
 		if (!cc_positive) {
 			cc_factor = DMIN(1.0, cc_factor * cc_factor_mult);
 		}
@@ -2744,14 +2744,11 @@ int GMRFLib_init_GMRF_approximation_store__intern(GMRFLib_problem_tp ** problem,
 			/*
 			 * I need to update 'aa' as this is not evaluated in the mode! The sum of the a's are used later
 			 */
-#pragma omp parallel for private(i) schedule(static)
+			GMRFLib_2order_approx_batch(acoof, NULL, NULL, d, nidx, idxs, mode, loglFunc, loglFunc_arg, &(optpar->step_len),
+						    &(optpar->stencil));
 			for (i = 0; i < nidx; i++) {
-				int idx = idxs[i];
-				GMRFLib_thread_id = id;
-				GMRFLib_2order_approx(&(aa[idx]), NULL, NULL, d[idx], mode[idx], idx, mode, loglFunc, loglFunc_arg, &(optpar->step_len),
-						      &(optpar->stencil));
+				aa[idxs[i]] = acoof[i];
 			}
-			GMRFLib_thread_id = id;
 		}
 
 		if (err < optpar->abserr_step || gaussian_data || flag_cycle_behaviour) {
@@ -2783,6 +2780,10 @@ int GMRFLib_init_GMRF_approximation_store__intern(GMRFLib_problem_tp ** problem,
 		lproblem = NULL;
 	}
 
+	Free(acoof);
+	Free(bcoof);
+	Free(ccoof);
+
 	if (iter < itmax) {
 		*problem = lproblem;
 	} else {
@@ -3492,6 +3493,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 		 * good way to get around it for the moment.
 		 */
 
+		GMRFLib_openmp_nested_probe(graph, Qfunc, Qfunc_arg);
 		GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_OPTIMIZE, (void *) &nhyper);
 
 		GMRFLib_domin_setup(hyperparam, nhyper, log_extra, log_extra_arg, compute, x, b, c, mean, bfunc, d, loglFunc, loglFunc_arg,
@@ -3866,6 +3868,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 					ttheta = Calloc(nhyper, double);
 					memset(zz, 0, nhyper * sizeof(double));
 					GMRFLib_thread_id = omp_get_thread_num();
+					GMRFLib_openmp_nested_set_inner();
 
 					if (omp_in_parallel()) {
 						if (!ais[GMRFLib_thread_id]) {
@@ -3905,6 +3908,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 					ttheta = Calloc(nhyper, double);
 					memset(zz, 0, nhyper * sizeof(double));
 					GMRFLib_thread_id = omp_get_thread_num();
+					GMRFLib_openmp_nested_set_inner();
 
 					if (omp_in_parallel()) {
 						if (!ais[GMRFLib_thread_id]) {
@@ -3988,13 +3992,16 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 			memcpy(x_mode, ai_store->mode, graph->n * sizeof(double));
 		}
 
-		GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, NULL);
-
 		if (timer) {
 			timer[1] = GMRFLib_cpu() - timer[1];
 			timer[2] = GMRFLib_cpu();
 		}
 		if (ai_par->int_strategy == GMRFLib_AI_INT_STRATEGY_EMPIRICAL_BAYES) {
+			/*
+			 * one configuration, so the work to split is the marginals
+			 */
+			GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, (void *) &compute_n);
+
 			if (need_Qinv) {
 				GMRFLib_ai_add_Qinv_to_ai_store(ai_store);	/* add Qinv if required */
 			}
@@ -4063,6 +4070,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 
 			GMRFLib_design_tp *design = NULL;
 			GMRFLib_get_design(&design, nhyper);
+			GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, (void *) &(design->nexperiments));
 
 			f = DMAX(ai_par->f0, 1.0) * sqrt((double) nhyper);
 			w = 1.0 / ((design->nexperiments - 1.0) * (1.0 + exp(-0.5 * SQR(f)) * (SQR(f) / nhyper - 1.0)));
@@ -4080,23 +4088,43 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 				CHECK_DENS_STORAGE_FORCE(design->nexperiments);
 				CHECK_HYPER_STORAGE_FORCE(design->nexperiments);
 
-#pragma omp parallel for private(k, i, log_dens, dens_count, hyper_count, tref, tu, ierr)
-				for (k = 0; k < design->nexperiments; k++) {
+				/*
+				 * run the configurations along a path where neighbouring configurations are close, so each can start
+				 * from the mode of the previous one. the path is cut into short chunks of fixed length which are handed
+				 * out one at a time, and each chunk starts from the global mode. the starting values, and hence the
+				 * results, do not depend on the number of threads nor on their timing.
+				 */
+				int pos, *order = NULL;
+
+				order = Calloc(design->nexperiments, int);
+				GMRFLib_design_order(order, design);
+
+#pragma omp parallel for private(pos, k, i, log_dens, dens_count, hyper_count, tref, tu, ierr) schedule(dynamic, GMRFLib_AI_CCD_CHUNK)
+				for (pos = 0; pos < design->nexperiments; pos++) {
 
 					double *z_local, *theta_local, log_dens_orig;
 					GMRFLib_ai_store_tp *ai_store_id = NULL;
 					GMRFLib_tabulate_Qfunc_tp *tabQfunc = NULL;
 					double *bnew = NULL;
 
+					k = order[pos];
 					dens_count = k;
 					hyper_count = k;
 					GMRFLib_thread_id = omp_get_thread_num();
+					GMRFLib_openmp_nested_set_inner();
 
 					if (omp_in_parallel()) {
 						if (!ais[GMRFLib_thread_id]) {
 							ais[GMRFLib_thread_id] = GMRFLib_duplicate_ai_store(ai_store, GMRFLib_FALSE, GMRFLib_TRUE);
 						}
 						ai_store_id = ais[GMRFLib_thread_id];
+
+						/*
+						 * at the start of a chunk, start from the mode
+						 */
+						if (pos % GMRFLib_AI_CCD_CHUNK == 0 && ai_store->mode && ai_store_id->mode) {
+							memcpy(ai_store_id->mode, ai_store->mode, graph->n * sizeof(double));
+						}
 					} else {
 						ai_store_id = ai_store;	/* the common one */
 					}
@@ -4211,6 +4239,8 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 					Free(theta_local);
 				}
 
+				Free(order);
+
 				/*
 				 * set the values back 
 				 */
@@ -4373,11 +4403,14 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 				unsigned int kk;
 
 				GMRFLib_ai_pool_init(&pool, ai_par, nhyper);
+				int nconfig = (int) pool->nconfig;
+
+				GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, (void *) &nconfig);
 
 				GMRFLib_ASSERT(dens_count == 0, GMRFLib_ESNH);
 				GMRFLib_ASSERT(hyper_count == 0, GMRFLib_ESNH);
 
-#pragma omp parallel for private(i, log_dens, tref, tu, ierr)
+#pragma omp parallel for private(i, log_dens, tref, tu, ierr) schedule(dynamic)
 				for (kk = 0; kk < pool->nconfig; kk++) {
 					GMRFLib_ai_store_tp *ai_store_id = NULL;
 					GMRFLib_density_tp **dens_local = NULL;
@@ -4398,6 +4431,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 					if (err == GMRFLib_SUCCESS) {
 						tref = GMRFLib_cpu();
 						GMRFLib_thread_id = omp_get_thread_num();
+						GMRFLib_openmp_nested_set_inner();
 
 						if (omp_in_parallel()) {
 							if (!ais[GMRFLib_thread_id]) {
@@ -4567,6 +4601,8 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 					Free(bnew);
 				}
 			} else {
+				GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, NULL);
+
 				k_max = Calloc(nhyper, int);
 				k_maxx = Calloc(nhyper, int);
 				k_min = Calloc(nhyper, int);
@@ -4895,7 +4931,7 @@ int GMRFLib_ai_INLA(GMRFLib_density_tp *** density, GMRFLib_density_tp *** gdens
 		 * this is the case for nhyper = 0 
 		 */
 
-		GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, NULL);
+		GMRFLib_openmp_implement_strategy(GMRFLib_OPENMP_PLACES_INTEGRATE, (void *) &compute_n);
 
 		if (timer) {
 			timer[1] = 0.0;
@@ -6171,41 +6207,32 @@ int GMRFLib_ai_compute_lincomb(GMRFLib_density_tp *** lindens, double **cross, i
 		 * this version require TAUCS. 
 		 */
 
+		taucs_ccs_matrix *L = (taucs_ccs_matrix *) (problem->sub_sm_fact.L);
+		int *lc_order = NULL, *lc_from = NULL, nblock, blk;
+
 		if (cross) {
 			cross_store = Calloc(nlin, cross_tp);
 		}
+
+		/*
+		 * first the index-ranges of each linear combination, then sort them by the first (mapped) index, so that the
+		 * combinations in each block of GMRFLib_NRHS_BLOCK have similar ranges and are solved in one pass over L.
+		 */
+		lc_order = Calloc(nlin, int);
+		lc_from = Calloc(nlin, int);
 #pragma omp parallel for private(i, j, k)
 		for (i = 0; i < nlin; i++) {
-
-			int from_idx, to_idx, len, from_idx_a, to_idx_a, len_a;
-			double var, mean, imean, *a = NULL, *b = NULL, *v = NULL, var_corr, weight;
-
 			if (Alin[i]->tinfo[id].first_nonzero < 0) {
 				/*
 				 * we know that the idx's are sorted, so its easier to find the first and last non-zero 
 				 */
-				// Alin[i]->tinfo[id].first_nonzero = GMRFLib_imin_value(Alin[i]->idx, Alin[i]->n);
 				Alin[i]->tinfo[id].first_nonzero = Alin[i]->idx[0];
 			}
-
 			if (Alin[i]->tinfo[id].last_nonzero < 0) {
-				/*
-				 * we know that the idx's are sorted, so its easier to find the first and last non-zero 
-				 */
-				// Alin[i]->tinfo[id].last_nonzero = GMRFLib_imax_value(Alin[i]->idx, Alin[i]->n);
 				Alin[i]->tinfo[id].last_nonzero = Alin[i]->idx[Alin[i]->n - 1];
 			}
-
-			from_idx_a = Alin[i]->tinfo[id].first_nonzero;
-			to_idx_a = Alin[i]->tinfo[id].last_nonzero;
-			assert(LEGAL(from_idx_a, n));
-			assert(LEGAL(to_idx_a, n));
-			len_a = to_idx_a - from_idx_a + 1;
-
-			a = Calloc(len_a, double);
-			for (j = 0; j < Alin[i]->n; j++) {
-				a[Alin[i]->idx[j] - from_idx_a] = (double) Alin[i]->weight[j];
-			}
+			assert(LEGAL(Alin[i]->tinfo[id].first_nonzero, n));
+			assert(LEGAL(Alin[i]->tinfo[id].last_nonzero, n));
 
 			/*
 			 * compute the first non-zero index (mapped) if not already there
@@ -6220,97 +6247,113 @@ int GMRFLib_ai_compute_lincomb(GMRFLib_density_tp *** lindens, double **cross, i
 				Alin[i]->tinfo[id].first_nonzero_mapped = findx;
 				Alin[i]->tinfo[id].last_nonzero_mapped = -1;
 			}
+			lc_order[i] = i;
+			lc_from[i] = Alin[i]->tinfo[id].first_nonzero_mapped;
+		}
+		GMRFLib_qsorts((void *) lc_from, (size_t) nlin, sizeof(int), (void *) lc_order, sizeof(int), NULL, 0, GMRFLib_icmp);
+		nblock = (nlin + GMRFLib_NRHS_BLOCK - 1) / GMRFLib_NRHS_BLOCK;
 
-			from_idx = Alin[i]->tinfo[id].first_nonzero_mapped;
-			to_idx = (Alin[i]->tinfo[id].last_nonzero_mapped < 0 ? n - 1 : Alin[i]->tinfo[id].last_nonzero_mapped);
-			len = to_idx - from_idx + 1;
-			b = Calloc(2 * len, double);	       /* workaround.... do not know what is happening sometimes */
-			v = Calloc(len, double);
-			for (j = 0; j < Alin[i]->n; j++) {
-				b[remap[Alin[i]->idx[j]] - from_idx] = (double) Alin[i]->weight[j];
-			}
+#pragma omp parallel for private(blk, i, j, k) schedule(dynamic)
+		for (blk = 0; blk < nblock; blk++) {
 
-			/*
-			 * solve L v = b, using the index-range computed.
-			 */
-			taucs_ccs_matrix *L = (taucs_ccs_matrix *) (problem->sub_sm_fact.L);
-			int ip, ii, jj;
-			double Aij, Ajj;
+			int kk, k0, nb, b_from, b_to, b_len, from_idx, to_idx, len, jj;
+			double var, mean, imean, *X = NULL, *v = NULL, var_corr, weight;
 
-			for (jj = 0; jj < len; jj++) {
-				ip = L->colptr[jj + from_idx];
-				Ajj = L->values.d[ip];
-				v[jj] = b[jj] / Ajj;
-
-				for (ip = L->colptr[jj + from_idx] + 1; ip < L->colptr[jj + from_idx + 1]; ip++) {
-					ii = L->rowind[ip] - from_idx;
-					Aij = L->values.d[ip];
-					b[ii] -= v[jj] * Aij;
-				}
+			k0 = blk * GMRFLib_NRHS_BLOCK;
+			nb = IMIN(GMRFLib_NRHS_BLOCK, nlin - k0);
+			b_from = n;
+			b_to = -1;
+			for (kk = 0; kk < nb; kk++) {
+				i = lc_order[k0 + kk];
+				b_from = IMIN(b_from, Alin[i]->tinfo[id].first_nonzero_mapped);
+				b_to = IMAX(b_to, (Alin[i]->tinfo[id].last_nonzero_mapped < 0 ? n - 1 : Alin[i]->tinfo[id].last_nonzero_mapped));
 			}
+			b_len = b_to - b_from + 1;
 
 			/*
-			 * compute the last non-zero index (mapped) if not already there
+			 * solve L V = B for the block, using the index-range computed. the right hand sides are interleaved, so that
+			 * row r of combination kk is X[(r - b_from) * nb + kk].
 			 */
-			if (Alin[i]->tinfo[id].last_nonzero_mapped < 0) {
-				Alin[i]->tinfo[id].last_nonzero_mapped = GMRFLib_find_nonzero(v, len, -1) + from_idx;
+			X = Calloc(b_len * nb, double);
+			for (kk = 0; kk < nb; kk++) {
+				i = lc_order[k0 + kk];
+				for (j = 0; j < Alin[i]->n; j++) {
+					X[(remap[Alin[i]->idx[j]] - b_from) * nb + kk] = (double) Alin[i]->weight[j];
+				}
 			}
+			GMRFLib_my_taucs_dccs_solve_l_block_range(L, X, nb, b_from, b_to);
 
-			/*
-			 * we do not need to map back since the innerproduct is the same in any case. It is here possible to store only the non-zero indices of v,
-			 * and do the inner product over those, as they will remain the same for various calls to this function, but I don't think this is worth it.
-			 */
-			var = ddot_(&len, v, &one, v, &one);
-			if (cross) {
-				cross_store[i].from_idx = from_idx;
-				cross_store[i].to_idx = to_idx;
-				cross_store[i].v = v;
-				v = NULL;
-			} else {
-				Free(v);
-			}
-			Free(b);
+			for (kk = 0; kk < nb; kk++) {
+				i = lc_order[k0 + kk];
+				from_idx = Alin[i]->tinfo[id].first_nonzero_mapped;
+				to_idx = (Alin[i]->tinfo[id].last_nonzero_mapped < 0 ? n - 1 : Alin[i]->tinfo[id].last_nonzero_mapped);
+				len = to_idx - from_idx + 1;
+				v = Calloc(len, double);
+				for (jj = 0; jj < len; jj++) {
+					v[jj] = X[(jj + from_idx - b_from) * nb + kk];
+				}
 
-			/*
-			 * the correction matrix due to linear constraints 
-			 */
-			var_corr = 0.0;
-			if (nc) {
-				for (j = 0; j < nc; j++) {
-					/*
-					 * w = AA^T CONSTR_M 
-					 */
-					double *p, *pp, w, ww;
+				/*
+				 * compute the last non-zero index (mapped) if not already there
+				 */
+				if (Alin[i]->tinfo[id].last_nonzero_mapped < 0) {
+					Alin[i]->tinfo[id].last_nonzero_mapped = GMRFLib_find_nonzero(v, len, -1) + from_idx;
+				}
 
-					w = ww = 0.0;
-					p = &(problem->constr_m[j * n]);
-					pp = &(problem->qi_at_m[j * n]);
+				/*
+				 * we do not need to map back since the innerproduct is the same in any case.
+				 */
+				var = ddot_(&len, v, &one, v, &one);
+				if (cross) {
+					cross_store[i].from_idx = from_idx;
+					cross_store[i].to_idx = to_idx;
+					cross_store[i].v = v;
+					v = NULL;
+				} else {
+					Free(v);
+				}
+
+				/*
+				 * the correction matrix due to linear constraints 
+				 */
+				var_corr = 0.0;
+				if (nc) {
+					for (j = 0; j < nc; j++) {
+						/*
+						 * w = AA^T CONSTR_M 
+						 */
+						double *p, *pp, w, ww;
 
-					for (jj = 0; jj < Alin[i]->n; jj++) {
-						k = Alin[i]->idx[jj];
-						weight = (double) Alin[i]->weight[jj];
+						w = ww = 0.0;
+						p = &(problem->constr_m[j * n]);
+						pp = &(problem->qi_at_m[j * n]);
 
-						w += weight * p[k];
-						ww += weight * pp[k];
+						for (jj = 0; jj < Alin[i]->n; jj++) {
+							k = Alin[i]->idx[jj];
+							weight = (double) Alin[i]->weight[jj];
+
+							w += weight * p[k];
+							ww += weight * pp[k];
+						}
+						var_corr += w * ww;
 					}
-					var_corr += w * ww;
 				}
-			}
 
-			mean = imean = 0.0;
-			for (j = 0; j < Alin[i]->n; j++) {
-				k = Alin[i]->idx[j];
-				weight = (double) Alin[i]->weight[j];
+				mean = imean = 0.0;
+				for (j = 0; j < Alin[i]->n; j++) {
+					k = Alin[i]->idx[j];
+					weight = (double) Alin[i]->weight[j];
 
-				mean += weight * problem->mean_constr[k];
-				imean += weight * improved_mean[k];
+					mean += weight * problem->mean_constr[k];
+					imean += weight * improved_mean[k];
+				}
+				var = DMAX(DBL_EPSILON, var - var_corr);
+				GMRFLib_density_create_normal(&d[i], (imean - mean) / sqrt(var), 1.0, mean, sqrt(var));
 			}
-			var = DMAX(DBL_EPSILON, var - var_corr);
-			GMRFLib_density_create_normal(&d[i], (imean - mean) / sqrt(var), 1.0, mean, sqrt(var));
-
-			Free(a);
+			Free(X);
 		}
-
+		Free(lc_order);
+		Free(lc_from);
 
 		if (cross) {
 			/*
@@ -6406,52 +6449,66 @@ int GMRFLib_ai_compute_lincomb(GMRFLib_density_tp *** lindens, double **cross, i
 		if (cross) {
 			FIXME("CROSS IS NOT SUPPORTED FOR THE SLOW/OLD VERSION.");
 		}
-#pragma omp parallel for private(i, j)
-		for (i = 0; i < nlin; i++) {
 
-			double *v = NULL, var, mean, imean, *a = NULL, w, ww, var_corr, *p;
+		int nblock = (nlin + GMRFLib_NRHS_BLOCK - 1) / GMRFLib_NRHS_BLOCK, blk;
 
-			v = Calloc(n, double);
-			a = Calloc(n, double);
+		/*
+		 * solve for GMRFLib_NRHS_BLOCK linear combinations at the time
+		 */
+#pragma omp parallel for private(blk, i, j)
+		for (blk = 0; blk < nblock; blk++) {
+
+			int kk, k0 = blk * GMRFLib_NRHS_BLOCK, nb = IMIN(GMRFLib_NRHS_BLOCK, nlin - k0);
+			double *V = NULL, *v = NULL, var, mean, imean, *a = NULL, w, ww, var_corr, *p;
 
-			memset(a, 0, n * sizeof(double));
-			for (j = 0; j < Alin[i]->n; j++) {
-				a[Alin[i]->idx[j]] = (double) Alin[i]->weight[j];
+			V = Calloc(n * nb, double);
+			for (kk = 0; kk < nb; kk++) {
+				i = k0 + kk;
+				for (j = 0; j < Alin[i]->n; j++) {
+					V[kk * n + Alin[i]->idx[j]] = (double) Alin[i]->weight[j];
+				}
 			}
-			memcpy(v, a, n * sizeof(double));
+			GMRFLib_solve_l_sparse_matrix_nrhs(V, nb, &(problem->sub_sm_fact), problem->sub_graph);
 
-			GMRFLib_solve_l_sparse_matrix(v, &(problem->sub_sm_fact), problem->sub_graph);
+			a = Calloc(n, double);
+			for (kk = 0; kk < nb; kk++) {
+				i = k0 + kk;
+				v = &V[kk * n];
+				memset(a, 0, n * sizeof(double));
+				for (j = 0; j < Alin[i]->n; j++) {
+					a[Alin[i]->idx[j]] = (double) Alin[i]->weight[j];
+				}
 
-			/*
-			 * the correction matrix due to linear constraints 
-			 */
-			var_corr = 0.0;
-			if (nc) {
-				for (j = 0; j < nc; j++) {
-					/*
-					 * w = AA^T CONSTR_M 
-					 */
-					p = &(problem->constr_m[j * n]);
-					w = ddot_(&n, a, &one, p, &one);
+				/*
+				 * the correction matrix due to linear constraints 
+				 */
+				var_corr = 0.0;
+				if (nc) {
+					for (j = 0; j < nc; j++) {
+						/*
+						 * w = AA^T CONSTR_M 
+						 */
+						p = &(problem->constr_m[j * n]);
+						w = ddot_(&n, a, &one, p, &one);
 
-					/*
-					 * ww = AA * QI_AT 
-					 */
-					p = &(problem->qi_at_m[j * n]);
-					ww = ddot_(&n, a, &one, p, &one);
+						/*
+						 * ww = AA * QI_AT 
+						 */
+						p = &(problem->qi_at_m[j * n]);
+						ww = ddot_(&n, a, &one, p, &one);
 
-					var_corr += w * ww;
+						var_corr += w * ww;
+					}
 				}
-			}
-
-			var = ddot_(&n, v, &one, v, &one);
-			mean = ddot_(&n, a, &one, problem->mean_constr, &one);
-			imean = ddot_(&n, a, &one, improved_mean, &one);
 
-			var = DMAX(DBL_EPSILON, var - var_corr);
-			GMRFLib_density_create_normal(&d[i], (imean - mean) / sqrt(var), 1.0, mean, sqrt(var));
+				var = ddot_(&n, v, &one, v, &one);
+				mean = ddot_(&n, a, &one, problem->mean_constr, &one);
+				imean = ddot_(&n, a, &one, improved_mean, &one);
 
-			Free(v);
+				var = DMAX(DBL_EPSILON, var - var_corr);
+				GMRFLib_density_create_normal(&d[i], (imean - mean) / sqrt(var), 1.0, mean, sqrt(var));
+			}
+			Free(V);
 			Free(a);
 		}
 	}
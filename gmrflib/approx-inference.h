@@ -871,6 +871,12 @@ typedef struct {
 #define GMRFLib_AI_POOL_GET 1
 #define GMRFLib_AI_POOL_SET 2
 
+/*
+ * the number of consecutive configurations along the CCD path that are run by the same thread, each chunk starting
+ * from the global mode
+ */
+#define GMRFLib_AI_CCD_CHUNK 4
+
 int GMRFLib_ai_pool_free(GMRFLib_ai_pool_tp * pool);
 int GMRFLib_ai_pool_get(GMRFLib_ai_pool_tp * pool, int *iz, size_t * idx);
 int GMRFLib_ai_pool_init(GMRFLib_ai_pool_tp ** pool, GMRFLib_ai_param_tp * ai_par, int nhyper);
@@ -0,0 +1,215 @@
+
+/* arena.c
+ * 
+ * Copyright (C) 2007 Havard Rue
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The author's contact information:
+ *
+ *       H{\aa}vard Rue
+ *       Department of Mathematical Sciences
+ *       The Norwegian University of Science and Technology
+ *       N-7491 Trondheim, Norway
+ *       Voice: +47-7359-3533    URL  : http://www.math.ntnu.no/~hrue  
+ *       Fax  : +47-7359-3524    Email: havard.rue@math.ntnu.no
+ *
+ */
+
+#ifndef HGVERSION
+#define HGVERSION
+#endif
+static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
+
+/*!
+  \file arena.c
+  \brief A region (arena) allocator for short-lived scratch storage.
+
+  Scratch storage that lives only during the evaluation of one configuration of the hyperparameters, is allocated from an arena
+  instead of with \c Calloc() and \c Free(). Allocating is just advancing a pointer in the current chunk, and all storage is
+  released in O(1) time with \c GMRFLib_arena_reset(), or back to a previous position with \c GMRFLib_arena_release(). The
+  chunks are kept and reused, so after the first few evaluations there are no calls to \c malloc() and no heap-contention between
+  threads. Long-lived objects should still use \c Calloc().
+
+  An arena must only be used by one thread at the time. Each \c GMRFLib_ai_store_tp has its own arena (as an \c ai_store is
+  already used by one thread only), and \c GMRFLib_arena_thread() returns an arena private to the calling thread, for use in
+  routines without an \c ai_store, like the Qfunctions.
+
+  Example:
+  \verbatim
+  GMRFLib_arena_mark_tp mark;
+  GMRFLib_arena_mark(arena, &mark);
+  double *work = Arena_Calloc(arena, n, double);
+  ...
+  GMRFLib_arena_release(arena, &mark);
+  \endverbatim
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#if !defined(__FreeBSD__)
+#include <malloc.h>
+#endif
+
+#include "GMRFLib/GMRFLib.h"
+#include "GMRFLib/GMRFLibP.h"
+
+#define GMRFLib_ARENA_ALIGN (16)
+
+static GMRFLib_arena_tp *GMRFLib_arena_thread_ptr = NULL;
+#pragma omp threadprivate(GMRFLib_arena_thread_ptr)
+
+static GMRFLib_arena_chunk_tp *GMRFLib_arena_new_chunk(size_t size)
+{
+	GMRFLib_arena_chunk_tp *c = Calloc(1, GMRFLib_arena_chunk_tp);
+
+	c->size = size;
+	c->used = 0;
+	c->data = Malloc(size, char);
+	c->next = NULL;
+
+	return c;
+}
+
+/*!
+  \brief Create a new arena, where new chunks are of size \c chunk_size bytes (or larger if required). If \c chunk_size is zero,
+  then \c GMRFLib_ARENA_CHUNK_SIZE is used.
+*/
+GMRFLib_arena_tp *GMRFLib_arena_create(size_t chunk_size)
+{
+	GMRFLib_arena_tp *arena = Calloc(1, GMRFLib_arena_tp);
+
+	arena->chunk_size = (chunk_size ? chunk_size : GMRFLib_ARENA_CHUNK_SIZE);
+	arena->head = arena->cur = GMRFLib_arena_new_chunk(arena->chunk_size);
+
+	return arena;
+}
+
+/*!
+  \brief Return the arena private to the calling thread, which is created the first time.
+*/
+GMRFLib_arena_tp *GMRFLib_arena_thread(void)
+{
+	if (!GMRFLib_arena_thread_ptr) {
+		GMRFLib_arena_thread_ptr = GMRFLib_arena_create(0);
+	}
+	return GMRFLib_arena_thread_ptr;
+}
+
+/*!
+  \brief Free the arena and all its chunks.
+*/
+int GMRFLib_arena_free(GMRFLib_arena_tp * arena)
+{
+	GMRFLib_arena_chunk_tp *c, *next;
+
+	if (!arena) {
+		return GMRFLib_SUCCESS;
+	}
+	for (c = arena->head; c; c = next) {
+		next = c->next;
+		Free(c->data);
+		Free(c);
+	}
+	Free(arena);
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Allocate \c n elements of size \c size from the arena. The storage is zero'ed (like \c Calloc()), and aligned to 16 bytes.
+*/
+void *GMRFLib_arena_alloc(GMRFLib_arena_tp * arena, size_t n, size_t size)
+{
+	size_t len, off;
+	void *p;
+
+	len = n * size;
+	len = (len + GMRFLib_ARENA_ALIGN - 1) & ~((size_t) GMRFLib_ARENA_ALIGN - 1);
+	if (len == 0) {
+		len = GMRFLib_ARENA_ALIGN;
+	}
+
+	off = arena->cur->used;
+	if (off + len > arena->cur->size) {
+		/*
+		 * move on to the next chunk if its large enough, otherwise insert a new one after the current one 
+		 */
+		GMRFLib_arena_chunk_tp *c = arena->cur->next;
+
+		if (!c || c->size < len) {
+			c = GMRFLib_arena_new_chunk(len > arena->chunk_size ? len : arena->chunk_size);
+			c->next = arena->cur->next;
+			arena->cur->next = c;
+		}
+		c->used = 0;
+		arena->cur = c;
+		off = 0;
+	}
+
+	p = (void *) (arena->cur->data + off);
+	arena->cur->used = off + len;
+	memset(p, 0, n * size);
+
+	return p;
+}
+
+/*!
+  \brief Store the current position of the arena in \c mark.
+*/
+int GMRFLib_arena_mark(GMRFLib_arena_tp * arena, GMRFLib_arena_mark_tp * mark)
+{
+	mark->chunk = arena->cur;
+	mark->used = arena->cur->used;
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Release all storage allocated from the arena after \c mark was set.
+*/
+int GMRFLib_arena_release(GMRFLib_arena_tp * arena, GMRFLib_arena_mark_tp * mark)
+{
+	arena->cur = mark->chunk;
+	arena->cur->used = mark->used;
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Release all storage allocated from the arena. The chunks are kept for reuse.
+*/
+int GMRFLib_arena_reset(GMRFLib_arena_tp * arena)
+{
+	if (arena) {
+		arena->cur = arena->head;
+		arena->cur->used = 0;
+	}
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Return the total size of the chunks in the arena, in bytes.
+*/
+size_t GMRFLib_arena_size(GMRFLib_arena_tp * arena)
+{
+	size_t size = 0;
+	GMRFLib_arena_chunk_tp *c;
+
+	for (c = arena->head; c; c = c->next) {
+		size += c->size;
+	}
+	return size;
+}
@@ -0,0 +1,99 @@
+
+/* arena.h
+ * 
+ * Copyright (C) 2007 Havard Rue
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The author's contact information:
+ *
+ *       H{\aa}vard Rue
+ *       Department of Mathematical Sciences
+ *       The Norwegian University of Science and Technology
+ *       N-7491 Trondheim, Norway
+ *       Voice: +47-7359-3533    URL  : http://www.math.ntnu.no/~hrue  
+ *       Fax  : +47-7359-3524    Email: havard.rue@math.ntnu.no
+ *
+ */
+
+/*!
+  \file arena.h
+  \brief Typedefs and defines for the region (arena) allocator in \ref arena.c
+*/
+
+#ifndef __GMRFLib_ARENA_H__
+#define __GMRFLib_ARENA_H__
+
+#include <stddef.h>
+
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+#define __BEGIN_DECLS extern "C" {
+#define __END_DECLS }
+#else
+#define __BEGIN_DECLS					       /* empty */
+#define __END_DECLS					       /* empty */
+#endif
+
+__BEGIN_DECLS
+
+/*!
+  \brief The default size of each chunk in an arena (in bytes).
+*/
+#define GMRFLib_ARENA_CHUNK_SIZE (1024*1024)
+
+/*!
+  \brief Allocate and zero \c n elements of type \c type from \c arena.
+*/
+#define Arena_Calloc(arena, n, type) ((type *) GMRFLib_arena_alloc(arena, (size_t) (n), sizeof(type)))
+
+typedef struct GMRFLib_arena_chunk_struct {
+	struct GMRFLib_arena_chunk_struct *next;
+	size_t size;					       /* size of data */
+	size_t used;					       /* bytes in use */
+	char *data;
+} GMRFLib_arena_chunk_tp;
+
+/*!
+  \brief An arena is a list of chunks, where memory is allocated by advancing a pointer. Memory is never free'd
+  individually, but all of it at once with \c GMRFLib_arena_reset(), or back to a mark with \c GMRFLib_arena_release().
+  The chunks are kept for reuse. An arena must only be used by one thread at the time.
+*/
+typedef struct {
+	GMRFLib_arena_chunk_tp *head;			       /* the first chunk */
+	GMRFLib_arena_chunk_tp *cur;			       /* the chunk we allocate from */
+	size_t chunk_size;				       /* default size of new chunks */
+} GMRFLib_arena_tp;
+
+/*!
+  \brief A position in an arena, see \c GMRFLib_arena_mark() 
+*/
+typedef struct {
+	GMRFLib_arena_chunk_tp *chunk;
+	size_t used;
+} GMRFLib_arena_mark_tp;
+
+GMRFLib_arena_tp *GMRFLib_arena_create(size_t chunk_size);
+GMRFLib_arena_tp *GMRFLib_arena_thread(void);
+int GMRFLib_arena_free(GMRFLib_arena_tp * arena);
+int GMRFLib_arena_mark(GMRFLib_arena_tp * arena, GMRFLib_arena_mark_tp * mark);
+int GMRFLib_arena_release(GMRFLib_arena_tp * arena, GMRFLib_arena_mark_tp * mark);
+int GMRFLib_arena_reset(GMRFLib_arena_tp * arena);
+size_t GMRFLib_arena_size(GMRFLib_arena_tp * arena);
+void *GMRFLib_arena_alloc(GMRFLib_arena_tp * arena, size_t n, size_t size);
+
+__END_DECLS
+#endif
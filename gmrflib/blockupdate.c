@@ -113,6 +113,20 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 #include "GMRFLib/GMRFLib.h"
 #include "GMRFLib/GMRFLibP.h"
 
+/*
+ * the registered batch-version of the log-likelihood, see GMRFLib_set_logl_batch()
+ */
+static GMRFLib_logl_tp *logl_batch_scalar = NULL;
+static GMRFLib_logl_batch_tp *logl_batch = NULL;
+
+/*
+ * the registered grouping of the log-likelihood, see GMRFLib_set_logl_group()
+ */
+static GMRFLib_logl_tp *logl_group_scalar = NULL;
+static int *logl_group = NULL;
+static int logl_group_n = 0;
+static int logl_group_ngroups = 0;
+
 /*!
 
   \brief Create a \c GMRFLib_blockupdate_param_tp -object holding the default values.  \param[out]
@@ -1286,6 +1300,154 @@ int GMRFLib_2order_approx_core(double *a, double *b, double *c, double x0, int i
 
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_set_logl_batch(GMRFLib_logl_tp * loglFunc, GMRFLib_logl_batch_tp * loglFunc_batch)
+{
+	/*
+	 * register 'loglFunc_batch' as the batch-version of 'loglFunc'. Only one pair is kept, and loglFunc_batch = NULL removes it.
+	 */
+	logl_batch_scalar = (loglFunc_batch ? loglFunc : NULL);
+	logl_batch = loglFunc_batch;
+
+	return GMRFLib_SUCCESS;
+}
+GMRFLib_logl_batch_tp *GMRFLib_get_logl_batch(GMRFLib_logl_tp * loglFunc)
+{
+	return ((loglFunc && loglFunc == logl_batch_scalar) ? logl_batch : NULL);
+}
+int GMRFLib_set_logl_group(GMRFLib_logl_tp * loglFunc, int *group, int n_group, int ngroups)
+{
+	/*
+	 * register the grouping of the observations for 'loglFunc': node i < n_group is in group[i], in the range 0,...,ngroups-1,
+	 * and the remaining nodes are in group 'ngroups'. the table is computed once by the caller and is not copied. Only one
+	 * grouping is kept, and group = NULL removes it. with one group only, there is nothing to do and nothing is registered.
+	 */
+	if (group && ngroups > 1) {
+		logl_group_scalar = loglFunc;
+		logl_group = group;
+		logl_group_n = n_group;
+		logl_group_ngroups = ngroups;
+	} else {
+		logl_group_scalar = NULL;
+		logl_group = NULL;
+		logl_group_n = logl_group_ngroups = 0;
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_logl_group_active(GMRFLib_logl_tp * loglFunc)
+{
+	return (loglFunc && loglFunc == logl_group_scalar);
+}
+int GMRFLib_logl_group_order(int *order, int n, int *idx, GMRFLib_logl_tp * loglFunc)
+{
+	/*
+	 * return in order[0],...,order[n-1] the positions of idx[] so that idx[order[0]], idx[order[1]], ..., comes in contiguous
+	 * runs of the same group, and in their original order within each group. if there is no grouping registered for
+	 * loglFunc, then this is the identity.
+	 */
+	int k, g, *count = NULL;
+
+	if (!GMRFLib_logl_group_active(loglFunc) || n <= 1) {
+		for (k = 0; k < n; k++) {
+			order[k] = k;
+		}
+		return GMRFLib_SUCCESS;
+	}
+
+	/*
+	 * stable counting sort 
+	 */
+	count = Calloc(logl_group_ngroups + 2, int);
+	for (k = 0; k < n; k++) {
+		g = (idx[k] < logl_group_n ? logl_group[idx[k]] : logl_group_ngroups);
+		count[g + 1]++;
+	}
+	for (k = 0; k < logl_group_ngroups + 1; k++) {
+		count[k + 1] += count[k];
+	}
+	for (k = 0; k < n; k++) {
+		g = (idx[k] < logl_group_n ? logl_group[idx[k]] : logl_group_ngroups);
+		order[count[g]++] = k;
+	}
+	Free(count);
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_2order_approx_batch(double *a, double *b, double *c, double *d, int n, int *idx,
+				double *x_vec, GMRFLib_logl_tp * loglFunc, void *loglFunc_arg, double *step_len, int *stencil)
+{
+	/*
+	 * as GMRFLib_2order_approx() for the nodes idx[0],...,idx[n-1], expanding around x_vec[idx[k]], with weights d[idx[k]]. the
+	 * results are stored in a[k], b[k] and c[k], any of which can be NULL.
+	 *
+	 * if a batch-version of loglFunc is registered, the nodes are passed to it in chunks, and only those not done are
+	 * computed with the scalar version. otherwise, this is the same as calling GMRFLib_2order_approx() for each node.
+	 *
+	 * with a batch-version, the nodes are visited in the order given by GMRFLib_logl_group_order(), so that each chunk contains
+	 * long runs of the same likelihood. the results are stored in the original positions.
+	 */
+	int i, id = GMRFLib_thread_id, nchunk, *order = NULL;
+	GMRFLib_logl_batch_tp *batch = GMRFLib_get_logl_batch(loglFunc);
+
+	if (!batch) {
+#pragma omp parallel for private(i) schedule(static)
+		for (i = 0; i < n; i++) {
+			int ii = idx[i];
+
+			GMRFLib_thread_id = id;
+			GMRFLib_2order_approx((a ? &a[i] : NULL), (b ? &b[i] : NULL), (c ? &c[i] : NULL), d[ii], x_vec[ii], ii, x_vec,
+					      loglFunc, loglFunc_arg, step_len, stencil);
+		}
+		GMRFLib_thread_id = id;
+
+		return GMRFLib_SUCCESS;
+	}
+
+	order = Calloc(IMAX(1, n), int);
+	GMRFLib_logl_group_order(order, n, idx, loglFunc);
+
+	nchunk = (n + GMRFLib_LOGL_BATCH_CHUNK - 1) / GMRFLib_LOGL_BATCH_CHUNK;
+
+#pragma omp parallel for private(i) schedule(static)
+	for (i = 0; i < nchunk; i++) {
+		int k, ii, first = i * GMRFLib_LOGL_BATCH_CHUNK, len = IMIN(n - first, GMRFLib_LOGL_BATCH_CHUNK);
+		int cidx[GMRFLib_LOGL_BATCH_CHUNK], pos;
+		double x0[GMRFLib_LOGL_BATCH_CHUNK], f0[GMRFLib_LOGL_BATCH_CHUNK], df[GMRFLib_LOGL_BATCH_CHUNK],
+		    ddf[GMRFLib_LOGL_BATCH_CHUNK];
+		char done[GMRFLib_LOGL_BATCH_CHUNK];
+
+		GMRFLib_thread_id = id;
+		for (k = 0; k < len; k++) {
+			cidx[k] = idx[order[first + k]];
+			x0[k] = x_vec[cidx[k]];
+		}
+		memset(done, 0, len * sizeof(char));
+		batch(f0, df, ddf, done, len, cidx, x0, x_vec, loglFunc_arg);
+
+		for (k = 0; k < len; k++) {
+			pos = order[first + k];
+			ii = cidx[k];
+			if (ISZERO(d[ii])) {
+				f0[k] = df[k] = ddf[k] = 0.0;
+			} else if (!done[k]) {
+				GMRFLib_2order_approx_core(&f0[k], &df[k], &ddf[k], x0[k], ii, x_vec, loglFunc, loglFunc_arg, step_len, stencil);
+			}
+			if (a) {
+				a[pos] = d[ii] * (f0[k] - df[k] * x0[k] + 0.5 * ddf[k] * SQR(x0[k]));
+			}
+			if (b) {
+				b[pos] = d[ii] * (df[k] - x0[k] * ddf[k]);
+			}
+			if (c) {
+				c[pos] = -d[ii] * ddf[k];
+			}
+		}
+	}
+	GMRFLib_thread_id = id;
+	Free(order);
+
+	return GMRFLib_SUCCESS;
+}
 
 /*!
   \brief  Generate a blockproposal for a GMRF conditioned on (possible) non-Gaussian
@@ -66,6 +66,11 @@ __BEGIN_DECLS
 */
 #define GMRFLib_MODEOPTION_CURRENT 1
 
+/*!
+  \brief The number of observations passed to the batch-version of the log-likelihood in each call
+*/
+#define GMRFLib_LOGL_BATCH_CHUNK 512
+
 /*!
   \struct GMRFLib_blockupdate_param_tp blockupdate.h
   \brief Holding information on how to set up the block-sampling algorithm and the optimizer used to
@@ -120,6 +125,13 @@ int GMRFLib_2order_taylor(double *a, double *b, double *c, double d, double x0,
 			  double *x_vec, GMRFLib_logl_tp * loglFunc, void *loglFunc_arg, double *step_len);
 int GMRFLib_2order_approx_core(double *a, double *b, double *c, double x0, int indx,
 			       double *x_vec, GMRFLib_logl_tp * loglFunc, void *loglFunc_arg, double *step_len, int *stencil);
+int GMRFLib_2order_approx_batch(double *a, double *b, double *c, double *d, int n, int *idx,
+				double *x_vec, GMRFLib_logl_tp * loglFunc, void *loglFunc_arg, double *step_len, int *stencil);
+int GMRFLib_set_logl_batch(GMRFLib_logl_tp * loglFunc, GMRFLib_logl_batch_tp * loglFunc_batch);
+GMRFLib_logl_batch_tp *GMRFLib_get_logl_batch(GMRFLib_logl_tp * loglFunc);
+int GMRFLib_set_logl_group(GMRFLib_logl_tp * loglFunc, int *group, int n_group, int ngroups);
+int GMRFLib_logl_group_active(GMRFLib_logl_tp * loglFunc);
+int GMRFLib_logl_group_order(int *order, int n, int *idx, GMRFLib_logl_tp * loglFunc);
 int GMRFLib_blockupdate(double *laccept,
 			double *x_new, double *x_old,
 			double *b_new, double *b_old,
@@ -140,3 +140,57 @@ int GMRFLib_print_design(FILE * fp, GMRFLib_design_tp * design)
 
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_design_order(int *order, GMRFLib_design_tp * design)
+{
+	/*
+	 * return in 'order' an ordering of the experiments such that neighbouring experiments are close. This is a greedy
+	 * nearest-neighbour path, starting from the experiment closest to the center.
+	 */
+	int i, j, k, best;
+	double dist, best_dist;
+	char *used = NULL;
+
+	if (!design || design->nexperiments == 0) {
+		return GMRFLib_SUCCESS;
+	}
+
+	used = Calloc(design->nexperiments, char);
+	best = 0;
+	best_dist = DBL_MAX;
+	for (i = 0; i < design->nexperiments; i++) {
+		for (k = 0, dist = 0.0; k < design->nfactors; k++) {
+			dist += SQR(design->experiment[i][k]);
+		}
+		if (dist < best_dist) {
+			best_dist = dist;
+			best = i;
+		}
+	}
+
+	for (j = 0; j < design->nexperiments; j++) {
+		order[j] = best;
+		used[best] = 1;
+		if (j == design->nexperiments - 1) {
+			break;
+		}
+
+		int prev = best;
+
+		best = -1;
+		best_dist = DBL_MAX;
+		for (i = 0; i < design->nexperiments; i++) {
+			if (!used[i]) {
+				for (k = 0, dist = 0.0; k < design->nfactors; k++) {
+					dist += SQR(design->experiment[i][k] - design->experiment[prev][k]);
+				}
+				if (dist < best_dist) {
+					best_dist = dist;
+					best = i;
+				}
+			}
+		}
+	}
+	Free(used);
+
+	return GMRFLib_SUCCESS;
+}
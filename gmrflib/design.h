@@ -64,6 +64,7 @@ __BEGIN_DECLS typedef struct {
 int GMRFLib_get_design(GMRFLib_design_tp ** design, int nfactors);
 int GMRFLib_free_design(GMRFLib_design_tp * design);
 int GMRFLib_print_design(FILE * fp, GMRFLib_design_tp * design);
+int GMRFLib_design_order(int *order, GMRFLib_design_tp * design);
 
 __END_DECLS
 #endif
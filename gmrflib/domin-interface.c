@@ -173,6 +173,7 @@ int GMRFLib_domin_f_omp(double **x, int nx, double *f, int *ierr)
 		GMRFLib_ai_store_tp *ais = NULL;
 
 		GMRFLib_thread_id = omp_get_thread_num();
+		GMRFLib_openmp_nested_set_inner();
 		if (GMRFLib_thread_id == 0) {
 			ais = G.ai_store;
 		} else {
@@ -398,6 +399,7 @@ int GMRFLib_domin_gradf_intern(double *x, double *gradx, double *f0, int *ierr)
 			GMRFLib_ai_store_tp *ais = NULL;
 
 			GMRFLib_thread_id = omp_get_thread_num();
+			GMRFLib_openmp_nested_set_inner();
 			xx = Calloc(G.nhyper, double);
 			memcpy(xx, x, G.nhyper * sizeof(double));
 
@@ -459,6 +461,7 @@ int GMRFLib_domin_gradf_intern(double *x, double *gradx, double *f0, int *ierr)
 			j = (i < G.nhyper ? i : i - G.nhyper);
 
 			GMRFLib_thread_id = omp_get_thread_num();
+			GMRFLib_openmp_nested_set_inner();
 			xx = Calloc(G.nhyper, double);
 			memcpy(xx, x, G.nhyper * sizeof(double));
 
@@ -635,6 +638,7 @@ int GMRFLib_domin_estimate_hessian(double *hessian, double *x, double *log_dens_
 	double h = G.ai_par->hessian_finite_difference_step_len, f0, f0min, *f1 = NULL, *fm1 = NULL, f_best_save, **xx_hold, *xx_min;
 	int i, n = G.nhyper, tmax, id, ok = 0, debug = 0, len_xx_hold;
 
+	GMRFLib_ENTER_ROUTINE;
 	tmax = GMRFLib_MAX_THREADS;
 	id = omp_get_thread_num();
 	f1 = Calloc(n, double);
@@ -668,6 +672,7 @@ int GMRFLib_domin_estimate_hessian(double *hessian, double *x, double *log_dens_
 		}
 
 		GMRFLib_thread_id = omp_get_thread_num();
+		GMRFLib_openmp_nested_set_inner();
 		if (omp_in_parallel()) {
 			if (!ai_store[GMRFLib_thread_id]) {
 				ai_store[GMRFLib_thread_id] = GMRFLib_duplicate_ai_store(G.ai_store, GMRFLib_TRUE, GMRFLib_TRUE);
@@ -816,6 +821,7 @@ int GMRFLib_domin_estimate_hessian(double *hessian, double *x, double *log_dens_
 				}
 				
 				GMRFLib_thread_id = omp_get_thread_num();
+				GMRFLib_openmp_nested_set_inner();
 				if (omp_in_parallel()) {
 					if (!ai_store[GMRFLib_thread_id]) {
 						ai_store[GMRFLib_thread_id] = GMRFLib_duplicate_ai_store(G.ai_store, GMRFLib_TRUE, GMRFLib_TRUE);
@@ -869,6 +875,7 @@ int GMRFLib_domin_estimate_hessian(double *hessian, double *x, double *log_dens_
 	Free(ai_store);
 	GMRFLib_thread_id = id;
 
+	GMRFLib_LEAVE_ROUTINE;
 	return (ok ? GMRFLib_SUCCESS : !GMRFLib_SUCCESS);
 #undef F1
 #undef F2
@@ -66,7 +66,11 @@ const char GMRFLib_path[] = GMRFLib_PATH;
   This variable defines the which method is used to factorise the sparse matrices. The current
   implementation includes
   - #GMRFLib_SMTP_BAND, using the band-matrix routines in \c LAPACK
+  - #GMRFLib_SMTP_PROFILE, using the profile (envelope) Cholesky factorisation, which is preferable to the band-solver when the
+    bandwidth is small for most but not all of the rows.
   - #GMRFLib_SMTP_TAUCS, using the multifrontal supernodal factorisation in the \c TAUCS library.
+  - #GMRFLib_SMTP_TAUCS_OOC, using the out-of-core supernodal factorisation in the \c TAUCS library, for models where the
+    Cholesky triangle does not fit in memory. See also \c GMRFLib_ooc_dir and \c GMRFLib_ooc_memory.
 
   and its values are define in GMRFLib_smtp_tp.  Default value is #GMRFLib_SMTP_TAUCS.\n\n
 */
@@ -92,12 +96,43 @@ GMRFLib_smtp_tp GMRFLib_smtp = GMRFLib_SMTP_TAUCS;
   - #GMRFLib_REORDER_MMD, multiple minimum degree
 
   and its values are define in GMRFLib_reorder_tp.  The default choice, is #GMRFLib_REORDER_BAND if \c GMRFLib_smtp =
-  #GMRFLib_SMTP_BAND and #GMRFLib_REORDER_METIS if  \c GMRFLib_smtp = #GMRFLib_SMTP_TAUCS.\n\n
+  #GMRFLib_SMTP_BAND, the profile reducing version of it if \c GMRFLib_smtp = #GMRFLib_SMTP_PROFILE, and #GMRFLib_REORDER_METIS if  \c GMRFLib_smtp = #GMRFLib_SMTP_TAUCS.\n\n
 
   \sa The routine GMRFLib_optimise_reorder() chose the best reordering for a given graph.
 */
 GMRFLib_reorder_tp GMRFLib_reorder = GMRFLib_REORDER_DEFAULT;
 
+/*!
+  \brief The number of separators computed at each level of the nested dissection in #GMRFLib_REORDER_METIS.
+
+  METIS compute \c GMRFLib_metis_nseps different separators at each level and use the smallest one. Default is 3. This value
+  is also set by GMRFLib_optimize_reorder(), as it try several values.
+*/
+int GMRFLib_metis_nseps = 3;
+
+/*!
+  \brief Directory for the cache of optimal reorderings.
+
+  If non-NULL, then GMRFLib_optimize_reorder() store its choice in this directory, in a file named after a hash of the graph,
+  and read it back the next time it is called for the same graph, instead of searching again. For large graphs, the
+  reordering itself and the symbolic factorisation (TAUCS) are also stored here and reused. Default is NULL (no cache).
+*/
+char *GMRFLib_reorder_cache_dir = NULL;
+
+/*!
+  \brief Directory for the factorisation on disk when \c GMRFLib_smtp = #GMRFLib_SMTP_TAUCS_OOC.
+
+  If NULL, then the directory in the environment variable \c TMPDIR is used, or \c /tmp. The files are removed when the
+  factorisation is free'd. Default is NULL.
+*/
+char *GMRFLib_ooc_dir = NULL;
+
+/*!
+  \brief The memory (in bytes) the out-of-core factorisation can use, when \c GMRFLib_smtp = #GMRFLib_SMTP_TAUCS_OOC. Default is
+  1Gb.
+*/
+double GMRFLib_ooc_memory = 1073741824.0;
+
 /*! 
   \brief Set the blas level in the Lapack routines using the band solver.
 
@@ -125,6 +125,10 @@ extern int GMRFLib_blas_level;
 extern int GMRFLib_collect_timer_statistics;
 extern GMRFLib_smtp_tp GMRFLib_smtp;
 extern GMRFLib_reorder_tp GMRFLib_reorder;
+extern int GMRFLib_metis_nseps;
+extern char *GMRFLib_reorder_cache_dir;
+extern char *GMRFLib_ooc_dir;
+extern double GMRFLib_ooc_memory;
 extern int GMRFLib_use_wa_table_lookup;
 extern int GMRFLib_verify_graph_read_from_disc;
 
@@ -483,40 +483,39 @@ int GMRFLib_ged_build(GMRFLib_graph_tp ** graph, GMRFLib_ged_tp * ged)
 	}
 
 	/*
-	 * make the nbs-array 
+	 * make the nbs-array, directly in the contiguous memory-layout used by GMRFLib_copy_graph(). as the mapping is
+	 * increasing, the order of the nodes is the same in the new graph.
 	 */
+	int m = 0, *hold = NULL;
 	for (i = 0; i < n; i++) {
+		m += nnbs[i];
+	}
+	hold = (m ? Calloc(m, int) : NULL);
+	for (i = m = 0; i < n; i++) {
 		if (nnbs[i]) {
-			nbs[i] = Calloc(nnbs[i], int);
-
+			nbs[i] = &hold[m];
+			m += nnbs[i];
 			for (j = 0, iptr = NULL; (iptr = map_ii_nextptr(hash[i], iptr)) != NULL;) {
-				nbs[i][j++] = iptr->key;
+				nbs[i][j++] = map[iptr->key];  /* map to the new nodes */
 			}
 		}
 	}
 
 	/*
-	 * make the graph-object. copy it into a new one to make the correct memory-layout 
+	 * make the graph-object
 	 */
 	for (i = 0; i < n_new; i++) {
 		nnbs[i] = nnbs[imap[i]];		       /* ok, as imap[i] >= i */
 		nbs[i] = nbs[imap[i]];			       /* ok, as imap[i] >= i */
 	}
 
-	for (i = 0; i < n_new; i++) {
-		for (jj = 0; jj < nnbs[i]; jj++) {
-			nbs[i][jj] = map[nbs[i][jj]];	       /* map to the new nodes */
-		}
-	}
-
 	GMRFLib_make_empty_graph(&g);
 	g->n = n_new;
-	g->nnbs = nnbs;
-	g->nbs = nbs;
-	g->mothergraph_idx = imap;			       /* preserve the mapping */
-
-	GMRFLib_copy_graph(graph, g);
-	GMRFLib_prepare_graph(*graph);
+	g->nnbs = Realloc(nnbs, IMAX(1, n_new), int);
+	g->nbs = Realloc(nbs, IMAX(1, n_new), int *);
+	g->mothergraph_idx = Realloc(imap, IMAX(1, n_new), int);	/* preserve the mapping */
+	GMRFLib_prepare_graph(g);
+	*graph = g;
 
 	if (0) {
 		/*
@@ -529,15 +528,8 @@ int GMRFLib_ged_build(GMRFLib_graph_tp ** graph, GMRFLib_ged_tp * ged)
 	/*
 	 * cleanup 
 	 */
-	for (i = 0; i < n_new; i++) {
-		Free(nbs[i]);
-	}
-	Free(nbs);
-	Free(nnbs);
 	Free(node_in_use);
 	Free(map);
-	Free(imap);
-	Free(g);
 	Free(indep);
 
 	for (i = 0; i < n; i++) {
@@ -451,17 +451,26 @@ int GMRFLib_read_graph_binary(GMRFLib_graph_tp ** graph, const char *filename)
 	GMRFLib_EWRAP0(GMRFLib_io_read(io, (void *) &(g->n), sizeof(int)));
 	GMRFLib_ASSERT(g->n >= 0, GMRFLib_EPARAMETER);
 
-	g->nnbs = Calloc(g->n + 1, int);		       /* yes. */
-	g->nbs = Calloc(g->n + 1, int *);		       /* yes. */
+	/*
+	 * the nodes are read into one buffer in the order they appear in the file, and then moved into the contiguous layout
+	 * (as in GMRFLib_copy_graph()) when we know if the graph is 0-based or 1-based. nodes are 0,...,n, to allow for both.
+	 */
+	int *nnbs = Calloc(g->n + 1, int), *offset = Calloc(g->n + 1, int), *buf = NULL, nbuf = 0, nbuf_max = 0, shift, m;
+	char *is_read = Calloc(g->n + 1, char);
 
 	for (i = 0; i < g->n; i++) {
 		GMRFLib_io_read(io, (void *) &ii, sizeof(int));
-		GMRFLib_io_read(io, (void *) &(g->nnbs[ii]), sizeof(int));
-		if (g->nnbs[ii]) {
-			g->nbs[ii] = Calloc(g->nnbs[ii], int);
-			GMRFLib_io_read(io, (void *) (g->nbs[ii]), (unsigned int) (g->nnbs[ii] * sizeof(int)));
-		} else {
-			g->nbs[ii] = Calloc(1, int);	       /* so we can check if this is read */
+		GMRFLib_ASSERT(LEGAL(ii, g->n + 1), GMRFLib_EPARAMETER);
+		GMRFLib_io_read(io, (void *) &(nnbs[ii]), sizeof(int));
+		is_read[ii] = 1;
+		offset[ii] = nbuf;
+		if (nnbs[ii]) {
+			if (nbuf + nnbs[ii] > nbuf_max) {
+				nbuf_max = IMAX(2 * nbuf_max, nbuf + nnbs[ii]);
+				buf = Realloc(buf, nbuf_max, int);
+			}
+			GMRFLib_io_read(io, (void *) &buf[nbuf], (unsigned int) (nnbs[ii] * sizeof(int)));
+			nbuf += nnbs[ii];
 		}
 	}
 	GMRFLib_io_close(io);
@@ -472,12 +481,12 @@ int GMRFLib_read_graph_binary(GMRFLib_graph_tp ** graph, const char *filename)
 	int min_node = g->n + 1, max_node = -1;
 
 	for (i = 0; i < g->n + 1; i++) {
-		if (g->nbs[i]) {			       /* yes, we check the ptr if this is read or not */
+		if (is_read[i]) {
 			min_node = IMIN(min_node, i);
 			max_node = IMAX(max_node, i);
 
-			for (j = 0; j < g->nnbs[i]; j++) {
-				idx = g->nbs[i][j];
+			for (j = 0; j < nnbs[i]; j++) {
+				idx = buf[offset[i] + j];
 				min_node = IMIN(min_node, idx);
 				max_node = IMAX(max_node, idx);
 			}
@@ -488,32 +497,37 @@ int GMRFLib_read_graph_binary(GMRFLib_graph_tp ** graph, const char *filename)
 		/*
 		 * convert to 0-based graph 
 		 */
-		Free(g->nbs[0]);
-		for (i = 0; i < g->n; i++) {
-			g->nnbs[i] = g->nnbs[i + 1];
-			g->nbs[i] = g->nbs[i + 1];
-			g->nbs[i + 1] = NULL;
-			for (j = 0; j < g->nnbs[i]; j++)
-				g->nbs[i][j]--;
-		}
+		shift = 1;
 	} else if (min_node == 0 && max_node == g->n - 1) {
 		/*
 		 * ok 
 		 */
+		shift = 0;
 	} else {
 		fprintf(stderr, "\n\nmin_node = %1d max_node = %1d. this should not happen.\n", min_node, max_node);
 		GMRFLib_ERROR(GMRFLib_ESNH);
 	}
 
+	g->nnbs = Calloc(g->n, int);
+	g->nbs = Calloc(g->n, int *);
+	int *hold = (nbuf ? Calloc(nbuf, int) : NULL);
+	for (i = m = 0; i < g->n; i++) {
+		g->nnbs[i] = nnbs[i + shift];
+		if (g->nnbs[i]) {
+			g->nbs[i] = &hold[m];
+			for (j = 0; j < g->nnbs[i]; j++) {
+				g->nbs[i][j] = buf[offset[i + shift] + j] - shift;
+			}
+			m += g->nnbs[i];
+		}
+	}
 	GMRFLib_EWRAP0(GMRFLib_prepare_graph(g));
-	GMRFLib_EWRAP0(GMRFLib_copy_graph(graph, g));
+	*graph = g;
 
-	for (i = 0; i < g->n + 1; i++) {		       /* yes, its +1 */
-		Free(g->nbs[i]);
-	}
-	Free(g->nbs);
-	Free(g->nnbs);
-	Free(g);
+	Free(nnbs);
+	Free(offset);
+	Free(buf);
+	Free(is_read);
 
 	return GMRFLib_SUCCESS;
 }
@@ -535,12 +549,26 @@ int GMRFLib_free_graph(GMRFLib_graph_tp * graph)
 	/*
 	 * free a graph build with ``GMRFLib_read_graph'' 
 	 */
-	int i;
+	int i, shared = 0;
 
 	if (!graph) {
 		return GMRFLib_SUCCESS;
 	}
 
+	/*
+	 * if the graph is shared, then just drop this reference
+	 */
+#pragma omp critical (GMRFLib_nref)
+	{
+		if (graph->nref > 0) {
+			graph->nref--;
+			shared = 1;
+		}
+	}
+	if (shared) {
+		return GMRFLib_SUCCESS;
+	}
+
 	for (i = 0; i < graph->n; i++) {
 		if (graph->nnbs[i]) {
 			Free(graph->nbs[i]);
@@ -636,15 +664,18 @@ int GMRFLib_printbits(FILE * fp, GMRFLib_uchar c)
 int GMRFLib_is_neighb(int node, int nnode, GMRFLib_graph_tp * graph)
 {
 	/*
-	 * plain version.  return 1 if nnode is a neighbour of node, otherwise 0. assume that the nodes are sorted. (if node == 
-	 * nnode, then they are not neighbours.)
+	 * return 1 if nnode is a neighbour of node, otherwise 0. assume that the nodes are sorted. (if node == nnode, then they
+	 * are not neighbours.)
 	 * 
 	 * Sat Nov 22 12:43:09 CET 2003 : I compared this version agains a hash-table variant, both using spmatrix and map_ii
 	 * for each i. the last version was slower by a factor 2, the other even slower. it seems like this plain version is
 	 * quite fast though... 
+	 *
+	 * The linear scan is now replaced by a branchless binary search, which is O(log(nnbs)) and does not depend on
+	 * branch-prediction, as this function is used in the Qfunctions.
 	 */
 
-	int j, m, k;
+	int m, half, *base;
 
 	/*
 	 * make this extention to ease its use 
@@ -653,21 +684,18 @@ int GMRFLib_is_neighb(int node, int nnode, GMRFLib_graph_tp * graph)
 		return GMRFLib_FALSE;
 
 	m = graph->nnbs[node];
-
-	if (!m || nnode < graph->nbs[node][0] || nnode > graph->nbs[node][m - 1]) {
+	if (!m) {
 		return GMRFLib_FALSE;
 	}
 
-	for (j = 0; j < m; j++) {
-		k = graph->nbs[node][j];
-		if (k > nnode) {
-			return GMRFLib_FALSE;
-		}
-		if (k == nnode) {
-			return GMRFLib_TRUE;
-		}
+	base = graph->nbs[node];
+	while (m > 1) {
+		half = m / 2;
+		base = (base[half] <= nnode ? base + half : base);
+		m -= half;
 	}
-	return GMRFLib_FALSE;
+
+	return (*base == nnode ? GMRFLib_TRUE : GMRFLib_FALSE);
 }
 
 /*!
@@ -976,6 +1004,23 @@ int GMRFLib_copy_graph(GMRFLib_graph_tp ** graph_new, GMRFLib_graph_tp * graph_o
 	return GMRFLib_SUCCESS;
 }
 
+/*!
+  \brief Return a new reference to a graph, which must not be changed afterwards.
+
+  This is an alternative to GMRFLib_copy_graph() for graphs that are only read. Each reference is released with
+  GMRFLib_free_graph(), and the graph is free'd with the last one.
+ */
+GMRFLib_graph_tp *GMRFLib_share_graph(GMRFLib_graph_tp * graph)
+{
+	if (graph) {
+#pragma omp critical (GMRFLib_nref)
+		{
+			graph->nref++;
+		}
+	}
+	return graph;
+}
+
 GMRFLib_sizeof_tp GMRFLib_sizeof_graph(GMRFLib_graph_tp * graph)
 {
 	/*
@@ -2046,6 +2091,44 @@ int GMRFLib_connected_components_do(int node, GMRFLib_graph_tp * g, int *cc, cha
 	return GMRFLib_SUCCESS;
 }
 
+/*!
+  \brief Return a 64-bit hash (FNV-1a) of the structure of the graph
+
+  The hash depends only on the number of nodes and the lists of neighbours, so two graphs with the same structure have the
+  same hash.
+*/
+unsigned long int GMRFLib_graph_hash(GMRFLib_graph_tp * graph)
+{
+#define HASH_INT(_v)							\
+	{								\
+		unsigned int _u = (unsigned int) (_v);			\
+		int _b;							\
+		for (_b = 0; _b < 4; _b++) {				\
+			h ^= (uint64_t) (_u & 0xffU);			\
+			h *= (uint64_t) 1099511628211ULL;		\
+			_u >>= 8;					\
+		}							\
+	}
+
+	uint64_t h = (uint64_t) 14695981039346656037ULL;
+	int i, j;
+
+	if (!graph) {
+		return (unsigned long int) h;
+	}
+
+	HASH_INT(graph->n);
+	for (i = 0; i < graph->n; i++) {
+		HASH_INT(graph->nnbs[i]);
+		for (j = 0; j < graph->nnbs[i]; j++) {
+			HASH_INT(graph->nbs[i][j]);
+		}
+	}
+#undef HASH_INT
+
+	return (unsigned long int) h;
+}
+
 
 /*
   Example for manual
@@ -127,6 +127,10 @@ typedef struct {
 	 * 
 	 * A length \em n array of arrays, where <em>nbs[i][j]</em> contains the node numbers <em>j; j = 0,..., nnbs[j]-1</em>
 	 * for the neighbours of node \em i. \n\n 
+	 *
+	 * For graphs generated by the library, the neighbours are stored in one contiguous block in the order of the nodes,
+	 * and <em>nbs[i]</em> points into it (or is \c NULL if <em>nnbs[i]</em> is zero); only the first non-empty <em>nbs[i]</em>
+	 * is to be free'd. The neighbours are sorted in increasing order. \n\n
 	 */
 	int **nbs;
 
@@ -137,6 +141,13 @@ typedef struct {
 	 * graph. \n\n 
 	 */
 	int *mothergraph_idx;
+
+	/**
+	 *  \brief For internal use only: the number of additional users of this (read-only) graph
+	 *
+	 * Set by GMRFLib_share_graph(). GMRFLib_free_graph() only decrease this counter while it is positive. \n\n
+	 */
+	int nref;
 } GMRFLib_graph_tp;
 
 typedef struct {
@@ -205,6 +216,8 @@ GMRFLib_sizeof_tp GMRFLib_sizeof_graph(GMRFLib_graph_tp * graph);
 
 int *GMRFLib_connected_components(GMRFLib_graph_tp * g);
 int GMRFLib_connected_components_do(int node, GMRFLib_graph_tp * g, int *cc, char *visited, int *ccc);
+unsigned long int GMRFLib_graph_hash(GMRFLib_graph_tp * graph);
+GMRFLib_graph_tp *GMRFLib_share_graph(GMRFLib_graph_tp * graph);
 
 __END_DECLS
 #endif
@@ -69,6 +69,7 @@ int dpbtf2_(const char *, int *, int *, double *, int *, int *, int);
 int dpotrf_(const char *, int *, double *, int *, int *, int);
 int dpotf2_(const char *, int *, double *, int *, int *, int);
 int dtbsv_(const char *, const char *, const char *, int *, int *, double *, int *, double *, int *, int, int, int);
+int dtbtrs_(const char *, const char *, const char *, int *, int *, int *, double *, int *, double *, int *, int *, int, int, int);
 int dpotri_(const char *, int *, double *, int *, int *, int);
 int dgemm_(const char *, const char *, int *, int *, int *, double *, double *, int *, double *, int
 	   *, double *, double *, int *, int, int);
@@ -39,8 +39,10 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 #include <malloc.h>
 #endif
 #include <stdlib.h>
+#include <float.h>
 
 #include "GMRFLib/GMRFLib.h"
+#include "GMRFLib/GMRFLibP.h"
 
 /**
  *  \file openmp.c
@@ -125,6 +127,44 @@ int GMRFLib_openmp_implement_strategy(GMRFLib_openmp_place_tp place, void *arg)
 	int nested = -1;
 	int *nhyper = (int *) arg;
 
+	if (strategy == GMRFLib_OPENMP_STRATEGY_NESTED) {
+		/*
+		 * two levels: split the threads between the independent evaluations (outer) and the work within each (inner), at
+		 * the places where the number of evaluations is known. elsewhere, use the LARGE strategy.
+		 */
+		int nwork = -1, nouter, ninner;
+
+		switch (place) {
+		case GMRFLib_OPENMP_PLACES_OPTIMIZE:
+			nwork = (nhyper ? 2 * *nhyper + 1 : -1);
+			break;
+		case GMRFLib_OPENMP_PLACES_INTEGRATE:
+			/*
+			 * here 'arg' is the number of configurations, or marginals, to compute
+			 */
+			nwork = (arg ? *((int *) arg) : -1);
+			break;
+		case GMRFLib_OPENMP_PLACES_HESSIAN:
+			nwork = (nhyper ? 2 * ISQR(*nhyper) + 1 : -1);
+			break;
+		default:
+			break;
+		}
+
+		if (nwork > 0) {
+			GMRFLib_openmp_nested_split(&nouter, &ninner, nwork);
+			omp_set_num_threads(nouter);
+			omp_set_nested(ninner > 1 ? 1 : 0);
+			GMRFLib_openmp->nested_outer = nouter;
+			GMRFLib_openmp->nested_inner = ninner;
+
+			return GMRFLib_SUCCESS;
+		}
+		GMRFLib_openmp->nested_outer = ntmax;
+		GMRFLib_openmp->nested_inner = 1;
+		strategy = GMRFLib_OPENMP_STRATEGY_LARGE;
+	}
+
 	switch (place) {
 	case GMRFLib_OPENMP_PLACES_BUILD_MODEL:
 		switch (strategy) {
@@ -321,3 +361,84 @@ int GMRFLib_openmp_implement_strategy(GMRFLib_openmp_place_tp place, void *arg)
 
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_openmp_nested_probe(GMRFLib_graph_tp * graph, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg)
+{
+	/*
+	 * for GMRFLib_OPENMP_STRATEGY_NESTED: measure the time for one factorisation of Q, made proper by adding its diagonal. this is
+	 * done only once. the first problem computes the reordering, the symbolic factorisation and the pattern of Q, and keeps them
+	 * in 'store', so only the second one, which builds Q and factorise it, is timed.
+	 */
+	int i, retval;
+	double *c = NULL, tref, t = DBL_EPSILON;
+	GMRFLib_problem_tp *problem = NULL;
+	GMRFLib_store_tp *store = NULL;
+	GMRFLib_error_handler_tp *old_handler = NULL;
+
+	if (!GMRFLib_openmp || GMRFLib_openmp->strategy != GMRFLib_OPENMP_STRATEGY_NESTED || GMRFLib_openmp->nested_fact_time > 0.0 || !graph) {
+		return GMRFLib_SUCCESS;
+	}
+
+	c = Calloc(graph->n, double);
+	for (i = 0; i < graph->n; i++) {
+		c[i] = DMAX(1.0, ABS(Qfunc(i, i, Qfunc_arg)));
+	}
+	store = Calloc(1, GMRFLib_store_tp);
+
+	old_handler = GMRFLib_set_error_handler_off();
+	retval = GMRFLib_init_problem_store(&problem, NULL, NULL, c, NULL, graph, Qfunc, Qfunc_arg, NULL, NULL, GMRFLib_NEW_PROBLEM, store);
+	GMRFLib_free_problem(problem);			       /* also if it is only partly initialised */
+	problem = NULL;
+	if (retval == GMRFLib_SUCCESS) {
+		tref = GMRFLib_cpu();
+		retval = GMRFLib_init_problem_store(&problem, NULL, NULL, c, NULL, graph, Qfunc, Qfunc_arg, NULL, NULL, GMRFLib_NEW_PROBLEM, store);
+		t = DMAX(DBL_EPSILON, GMRFLib_cpu() - tref);
+		GMRFLib_free_problem(problem);
+	}
+	GMRFLib_set_error_handler(old_handler);
+
+	/*
+	 * if the factorisation failed, the time is DBL_EPSILON, so no inner threads are used and we do not try again
+	 */
+	GMRFLib_openmp->nested_fact_time = t;
+
+	GMRFLib_free_store(store);
+	Free(c);
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_openmp_nested_split(int *nouter, int *ninner, int nwork)
+{
+	/*
+	 * split the threads into 'nouter' outer threads, each using 'ninner' inner threads, for 'nwork' independent evaluations. the
+	 * outer level is always filled first; inner threads are only used for the threads left over, and only if the
+	 * factorisation is expensive enough to gain from them.
+	 */
+	int ntmax = GMRFLib_MAX_THREADS, inner_max;
+	double t = (GMRFLib_openmp ? GMRFLib_openmp->nested_fact_time : 0.0);
+
+	if (t < 0.01) {
+		inner_max = 1;
+	} else if (t < 0.1) {
+		inner_max = 2;
+	} else if (t < 1.0) {
+		inner_max = 4;
+	} else {
+		inner_max = 8;
+	}
+
+	*nouter = IMAX(1, IMIN(nwork, ntmax));
+	*ninner = IMAX(1, IMIN(inner_max, ntmax / *nouter));
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_openmp_nested_set_inner(void)
+{
+	/*
+	 * to be called by each outer thread, so that the parallel regions it starts use the inner number of threads
+	 */
+	if (GMRFLib_openmp && GMRFLib_openmp->strategy == GMRFLib_OPENMP_STRATEGY_NESTED && omp_in_parallel()) {
+		omp_set_num_threads(IMAX(1, GMRFLib_openmp->nested_inner));
+	}
+
+	return GMRFLib_SUCCESS;
+}
@@ -73,7 +73,8 @@ typedef enum {
 	GMRFLib_OPENMP_STRATEGY_MEDIUM,
 	GMRFLib_OPENMP_STRATEGY_LARGE,
 	GMRFLib_OPENMP_STRATEGY_HUGE,
-	GMRFLib_OPENMP_STRATEGY_DEFAULT
+	GMRFLib_OPENMP_STRATEGY_DEFAULT,
+	GMRFLib_OPENMP_STRATEGY_NESTED
 } GMRFLib_openmp_strategy_tp;
 
 typedef enum {
@@ -90,11 +91,22 @@ typedef enum {
 typedef struct {
 	int max_threads;
 	GMRFLib_openmp_strategy_tp strategy;
+
+	/*
+	 * for GMRFLib_OPENMP_STRATEGY_NESTED: the current number of outer and inner threads, and the cpu-time for one factorisation
+	 * (0 if not yet measured)
+	 */
+	int nested_outer;
+	int nested_inner;
+	double nested_fact_time;
 } GMRFLib_openmp_tp;
 
 #define GMRFLib_MAX_THREADS (GMRFLib_openmp ? GMRFLib_openmp->max_threads : omp_get_max_threads())
 
 int GMRFLib_openmp_implement_strategy(GMRFLib_openmp_place_tp place, void *arg);
+int GMRFLib_openmp_nested_probe(GMRFLib_graph_tp * graph, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg);
+int GMRFLib_openmp_nested_split(int *nouter, int *ninner, int nwork);
+int GMRFLib_openmp_nested_set_inner(void);
 
 __END_DECLS
 #endif
@@ -169,6 +169,18 @@ typedef int GMRFLib_logl_tp(double *logll, double *x_i, int m, int idx, double *
 #define GMRFLib_LOGL_COMPUTE_DERIVATIES_AND_CDF (135792468)
 #define GMRFLib_LOGL_COMPUTE_CDF (135792469)
 
+/*!
+  \brief Define the batch-version of the log-likelihood function
+
+  This is an optional companion to a \c GMRFLib_logl_tp -function, registered with GMRFLib_set_logl_batch(). It evaluates the
+  log-likelihood and its first and second derivative for the \c n observations \c idx[0],...,\c idx[n-1], at \c x0[0], ...,
+  \c x0[n-1], in one call, and store the result in \c f0[k], \c df[k] and \c ddf[k]. For each \c k that is computed, \c
+  done[k] must be set to 1; those with \c done[k] = 0 are computed using the scalar version.
+
+  \sa GMRFLib_logl_tp, GMRFLib_set_logl_batch, GMRFLib_2order_approx_batch
+*/
+typedef int GMRFLib_logl_batch_tp(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, double *x_vec, void *logl_arg);
+
 /*!
   \struct GMRFLib_optimize_param_tp optimize.h
   \brief To specify the options for the optimizer.
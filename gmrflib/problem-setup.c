@@ -55,6 +55,9 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 #include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <float.h>
+#include <limits.h>
+#include <unistd.h>
 
 #include "GMRFLib/GMRFLib.h"
 #include "GMRFLib/GMRFLibP.h"
@@ -291,9 +294,9 @@ int GMRFLib_init_problem_store(GMRFLib_problem_tp ** problem,
 
 		if (store_use_sub_graph) {
 			/*
-			 * copy from store 
+			 * the sub_graph in the store is read-only, so share it
 			 */
-			GMRFLib_copy_graph(&((*problem)->sub_graph), store->sub_graph);
+			(*problem)->sub_graph = GMRFLib_share_graph(store->sub_graph);
 		} else {
 			/*
 			 * compute it 
@@ -301,10 +304,10 @@ int GMRFLib_init_problem_store(GMRFLib_problem_tp ** problem,
 			GMRFLib_compute_subgraph(&((*problem)->sub_graph), graph, fixed_value);
 
 			/*
-			 * store a copy, if requested 
+			 * store a reference, if requested 
 			 */
 			if (store_store_sub_graph) {
-				GMRFLib_copy_graph(&(store->sub_graph), (*problem)->sub_graph);
+				store->sub_graph = GMRFLib_share_graph((*problem)->sub_graph);
 			}
 		}
 	}
@@ -341,6 +344,9 @@ int GMRFLib_init_problem_store(GMRFLib_problem_tp ** problem,
 			if (smtp == GMRFLib_SMTP_BAND) {
 				(*problem)->sub_sm_fact.bandwidth = store->bandwidth;
 			}
+			if (smtp == GMRFLib_SMTP_TAUCS || smtp == GMRFLib_SMTP_TAUCS_OOC) {
+				(*problem)->sub_sm_fact.Qpattern = GMRFLib_share_Qpattern_TAUCS(store->Qpattern);
+			}
 		} else {
 			/*
 			 * compute it 
@@ -548,6 +554,12 @@ int GMRFLib_init_problem_store(GMRFLib_problem_tp ** problem,
 		if (store_store_symb_fact) {
 			store->symb_fact = GMRFLib_my_taucs_supernodal_factor_matrix_duplicate((*problem)->sub_sm_fact.symb_fact);
 		}
+		if ((store_use_remap || store_store_remap) && !store->Qpattern && (smtp == GMRFLib_SMTP_TAUCS || smtp == GMRFLib_SMTP_TAUCS_OOC)) {
+			/*
+			 * the pattern follows the remap, so only store it if the problem uses the same remap as the store
+			 */
+			store->Qpattern = GMRFLib_share_Qpattern_TAUCS((*problem)->sub_sm_fact.Qpattern);
+		}
 	}
 
 	/*
@@ -714,21 +726,21 @@ int GMRFLib_init_problem_store(GMRFLib_problem_tp ** problem,
 						for (i = 0; i < sub_n; i++) {
 							(*problem)->qi_at_m[i + kk] = (*problem)->sub_constr->a_matrix[k + nc * i];
 						}
-						GMRFLib_solve_llt_sparse_matrix(&((*problem)->qi_at_m[kk]), &((*problem)->sub_sm_fact), (*problem)->sub_graph);
 					}
+					GMRFLib_solve_llt_sparse_matrix_nrhs((*problem)->qi_at_m, nc, &((*problem)->sub_sm_fact), (*problem)->sub_graph);
 				} else {
 					/*
 					 * reuse 
 					 */
 					memcpy((*problem)->qi_at_m, qi_at_m_store, (nc - 1) * sub_n * sizeof(double));
-#pragma omp parallel for private(k, kk, i)
 					for (k = nc - 2; k < nc; k++) {
 						kk = k * sub_n;
 						for (i = 0; i < sub_n; i++) {
 							(*problem)->qi_at_m[i + kk] = (*problem)->sub_constr->a_matrix[k + nc * i];
 						}
-						GMRFLib_solve_llt_sparse_matrix(&((*problem)->qi_at_m[kk]), &((*problem)->sub_sm_fact), (*problem)->sub_graph);
 					}
+					GMRFLib_solve_llt_sparse_matrix_nrhs(&((*problem)->qi_at_m[(nc - 2) * sub_n]), 2, &((*problem)->sub_sm_fact),
+									     (*problem)->sub_graph);
 					Free(qi_at_m_store);
 				}
 
@@ -1017,6 +1029,138 @@ int GMRFLib_sample(GMRFLib_problem_tp * problem)
 	return GMRFLib_SUCCESS;
 }
 
+/*!
+  \brief Generate \c ns samples at once.
+
+  This is the batch version of \c GMRFLib_sample(). The samples are returned in \a samples, which must be of length ns*n where n is
+  <tt>problem->n</tt>, so that sample \c k starts at <tt>samples[k*n]</tt>; the fixed values are copied into place as in \c
+  GMRFLib_sample(). If \a logdens is non-NULL, the log-density of sample \c k is returned in <tt>logdens[k]</tt>.
+
+  One seed is drawn from the built-in random number generator, and sample \c k use its own stream, \c
+  GMRFLib_rng_stream(seed, k). All L^T solves are done with one call to \c GMRFLib_solve_lt_sparse_matrix_nrhs(), and the
+  samples are generated, corrected for constraints and evaluated in parallel. The result depends only on the state of the random
+  number generator on entry, and not on the number of threads.
+
+  On exit, <tt>problem->sample</tt> and <tt>problem->sub_logdens</tt> hold the last sample and its log-density.
+
+  \sa GMRFLib_sample, GMRFLib_rng_stream
+*/
+int GMRFLib_sample_batch(GMRFLib_problem_tp * problem, int ns, double *samples, double *logdens)
+{
+	int k, n, sub_n, nc, id;
+	unsigned long int seed;
+	double *sub_samples = NULL, *sqrterm = NULL, *noise = NULL;
+
+	if (!problem || ns <= 0)
+		return GMRFLib_SUCCESS;
+	GMRFLib_ENTER_ROUTINE;
+
+	n = problem->n;
+	sub_n = problem->sub_graph->n;
+	nc = (problem->sub_constr ? problem->sub_constr->nc : 0);
+	seed = gsl_rng_get(GMRFLib_rng);
+	id = GMRFLib_thread_id;
+
+	sub_samples = Calloc((size_t) sub_n * ns, double);
+	sqrterm = Calloc(ns, double);
+	if (nc && STOCHASTIC_CONSTR(problem->sub_constr)) {
+		noise = Calloc((size_t) nc * ns, double);
+	}
+
+	/*
+	 * draw z for each sample from its own stream, including the noise for stochastic constraints
+	 */
+#pragma omp parallel for private(k) schedule(static)
+	for (k = 0; k < ns; k++) {
+		int i;
+		double z, *x = &sub_samples[(size_t) k * sub_n];
+		gsl_rng *r = GMRFLib_rng_stream(seed, (size_t) k);
+
+		GMRFLib_thread_id = id;
+		for (i = 0; i < sub_n; i++) {
+			z = gsl_ran_ugaussian(r);
+			sqrterm[k] += SQR(z);
+			x[i] = z;
+		}
+		if (noise) {
+			for (i = 0; i < nc; i++) {
+				noise[k * nc + i] = gsl_ran_ugaussian(r);
+			}
+		}
+		gsl_rng_free(r);
+	}
+	GMRFLib_thread_id = id;
+
+	/*
+	 * solve L^Tx=z for all samples 
+	 */
+	GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_nrhs(sub_samples, ns, &(problem->sub_sm_fact), problem->sub_graph));
+
+#pragma omp parallel for private(k) schedule(static)
+	for (k = 0; k < ns; k++) {
+		int i, inc = 1;
+		double *x = &sub_samples[(size_t) k * sub_n], *xx = &samples[(size_t) k * n], ldens;
+
+		GMRFLib_thread_id = id;
+		for (i = 0; i < sub_n; i++) {
+			x[i] += problem->sub_mean[i];
+		}
+
+		if (nc) {
+			double alpha, beta, *t_vector = Calloc(nc, double);
+
+			/*
+			 * t_vector = Ax-e, plus L*z for stochastic constraints. then sample := sample - cond_m*t_vector
+			 */
+			GMRFLib_eval_constr(t_vector, NULL, x, problem->sub_constr, problem->sub_graph);
+			if (noise) {
+				double *z = &noise[k * nc];
+
+				if (problem->sub_constr->errcov_diagonal) {
+					for (i = 0; i < nc; i++) {
+						t_vector[i] += problem->sub_constr->intern->chol[i] * z[i];
+					}
+				} else {
+					dtrmv_("L", "N", "N", &nc, problem->sub_constr->intern->chol, &nc, z, &inc, 1, 1, 1);
+					for (i = 0; i < nc; i++) {
+						t_vector[i] += z[i];
+					}
+				}
+			}
+			alpha = -1.0;
+			beta = 1.0;
+			dgemv_("N", &sub_n, &nc, &alpha, problem->constr_m, &sub_n, t_vector, &inc, &beta, x, &inc, 1);
+			Free(t_vector);
+
+			GMRFLib_evaluate_sub__intern(&ldens, x, problem);
+		} else {
+			ldens = -0.5 * sub_n * log(2.0 * M_PI) + problem->log_normc - 0.5 * sqrterm[k];
+		}
+
+		memcpy(xx, problem->sample, n * sizeof(double));	/* the fixed values */
+		for (i = 0; i < sub_n; i++) {
+			xx[problem->map[i]] = x[i];
+		}
+		if (logdens) {
+			logdens[k] = ldens;
+		}
+		if (k == ns - 1) {
+			problem->sub_logdens = ldens;
+		}
+	}
+	GMRFLib_thread_id = id;
+
+	memcpy(problem->sample, &samples[(size_t) (ns - 1) * n], n * sizeof(double));
+	memcpy(problem->sub_sample, &sub_samples[(size_t) (ns - 1) * sub_n], sub_n * sizeof(double));
+
+	Free(sub_samples);
+	Free(sqrterm);
+	Free(noise);
+
+	GMRFLib_LEAVE_ROUTINE;
+	return GMRFLib_SUCCESS;
+}
+
 /*! \brief Evaluates the log-density of a sample.
 
   Just compute the part from the sample in the log-likelihood, the constants 
@@ -1048,57 +1192,32 @@ int GMRFLib_evaluate__intern(GMRFLib_problem_tp * problem, int compute_const)
 	 */
 
 	int i, n;
-	double sqrterm, *xx = NULL, *yy = NULL;
 
 	if (!problem) {
 		return GMRFLib_SUCCESS;
 	}
 
 	n = problem->sub_graph->n;
-	xx = Calloc(n, double);
-	yy = Calloc(n, double);
 
 	/*
-	 * user has altered the 'sample', put the correct subset into sub_sample and compute (x-\mu)^TQ(x-\mu)
+	 * user has altered the 'sample', put the correct subset into sub_sample
 	 */
 	for (i = 0; i < n; i++) {
 		problem->sub_sample[i] = problem->sample[problem->map[i]];
-		xx[i] = problem->sub_sample[i] - problem->sub_mean[i];
-	}
-	GMRFLib_Qx(yy, xx, problem->sub_graph, problem->tab->Qfunc, (void *) problem->tab->Qfunc_arg);
-	for (i = 0, sqrterm = 0.0; i < n; i++) {
-		sqrterm += yy[i] * xx[i];
 	}
 
-	Free(xx);
-	Free(yy);
-
 	/*
-	 * evaluate the normalization constant and add up 
+	 * evaluate the normalization constant 
 	 */
 	if (compute_const) {
 		GMRFLib_EWRAP0(GMRFLib_log_determinant(&(problem->log_normc), &(problem->sub_sm_fact), problem->sub_graph));
 		problem->log_normc /= 2.0;		       /* |Q|^1/2 */
-	}
 
-	problem->sub_logdens = -0.5 * n * log(2.0 * M_PI) + problem->log_normc - 0.5 * sqrterm;
-
-	/*
-	 * now correct for the constraint, if any 
-	 */
-	if (!problem->sub_constr || problem->sub_constr->nc == 0) {
-		return GMRFLib_SUCCESS;
-	} else if (STOCHASTIC_CONSTR(problem->sub_constr)) {
-		/*
-		 * stochastic constraints 
-		 */
-		int nc = problem->sub_constr->nc;
-		double exp_corr2;
-
-		if (compute_const) {
+		if (problem->sub_constr && problem->sub_constr->nc > 0) {
 			/*
-			 * t_vector = A mu -b tt_vector = work 
+			 * t_vector = A mu-b tt_vector = i_aqat_m*t_vector 
 			 */
+			int nc = problem->sub_constr->nc;
 			double *t_vector = NULL, *tt_vector = NULL, exp_corr;
 
 			Free(problem->sub_constr_value);
@@ -1106,8 +1225,6 @@ int GMRFLib_evaluate__intern(GMRFLib_problem_tp * problem, int compute_const)
 			tt_vector = Calloc(nc, double);
 
 			GMRFLib_EWRAP0(GMRFLib_eval_constr(t_vector, NULL, problem->sub_mean, problem->sub_constr, problem->sub_graph));
-
-
 			GMRFLib_EWRAP0(GMRFLib_solveAxb_posdef(tt_vector, problem->l_aqat_m, t_vector, nc, 1));
 			for (i = 0, exp_corr = 0.0; i < nc; i++) {
 				exp_corr += t_vector[i] * tt_vector[i];
@@ -1115,13 +1232,61 @@ int GMRFLib_evaluate__intern(GMRFLib_problem_tp * problem, int compute_const)
 			problem->exp_corr = exp_corr;
 			Free(tt_vector);
 		}
+	}
+
+	GMRFLib_EWRAP0(GMRFLib_evaluate_sub__intern(&(problem->sub_logdens), problem->sub_sample, problem));
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_evaluate_sub__intern(double *logdens, double *sub_x, GMRFLib_problem_tp * problem)
+{
+	/*
+	 * evaluate the log-density in the point 'sub_x' (in the sub_graph), using the constants already computed in
+	 * 'problem'. 'problem' is not altered, so this can be called in parallel.
+	 */
+
+	int i, n;
+	double sqrterm, *xx = NULL, *yy = NULL, ldens;
 
-		GMRFLib_EWRAP0(GMRFLib_eval_constr(NULL, &exp_corr2, problem->sub_sample, problem->sub_constr, problem->sub_graph));
+	n = problem->sub_graph->n;
+	xx = Calloc(n, double);
+	yy = Calloc(n, double);
+
+	/*
+	 * compute (x-\mu)^TQ(x-\mu)
+	 */
+	for (i = 0; i < n; i++) {
+		xx[i] = sub_x[i] - problem->sub_mean[i];
+	}
+	GMRFLib_Qx(yy, xx, problem->sub_graph, problem->tab->Qfunc, (void *) problem->tab->Qfunc_arg);
+	for (i = 0, sqrterm = 0.0; i < n; i++) {
+		sqrterm += yy[i] * xx[i];
+	}
+
+	Free(xx);
+	Free(yy);
+
+	ldens = -0.5 * n * log(2.0 * M_PI) + problem->log_normc - 0.5 * sqrterm;
+
+	/*
+	 * now correct for the constraint, if any 
+	 */
+	if (!problem->sub_constr || problem->sub_constr->nc == 0) {
+		/*
+		 * nothing to do
+		 */
+	} else if (STOCHASTIC_CONSTR(problem->sub_constr)) {
+		/*
+		 * stochastic constraints 
+		 */
+		double exp_corr2;
+
+		GMRFLib_EWRAP0(GMRFLib_eval_constr(NULL, &exp_corr2, sub_x, problem->sub_constr, problem->sub_graph));
 
 		/*
 		 * [x|Ax] = [x] [Ax|x] / [Ax] 
 		 */
-		problem->sub_logdens += -0.5 * *(problem->sub_constr->intern->logdet) - 0.5 * exp_corr2	/* [Ax|x] */
+		ldens += -0.5 * *(problem->sub_constr->intern->logdet) - 0.5 * exp_corr2	/* [Ax|x] */
 		    - (-0.5 * problem->logdet_aqat - 0.5 * problem->exp_corr);	/* [Ax] */
 	} else {
 		/*
@@ -1129,32 +1294,15 @@ int GMRFLib_evaluate__intern(GMRFLib_problem_tp * problem, int compute_const)
 		 */
 		int nc = problem->sub_constr->nc;
 
-		if (compute_const) {
-			/*
-			 * t_vector = A mu-b tt_vector = i_aqat_m*t_vector 
-			 */
-			double *t_vector = NULL, *tt_vector = NULL, exp_corr;
-
-			Free(problem->sub_constr_value);
-			problem->sub_constr_value = t_vector = Calloc(nc, double);
-			tt_vector = Calloc(nc, double);
-
-			GMRFLib_EWRAP0(GMRFLib_eval_constr(t_vector, NULL, problem->sub_mean, problem->sub_constr, problem->sub_graph));
-			GMRFLib_EWRAP0(GMRFLib_solveAxb_posdef(tt_vector, problem->l_aqat_m, t_vector, nc, 1));
-			for (i = 0, exp_corr = 0.0; i < nc; i++) {
-				exp_corr += t_vector[i] * tt_vector[i];
-			}
-			problem->exp_corr = exp_corr;
-			Free(tt_vector);
-		}
-
 		/*
 		 * [x|Ax] = [x] [Ax|x] / [Ax] 
 		 */
-		problem->sub_logdens += (-0.5 * problem->logdet_aat)	/* [Ax|x] */
+		ldens += (-0.5 * problem->logdet_aat)	       /* [Ax|x] */
 		    -(-0.5 * nc * log(2.0 * M_PI) - 0.5 * problem->logdet_aqat - 0.5 * problem->exp_corr);	/* [Ax] */
 	}
 
+	*logdens = ldens;
+
 	return GMRFLib_SUCCESS;
 }
 
@@ -1199,14 +1347,21 @@ int GMRFLib_free_Qinv(GMRFLib_problem_tp * problem)
 	if (problem && problem->sub_inverse) {
 		int i, n = problem->sub_graph->n;
 
-		for (i = 0; i < n; i++) {
-			map_id_free(problem->sub_inverse->Qinv[i]);
-			Free(problem->sub_inverse->Qinv[i]);
+		if (problem->sub_inverse->Qinv) {
+			for (i = 0; i < n; i++) {
+				map_id_free(problem->sub_inverse->Qinv[i]);
+				Free(problem->sub_inverse->Qinv[i]);
+			}
+			Free(problem->sub_inverse->Qinv);
 		}
-		Free(problem->sub_inverse->Qinv);
-
-		map_ii_free(problem->sub_inverse->mapping);
-		Free(problem->sub_inverse->mapping);
+		if (problem->sub_inverse->mapping) {
+			map_ii_free(problem->sub_inverse->mapping);
+			Free(problem->sub_inverse->mapping);
+		}
+		Free(problem->sub_inverse->values);
+		Free(problem->sub_inverse->colptr);
+		Free(problem->sub_inverse->rowind);
+		Free(problem->sub_inverse->map);
 		Free(problem->sub_inverse);
 	}
 	return GMRFLib_SUCCESS;
@@ -1232,6 +1387,8 @@ int GMRFLib_free_store(GMRFLib_store_tp * store)
 	}
 
 	Free(store->remap);
+	GMRFLib_free_Qpattern_TAUCS(store->Qpattern);
+	store->Qpattern = NULL;
 	if (store->copy_ptr) {
 		/*
 		 * do nothing 
@@ -1239,7 +1396,7 @@ int GMRFLib_free_store(GMRFLib_store_tp * store)
 	} else {
 		GMRFLib_free_graph(store->sub_graph);
 		if (store->symb_fact) {
-			taucs_supernodal_factor_free(store->symb_fact);
+			GMRFLib_my_taucs_supernodal_factor_free(store->symb_fact);
 		}
 	}
 
@@ -1341,6 +1498,28 @@ double *GMRFLib_Qinv_get(GMRFLib_problem_tp * problem, int i, int j)
 		return NULL;
 	}
 
+	if (problem->sub_inverse->values) {
+		/*
+		 * the column of min(i,j) is sorted, so the row max(i,j) is found by bisection
+		 */
+		GMRFLib_Qinv_tp *qi = problem->sub_inverse;
+		int c, r, m, half, *base;
+
+		if (i < 0 || j < 0 || i >= qi->n_map || j >= qi->n_map || qi->map[i] < 0 || qi->map[j] < 0) {
+			return NULL;
+		}
+		c = IMIN(qi->map[i], qi->map[j]);
+		r = IMAX(qi->map[i], qi->map[j]);
+		base = qi->rowind + qi->colptr[c];
+		m = qi->colptr[c + 1] - qi->colptr[c];
+		while (m > 1) {
+			half = m / 2;
+			base = (base[half] <= r ? base + half : base);
+			m -= half;
+		}
+		return (m && *base == r ? qi->values + (base - qi->rowind) : NULL);
+	}
+
 	ii = map_ii_ptr(problem->sub_inverse->mapping, i);
 	if (!ii) {
 		return NULL;
@@ -1390,7 +1569,22 @@ int GMRFLib_make_empty_constr(GMRFLib_constr_tp ** constr)
 */
 int GMRFLib_free_constr(GMRFLib_constr_tp * constr)
 {
+	int shared = 0;
+
 	if (constr) {
+		/*
+		 * if the constraint is shared, then just drop this reference
+		 */
+#pragma omp critical (GMRFLib_nref)
+		{
+			if (constr->nref > 0) {
+				constr->nref--;
+				shared = 1;
+			}
+		}
+		if (shared) {
+			return GMRFLib_SUCCESS;
+		}
 		Free(constr->a_matrix);
 		Free(constr->e_vector);
 		Free(constr->errcov_diagonal);
@@ -1404,6 +1598,22 @@ int GMRFLib_free_constr(GMRFLib_constr_tp * constr)
 	return GMRFLib_SUCCESS;
 }
 
+/*!
+  \brief Return a new reference to a constraint, which must not be changed afterwards.
+
+  Each reference is released with GMRFLib_free_constr(), and the constraint is free'd with the last one.
+*/
+GMRFLib_constr_tp *GMRFLib_share_constr(GMRFLib_constr_tp * constr)
+{
+	if (constr) {
+#pragma omp critical (GMRFLib_nref)
+		{
+			constr->nref++;
+		}
+	}
+	return constr;
+}
+
 /*! \brief Prints the available information on a constraint held by an
   \c GMRFLib_constr_tp -object.
 
@@ -2013,7 +2223,8 @@ int GMRFLib_print_problem(FILE * fp, GMRFLib_problem_tp * problem)
 GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int skeleton)
 {
 	/*
-	 * duplicate a problem 
+	 * duplicate a problem. the read-only parts (the graph, the constraint, the symbolic factorisation and the pattern of Q) are
+	 * shared and reference counted, only the numerical parts are copied.
 	 */
 
 #define DUPLICATE(name, len, tp, skeleton_)				\
@@ -2053,23 +2264,33 @@ GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int
 	 */
 	DUPLICATE(sub_sm_fact.remap, ns, int, 0);
 	DUPLICATE(sub_sm_fact.bchol, ns * (problem->sub_sm_fact.bandwidth + 1), double, 0);
+	np->sub_sm_fact.profile = (skeleton ? NULL : GMRFLib_duplicate_fact_PROFILE(problem->sub_sm_fact.profile));
 
 	COPY(sub_sm_fact.bandwidth);
 	COPY(sub_sm_fact.smtp);
 
 	// FIXME("Duplicate L");
-	if (problem->sub_sm_fact.L && !skeleton) {
+	if (problem->sub_sm_fact.L && !skeleton && !problem->sub_sm_fact.L_ooc) {
 		np->sub_sm_fact.L = GMRFLib_my_taucs_dccs_duplicate(problem->sub_sm_fact.L, problem->sub_sm_fact.L->flags);
 	} else {
 		np->sub_sm_fact.L = NULL;
 	}
 
-	if (problem->sub_sm_fact.L_inv_diag && !skeleton) {
+	if (problem->sub_sm_fact.L_inv_diag && !skeleton && !problem->sub_sm_fact.L_ooc) {
 		DUPLICATE(sub_sm_fact.L_inv_diag, ns, double, skeleton);
 	} else {
 		np->sub_sm_fact.L_inv_diag = NULL;
 	}
+	if (problem->sub_sm_fact.L_ooc && !skeleton) {
+		/*
+		 * the factorisation on disk is read-only, so it is shared. the triangle is only loaded in the copy if it is needed.
+		 */
+		np->sub_sm_fact.L_ooc = GMRFLib_share_fact_TAUCS_OOC(problem->sub_sm_fact.L_ooc);
+	} else {
+		np->sub_sm_fact.L_ooc = NULL;
+	}
 	np->sub_sm_fact.symb_fact = GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(problem->sub_sm_fact.symb_fact);
+	np->sub_sm_fact.Qpattern = GMRFLib_share_Qpattern_TAUCS(problem->sub_sm_fact.Qpattern);
 	COPY(sub_sm_fact.finfo);
 
 	/*
@@ -2078,24 +2299,10 @@ GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int
 	if (skeleton) {
 		np->sub_constr = NULL;
 	} else {
-		if (problem->sub_constr) {
-			GMRFLib_make_empty_constr(&(np->sub_constr));
-			COPY(sub_constr->nc);
-			DUPLICATE(sub_constr->a_matrix, nc * ns, double, 0);
-			DUPLICATE(sub_constr->e_vector, nc, double, 0);
-
-			if (STOCHASTIC_CONSTR(problem->sub_constr)) {
-				DUPLICATE(sub_constr->errcov_diagonal, nc, double, 0);
-				DUPLICATE(sub_constr->errcov_general, ISQR(nc), double, 0);
-
-				if (problem->sub_constr->intern) {
-					np->sub_constr->intern = Calloc(1, GMRFLib_constr__intern_tp);
-					DUPLICATE(sub_constr->intern->Qpattern, ISQR(nc), char, 0);
-				}
-			}
-		} else {
-			COPY(sub_constr);
-		}
+		/*
+		 * the constraint is read-only once the problem is initialised, so it is shared
+		 */
+		np->sub_constr = GMRFLib_share_constr(problem->sub_constr);
 	}
 
 	DUPLICATE(sub_constr_value, nc, double, skeleton);
@@ -2108,7 +2315,7 @@ GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int
 	COPY(logdet_aqat);
 	COPY(log_normc);
 	COPY(exp_corr);
-	GMRFLib_copy_graph(&(np->sub_graph), problem->sub_graph);
+	np->sub_graph = GMRFLib_share_graph(problem->sub_graph);
 	np->map = np->sub_graph->mothergraph_idx;	       /* its kind of special */
 
 	/*
@@ -2130,9 +2337,19 @@ GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int
 				Qfunc_arg->log_prec_omp[i] = tmp->log_prec_omp[i];
 			}
 		}
-		Qfunc_arg->values = Calloc(ns, map_id *);
-		for (i = 0; i < ns; i++) {
-			Qfunc_arg->values[i] = GMRFLib_duplicate_map_id(tmp->values[i]);
+		if (tmp->flat) {
+			int nnz = tmp->row_start[tmp->n];
+
+			Qfunc_arg->graph = GMRFLib_share_graph(tmp->graph);
+			Qfunc_arg->row_start = Calloc(tmp->n + 1, int);
+			memcpy(Qfunc_arg->row_start, tmp->row_start, (tmp->n + 1) * sizeof(int));
+			Qfunc_arg->flat = Calloc(IMAX(1, nnz), double);
+			memcpy(Qfunc_arg->flat, tmp->flat, nnz * sizeof(double));
+		} else {
+			Qfunc_arg->values = Calloc(ns, map_id *);
+			for (i = 0; i < ns; i++) {
+				Qfunc_arg->values[i] = GMRFLib_duplicate_map_id(tmp->values[i]);
+			}
 		}
 		tab->Qfunc_arg = (void *) Qfunc_arg;
 		np->tab = tab;
@@ -2144,14 +2361,30 @@ GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int
 	 * copy the sub_inverse 
 	 */
 	if (problem->sub_inverse && !skeleton) {
+		GMRFLib_Qinv_tp *qi = problem->sub_inverse;
+
 		np->sub_inverse = Calloc(1, GMRFLib_Qinv_tp);
-		map_id **Qinv = Calloc(n, map_id *);
+		if (qi->values) {
+			int nnz = qi->colptr[ns];
+
+			np->sub_inverse->colptr = Calloc(ns + 1, int);
+			memcpy(np->sub_inverse->colptr, qi->colptr, (ns + 1) * sizeof(int));
+			np->sub_inverse->rowind = Calloc(IMAX(1, nnz), int);
+			memcpy(np->sub_inverse->rowind, qi->rowind, nnz * sizeof(int));
+			np->sub_inverse->values = Calloc(IMAX(1, nnz), double);
+			memcpy(np->sub_inverse->values, qi->values, nnz * sizeof(double));
+			np->sub_inverse->n_map = qi->n_map;
+			np->sub_inverse->map = Calloc(qi->n_map, int);
+			memcpy(np->sub_inverse->map, qi->map, qi->n_map * sizeof(int));
+		} else {
+			map_id **Qinv = Calloc(ns, map_id *);
 
-		for (i = 0; i < n; i++) {
-			Qinv[i] = GMRFLib_duplicate_map_id(problem->sub_inverse->Qinv[i]);
+			for (i = 0; i < ns; i++) {
+				Qinv[i] = GMRFLib_duplicate_map_id(qi->Qinv[i]);
+			}
+			np->sub_inverse->Qinv = Qinv;
+			np->sub_inverse->mapping = GMRFLib_duplicate_map_ii(qi->mapping);
 		}
-		np->sub_inverse->Qinv = Qinv;
-		np->sub_inverse->mapping = GMRFLib_duplicate_map_ii(problem->sub_inverse->mapping);
 	} else {
 		np->sub_inverse = NULL;
 	}
@@ -2191,6 +2424,7 @@ GMRFLib_sizeof_tp GMRFLib_sizeof_problem(GMRFLib_problem_tp * problem)
 	 */
 	DUPLICATE(sub_sm_fact.remap, ns, int);
 	DUPLICATE(sub_sm_fact.bchol, ns * (problem->sub_sm_fact.bandwidth + 1), double);
+	siz += GMRFLib_sizeof_fact_PROFILE(problem->sub_sm_fact.profile);
 
 	if (problem->sub_sm_fact.L) {
 		siz += GMRFLib_my_taucs_dccs_sizeof(problem->sub_sm_fact.L);
@@ -2200,6 +2434,7 @@ GMRFLib_sizeof_tp GMRFLib_sizeof_problem(GMRFLib_problem_tp * problem)
 		DUPLICATE(sub_sm_fact.L_inv_diag, ns, double);
 	}
 	siz += GMRFLib_my_taucs_supernodal_factor_matrix_sizeof(problem->sub_sm_fact.symb_fact);
+	siz += GMRFLib_sizeof_Qpattern_TAUCS(problem->sub_sm_fact.Qpattern);
 
 	/*
 	 * then the constraint 
@@ -2233,9 +2468,13 @@ GMRFLib_sizeof_tp GMRFLib_sizeof_problem(GMRFLib_problem_tp * problem)
 	if (problem->tab) {
 		GMRFLib_tabulate_Qfunc_arg_tp *tmp = (GMRFLib_tabulate_Qfunc_arg_tp *) (problem->tab->Qfunc_arg);
 
-		siz += ns * sizeof(map_id *);
-		for (i = 0; i < ns; i++) {
-			siz += GMRFLib_sizeof_map_id(tmp->values[i]);
+		if (tmp->flat) {
+			siz += (tmp->n + 1) * sizeof(int) + tmp->row_start[tmp->n] * sizeof(double);
+		} else {
+			siz += ns * sizeof(map_id *);
+			for (i = 0; i < ns; i++) {
+				siz += GMRFLib_sizeof_map_id(tmp->values[i]);
+			}
 		}
 	}
 
@@ -2243,11 +2482,17 @@ GMRFLib_sizeof_tp GMRFLib_sizeof_problem(GMRFLib_problem_tp * problem)
 	 * copy the sub_inverse 
 	 */
 	if (problem->sub_inverse) {
+		GMRFLib_Qinv_tp *qi = problem->sub_inverse;
+
 		siz += sizeof(GMRFLib_Qinv_tp);
-		for (i = 0; i < n; i++) {
-			siz += GMRFLib_sizeof_map_id(problem->sub_inverse->Qinv[i]);
+		if (qi->values) {
+			siz += (ns + 1 + qi->n_map) * sizeof(int) + qi->colptr[ns] * (sizeof(int) + sizeof(double));
+		} else {
+			for (i = 0; i < ns; i++) {
+				siz += GMRFLib_sizeof_map_id(qi->Qinv[i]);
+			}
+			siz += GMRFLib_sizeof_map_ii(qi->mapping);
 		}
-		siz += GMRFLib_sizeof_map_ii(problem->sub_inverse->mapping);
 	}
 #undef DUPLICATE
 
@@ -2309,6 +2554,7 @@ GMRFLib_store_tp *GMRFLib_duplicate_store(GMRFLib_store_tp * store, int skeleton
 
 	COPY(bandwidth);
 	DUPLICATE(remap, ns, int, 0);
+	new_store->Qpattern = GMRFLib_share_Qpattern_TAUCS(store->Qpattern);
 
 	int id = omp_get_thread_num();
 	GMRFLib_meminfo_thread_id = id;
@@ -2320,7 +2566,7 @@ GMRFLib_store_tp *GMRFLib_duplicate_store(GMRFLib_store_tp * store, int skeleton
 		new_store->sub_graph = store->sub_graph;
 		new_store->symb_fact = store->symb_fact;
 	} else {
-		GMRFLib_copy_graph(&(new_store->sub_graph), store->sub_graph);
+		new_store->sub_graph = GMRFLib_share_graph(store->sub_graph);
 		new_store->symb_fact = GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(store->symb_fact);
 	}
 	new_store->copy_ptr = copy_ptr;
@@ -2364,11 +2610,96 @@ double GMRFLib_Qfunc_generic(int i, int j, void *arg)
 	}
 }
 
+/*
+ * the cache of GMRFLib_optimize_reorder(). the file is named after the hash of the graph and the global-node settings, and
+ * store the choice made. we verify the size of the graph and the settings when reading, so a hash-collision is harmless.
+ */
+static char *GMRFLib_optimize_reorder_cache_fnm(GMRFLib_graph_tp * graph, GMRFLib_global_node_tp * gn)
+{
+	char *fnm = NULL;
+	unsigned long int h;
+
+	if (!GMRFLib_reorder_cache_dir) {
+		return NULL;
+	}
+	h = GMRFLib_graph_hash(graph);
+	h ^= (unsigned long int) (gn->degree) * 0x9e3779b97f4a7c15UL;
+	h ^= (unsigned long int) (gn->factor * 1.0E6) * 0xbf58476d1ce4e5b9UL;
+	GMRFLib_sprintf(&fnm, "%s/reorder-%016lx.dat", GMRFLib_reorder_cache_dir, h);
+
+	return fnm;
+}
+static int GMRFLib_optimize_reorder_cache_read(GMRFLib_graph_tp * graph, GMRFLib_global_node_tp * gn, GMRFLib_reorder_tp * reorder,
+					       int *nseps, int *use_global_nodes, GMRFLib_sizeof_tp * nnz)
+{
+	char *fnm = GMRFLib_optimize_reorder_cache_fnm(graph, gn), name[64];
+	int n, nelm, degree, ok = 0;
+	unsigned long int lnnz;
+	double factor;
+	FILE *fp;
+
+	if (!fnm) {
+		return !GMRFLib_SUCCESS;
+	}
+	fp = fopen(fnm, "r");
+	if (fp) {
+		if (fscanf(fp, "%d %d %lf %d %63s %d %d %lu", &n, &degree, &factor, &nelm, name, nseps, use_global_nodes, &lnnz) == 8) {
+			int nelm_graph;
+
+			GMRFLib_nQelm(&nelm_graph, graph);
+			ok = (n == graph->n && nelm == nelm_graph && degree == gn->degree && ISEQUAL(factor, gn->factor));
+			if (ok) {
+				*reorder = (GMRFLib_reorder_tp) GMRFLib_reorder_id((const char *) name);
+				*nnz = (GMRFLib_sizeof_tp) lnnz;
+			}
+		}
+		fclose(fp);
+	}
+	Free(fnm);
+
+	return (ok ? GMRFLib_SUCCESS : !GMRFLib_SUCCESS);
+}
+static int GMRFLib_optimize_reorder_cache_write(GMRFLib_graph_tp * graph, GMRFLib_global_node_tp * gn, GMRFLib_reorder_tp reorder,
+						int nseps, int use_global_nodes, GMRFLib_sizeof_tp nnz)
+{
+	char *fnm = GMRFLib_optimize_reorder_cache_fnm(graph, gn), *tmp = NULL;
+	int nelm;
+	FILE *fp;
+
+	if (!fnm) {
+		return GMRFLib_SUCCESS;
+	}
+
+	/*
+	 * write to a temporary file and rename it, so that concurrent runs never see a partial file
+	 */
+	GMRFLib_nQelm(&nelm, graph);
+	GMRFLib_sprintf(&tmp, "%s.%1d", fnm, (int) getpid());
+	fp = fopen(tmp, "w");
+	if (fp) {
+		fprintf(fp, "%d %d %.17g %d %s %d %d %lu\n", graph->n, gn->degree, gn->factor, nelm, GMRFLib_reorder_name(reorder), nseps,
+			use_global_nodes, (unsigned long int) nnz);
+		fclose(fp);
+		if (rename(tmp, fnm)) {
+			remove(tmp);
+		}
+	}
+	Free(tmp);
+	Free(fnm);
+
+	return GMRFLib_SUCCESS;
+}
+
 /*!
   \brief Set \c GMRFLib_reorder to the best reordering found for a given graph
 
-  This functions factorise a precision matrix (symbolically) using several different reorderings techniques and chose the one with fewest fillins. If sizeof_L is
-  non-NULL, then the sizeof_L in bytes, is returned.
+  This functions factorise a precision matrix (symbolically) using several different reorderings techniques, and chose the one
+  which require fewest flops to factorise (and then fewest fillins). The candidates are AMDC, AMDBARC and METIS with 1, 3 and 5
+  separators, with and without detection of global nodes, and they are evaluated in parallel. If sizeof_L is non-NULL, then
+  the sizeof_L in bytes, is returned.
+
+  If \c GMRFLib_reorder_cache_dir is set, the choice is stored in a file named after a hash of the graph, and is reused without
+  any search the next time this function is called with the same graph.
 */
 int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_opt, int *use_global, GMRFLib_global_node_tp * gn)
 {
@@ -2378,18 +2709,34 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 		return GMRFLib_SUCCESS;
 	}
 
-	if (GMRFLib_smtp == GMRFLib_SMTP_BAND) {
+	if (GMRFLib_smtp == GMRFLib_SMTP_BAND || GMRFLib_smtp == GMRFLib_SMTP_PROFILE) {
 		GMRFLib_reorder = GMRFLib_REORDER_DEFAULT;
 		*nnz_opt = 0;
 	} else {
+		typedef struct {
+			GMRFLib_reorder_tp reorder;
+			int nseps;
+		} cand_tp;
+
 		GMRFLib_sizeof_tp *nnzs = NULL, nnz_best;
-		int k, debug = 0, n = -1, nk, r, i, ne = 0, use_global_nodes;
-		GMRFLib_reorder_tp rs[] = { GMRFLib_REORDER_AMDC, GMRFLib_REORDER_AMDBARC };
+		GMRFLib_global_node_tp gn_in;
+		int k, debug = 0, n = -1, nk, nr, r, i, ne = 0, use_global_nodes, id;
+		cand_tp rs[] = { {GMRFLib_REORDER_AMDC, 0}, {GMRFLib_REORDER_AMDBARC, 0},
+		{GMRFLib_REORDER_METIS, 1}, {GMRFLib_REORDER_METIS, 3}, {GMRFLib_REORDER_METIS, 5}
+		};
 		taucs_ccs_matrix *Q = NULL;
-		char *fixed = NULL;
-		double *cputime = NULL;
-		
+		double *cputime = NULL, *flops = NULL;
+
+		gn_in = (gn ? *gn : GMRFLib_global_node);
+		if (GMRFLib_optimize_reorder_cache_read(graph, &gn_in, &(rs[0].reorder), &(rs[0].nseps), &use_global_nodes, &nnz_best) ==
+		    GMRFLib_SUCCESS) {
+			r = 0;
+			nr = 1;
+			goto set_choice;
+		}
+
 		n = graph->n;
+		id = GMRFLib_thread_id;
 
 		/*
 		 * build the Q-matrix; just symbolically, so I set Q_ij = 1. this matrix is common for all reordering
@@ -2427,28 +2774,26 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 		/*
 		 * do this for all reorderings, first with global node detection and then without global nodes detection 
 		 */
-		nk = 2 * (int) (sizeof(rs) / sizeof(int));     /* yes, twice... */
+		nr = (int) (sizeof(rs) / sizeof(cand_tp));
+		nk = 2 * nr;				       /* yes, twice... */
 		nnzs = Calloc(nk, GMRFLib_sizeof_tp);
+		flops = Calloc(nk, double);
 		cputime = Calloc(nk, double);
 
-//#pragma omp parallel for private(k) schedule(dynamic)
+#pragma omp parallel for private(k) schedule(dynamic)
 		for (k = 0; k < nk; k++) {
 			int *iperm = NULL, *perm = NULL, ii, kkk, use_global_nodes;
 			supernodal_factor_matrix *symb_fact = NULL;
 			taucs_ccs_matrix *L = NULL;
+			GMRFLib_global_node_tp lgn = gn_in;
 
-			GMRFLib_global_node_tp lgn;
-			if (gn) {
-				memcpy((void *) &lgn, (void *) gn, sizeof(GMRFLib_global_node_tp));
-			} else {
-				memcpy((void *) &lgn, (void *) &GMRFLib_global_node, sizeof(GMRFLib_global_node_tp));
-			}
+			GMRFLib_thread_id = id;
 
 			/*
 			 * first half is with, second half is without, the detection of global nodes 
 			 */
-			kkk = k % (nk / 2);
-			use_global_nodes = (k < nk / 2);
+			kkk = k % nr;
+			use_global_nodes = (k < nr);
 
 			if (!use_global_nodes) {
 				/*
@@ -2465,7 +2810,7 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 			if (!use_global_nodes || !(use_global_nodes && (lgn.factor > 1.0) && (lgn.degree > graph->n - 1))) {
 
 				cputime[k] = GMRFLib_cpu();
-				GMRFLib_compute_reordering_TAUCS(&iperm, graph, rs[kkk], &lgn);
+				GMRFLib_compute_reordering_TAUCS_nseps(&iperm, graph, rs[kkk].reorder, &lgn, rs[kkk].nseps);
 
 				perm = Calloc(n, int);
 				for (ii = 0; ii < n; ii++) {
@@ -2475,6 +2820,7 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 				L = taucs_ccs_permute_symmetrically(Q, perm, iperm);	/* permute the matrix */
 				symb_fact = (supernodal_factor_matrix *) taucs_ccs_factor_llt_symbolic(L);
 				nnzs[k] = GMRFLib_my_taucs_supernodal_factor_matrix_nnz(symb_fact);
+				flops[k] = GMRFLib_my_taucs_supernodal_factor_matrix_flops(symb_fact);
 				Free(perm);
 				Free(iperm);
 				taucs_ccs_free(L);
@@ -2485,34 +2831,42 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 				if (debug) {
 #pragma omp critical
 					{
-						printf("%s: reorder=[%s] \tnnz=%lu \tUseGlobalNodes=%1d cpu=%.4f\n", __GMRFLib_FuncName,
-						       GMRFLib_reorder_name(rs[kkk]), nnzs[k], use_global_nodes, cputime[k]);
+						printf("%s: reorder=[%s] nseps=%1d \tnnz=%lu \tflops=%.4g \tUseGlobalNodes=%1d cpu=%.4f\n", __GMRFLib_FuncName,
+						       GMRFLib_reorder_name(rs[kkk].reorder), rs[kkk].nseps, nnzs[k], flops[k], use_global_nodes, cputime[k]);
 					}
 				}
 
 			} else {
 				nnzs[k] = UINT_MAX;
+				flops[k] = DBL_MAX;
 			}
 		}
+		GMRFLib_thread_id = id;
 
 		/*
-		 * find the best one 
+		 * find the best one; fewest flops, and then fewest fillins
 		 */
 		r = 0;
-		nnz_best = nnzs[r];
 		for (k = 1; k < nk; k++) {
-			if (nnzs[k] < nnz_best) {
+			if (flops[k] < flops[r] || (flops[k] == flops[r] && nnzs[k] < nnzs[r])) {
 				r = k;
-				nnz_best = nnzs[r];
 			}
 		}
+		nnz_best = nnzs[r];
 
 		/*
 		 * find out which one this is 
 		 */
-		use_global_nodes = (r < (nk / 2));
-		r = r % (nk / 2);
+		use_global_nodes = (r < nr);
+		r = r % nr;
+		GMRFLib_optimize_reorder_cache_write(graph, &gn_in, rs[r].reorder, rs[r].nseps, use_global_nodes, nnz_best);
 
+		taucs_ccs_free(Q);
+		Free(nnzs);
+		Free(flops);
+		Free(cputime);
+
+	      set_choice:
 		if (!use_global_nodes) {
 			GMRFLib_global_node_tp g = { 2.0, INT_MAX };
 			GMRFLib_global_node = g;
@@ -2527,19 +2881,19 @@ int GMRFLib_optimize_reorder(GMRFLib_graph_tp * graph, GMRFLib_sizeof_tp * nnz_o
 				memcpy((void *) &GMRFLib_global_node, (void *) gn, sizeof(GMRFLib_global_node));
 			}
 		}
-		GMRFLib_reorder = rs[r];
+		GMRFLib_reorder = rs[r].reorder;
+		if (rs[r].reorder == GMRFLib_REORDER_METIS) {
+			GMRFLib_metis_nseps = rs[r].nseps;
+		}
 
 		if (debug) {
-			printf("%s: best reordering=[%s] UseGlobalNodes=%1d\n", __GMRFLib_FuncName, GMRFLib_reorder_name(GMRFLib_reorder), use_global_nodes);
+			printf("%s: best reordering=[%s] nseps=%1d UseGlobalNodes=%1d\n", __GMRFLib_FuncName, GMRFLib_reorder_name(GMRFLib_reorder),
+			       rs[r].nseps, use_global_nodes);
 		}
-		taucs_ccs_free(Q);
 		if (nnz_opt)
 			*nnz_opt = nnz_best;
 		if (use_global)
 			*use_global = use_global_nodes;
-
-		Free(nnzs);
-		Free(fixed);
 	}
 	return GMRFLib_SUCCESS;
 }
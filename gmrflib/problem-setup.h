@@ -198,6 +198,11 @@ typedef struct {
 	 *  \brief For internal use only 
 	 */
 	GMRFLib_constr__intern_tp *intern;
+
+	/**
+	 *  \brief For internal use only: the number of additional users of this (read-only) constraint, see GMRFLib_share_constr()
+	 */
+	int nref;
 } GMRFLib_constr_tp;
 
 typedef struct {
@@ -251,6 +256,34 @@ typedef struct {
 	 *  \brief The mapping used to lookup values in \a Qinv 
 	 */
 	map_ii *mapping;
+
+	/**
+	 *  \brief For internal use only: if not NULL, the stored values are kept here instead of in \a Qinv and \a mapping
+	 *
+	 * The values of column \a j (in internal coordinates) are values[colptr[j]]...values[colptr[j+1]-1], for the (sorted) rows
+	 * rowind[colptr[j]]..., starting with the diagonal. With GMRFLib_QINV_ALL, this is the pattern of \a L.
+	 */
+	double *values;
+
+	/**
+	 *  \brief For internal use only: the column-pointers for \a values (length n+1)
+	 */
+	int *colptr;
+
+	/**
+	 *  \brief For internal use only: the row-indices for \a values
+	 */
+	int *rowind;
+
+	/**
+	 *  \brief For internal use only: the internal coordinate for each node in the full graph, or -1 if it is not in the sub-graph (length \a n_map)
+	 */
+	int *map;
+
+	/**
+	 *  \brief For internal use only: the length of \a map
+	 */
+	int n_map;
 } GMRFLib_Qinv_tp;
 
 /*! 
@@ -476,6 +509,7 @@ struct GMRFLib_store_struct {
 	int copy_ptr;
 	GMRFLib_graph_tp *sub_graph;
 	supernodal_factor_matrix *symb_fact;		       /* for GMRFLIb_smtp == GMRFLib_SMTP_TAUCS */
+	GMRFLib_Qpattern_tp *Qpattern;			       /* for GMRFLIb_smtp == GMRFLib_SMTP_TAUCS */
 
 	GMRFLib_store_tp *diag_store;			       /* store SAFE-optims in optimize */
 	GMRFLib_store_tp *sub_store;			       /* store the same if fixed values in optimize */
@@ -498,9 +532,11 @@ int GMRFLib_Qinv(GMRFLib_problem_tp * problem, int storage);
 int GMRFLib_eval_constr(double *value, double *sqr_value, double *x, GMRFLib_constr_tp * constr, GMRFLib_graph_tp * graph);
 int GMRFLib_evaluate(GMRFLib_problem_tp * problem);
 int GMRFLib_evaluate__intern(GMRFLib_problem_tp * problem, int compute_const);
+int GMRFLib_evaluate_sub__intern(double *logdens, double *sub_x, GMRFLib_problem_tp * problem);
 int GMRFLib_fact_info_report(FILE * fp, GMRFLib_sm_fact_tp * sm_fact);
 int GMRFLib_free_Qinv(GMRFLib_problem_tp * problem);
 int GMRFLib_free_constr(GMRFLib_constr_tp * constr);
+GMRFLib_constr_tp *GMRFLib_share_constr(GMRFLib_constr_tp * constr);
 int GMRFLib_free_problem(GMRFLib_problem_tp * problem);
 int GMRFLib_free_store(GMRFLib_store_tp * store);
 int GMRFLib_info_problem(FILE * fp, GMRFLib_problem_tp * problem);
@@ -517,6 +553,7 @@ int GMRFLib_print_problem(FILE * fp, GMRFLib_problem_tp * problem);
 int GMRFLib_recomp_constr(GMRFLib_constr_tp ** new_constr, GMRFLib_constr_tp * constr, double *x, double *b_add, char *mask,
 			  GMRFLib_graph_tp * graph, GMRFLib_graph_tp * sub_graph);
 int GMRFLib_sample(GMRFLib_problem_tp * problem);
+int GMRFLib_sample_batch(GMRFLib_problem_tp * problem, int ns, double *samples, double *logdens);
 
 GMRFLib_problem_tp *GMRFLib_duplicate_problem(GMRFLib_problem_tp * problem, int skeleton);
 GMRFLib_store_tp *GMRFLib_duplicate_store(GMRFLib_store_tp * store, int skeleton, int copy_ptr);
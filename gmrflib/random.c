@@ -72,6 +72,7 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <stdint.h>
 
 #include "GMRFLib/GMRFLib.h"
 #include "GMRFLib/GMRFLibP.h"
@@ -150,3 +151,29 @@ int GMRFLib_rng_setstate(void *saved_state)
 	}
 	return GMRFLib_SUCCESS;
 }
+
+/*!
+  \brief Return a new RNG for stream number \c stream derived from \c seed.
+
+  The seed of the new MT19937 generator is a hash of (\c seed, \c stream), so that different streams are (practically) independent,
+  and the sequence in each stream depends only on \c seed and \c stream.  This makes it possible to give each task in a parallel
+  loop its own stream, and get the same results whatever the number of threads. Free the returned RNG with \c gsl_rng_free().
+*/
+gsl_rng *GMRFLib_rng_stream(unsigned long int seed, size_t stream)
+{
+	/*
+	 * use the splitmix64 finaliser to mix the seed and the stream number 
+	 */
+	uint64_t z;
+	gsl_rng *r = NULL;
+
+	z = (uint64_t) seed + ((uint64_t) stream + 1) * UINT64_C(0x9E3779B97F4A7C15);
+	z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+	z = z ^ (z >> 31);
+
+	r = gsl_rng_alloc(gsl_rng_mt19937);
+	gsl_rng_set(r, (unsigned long int) z);
+
+	return r;
+}
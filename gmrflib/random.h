@@ -63,6 +63,7 @@ int GMRFLib_rng_init(unsigned long int seed);
 int GMRFLib_rng_set_default_seed(void);
 int GMRFLib_rng_setstate(void *saved_state);
 void *GMRFLib_rng_getstate(size_t *siz);
+gsl_rng *GMRFLib_rng_stream(unsigned long int seed, size_t stream);
 
 
 __END_DECLS
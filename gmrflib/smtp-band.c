@@ -44,11 +44,16 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 /* Pre-hg-Id: $Id: smtp-band.c,v 1.47 2010/02/26 17:55:22 hrue Exp $ */
 
 int GMRFLib_compute_reordering_BAND(int **remap, GMRFLib_graph_tp * graph)
+{
+	return GMRFLib_compute_reordering_BAND__intern(remap, graph, 0);
+}
+int GMRFLib_compute_reordering_BAND__intern(int **remap, GMRFLib_graph_tp * graph, int ioptpro)
 {
 	/*
-	 * compute the reordering from the graph using the routine in acm582.F 
+	 * compute the reordering from the graph using the routine in acm582.F. reduce the bandwidth (Gibbs-Poole-Stockmeyer) if
+	 * ioptpro = 0, and the profile (Gibbs-King) otherwise.
 	 */
-	int i, j, lconnec, bandwidth, profile, error, space, ioptpro, worklen, *rstart, *connec, *degree, *work, simple;
+	int i, j, lconnec, bandwidth, profile, error, space, worklen, *rstart, *connec, *degree, *work, simple;
 
 	if (!graph || !graph->n)
 		return GMRFLib_SUCCESS;
@@ -113,7 +118,6 @@ int GMRFLib_compute_reordering_BAND(int **remap, GMRFLib_graph_tp * graph)
 		(*remap)[i] = i + 1;			       /* fortran indx'ing */
 	}
 
-	ioptpro = 0;					       /* do bandwidth reduction */
 	error = space = 0;
 	gpskca_(&graph->n, degree, rstart, connec, &ioptpro, &worklen, *remap, work, &bandwidth, &profile, &error, &space);
 
@@ -314,6 +318,53 @@ int GMRFLib_solve_l_sparse_matrix_BAND(double *rhs, double *bchol, GMRFLib_graph
 
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_solve_nrhs_sparse_matrix_BAND(double *rhs, int nrhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth, int what)
+{
+	/*
+	 * rhs in real world, bchol in mapped word. rhs is column-blocked, rhs[k*n + i] is element i of right hand side k, and
+	 * is overwritten by the solutions. what = 0: solve Lx=rhs, what = 1: solve L^Tx=rhs, what = 2: solve LL^Tx=rhs.
+	 *
+	 * blocks of GMRFLib_NRHS_BLOCK right hand sides are solved with one call to dtbtrs, in parallel over the blocks.
+	 */
+	int n, nblock, b, id;
+
+	n = graph->n;
+	if (n == 0 || nrhs <= 0) {
+		return GMRFLib_SUCCESS;
+	}
+
+	nblock = (nrhs + GMRFLib_NRHS_BLOCK - 1) / GMRFLib_NRHS_BLOCK;
+	id = GMRFLib_thread_id;
+
+#pragma omp parallel for private(b) schedule(dynamic) if (nblock > 1)
+	for (b = 0; b < nblock; b++) {
+		int k, k0, nb, nband, ldim, info = 0;
+		double *B = NULL;
+
+		GMRFLib_thread_id = id;
+		k0 = b * GMRFLib_NRHS_BLOCK;
+		nb = IMIN(GMRFLib_NRHS_BLOCK, nrhs - k0);
+		B = &rhs[(size_t) k0 * n];
+		nband = bandwidth;
+		ldim = nband + 1;
+
+		for (k = 0; k < nb; k++) {
+			GMRFLib_convert_to_mapped(&B[k * n], NULL, graph, remap);
+		}
+		if (what == 0 || what == 2) {
+			dtbtrs_("L", "N", "N", &n, &nband, &nb, bchol, &ldim, B, &n, &info, 1, 1, 1);
+		}
+		if (what == 1 || what == 2) {
+			dtbtrs_("L", "T", "N", &n, &nband, &nb, bchol, &ldim, B, &n, &info, 1, 1, 1);
+		}
+		for (k = 0; k < nb; k++) {
+			GMRFLib_convert_from_mapped(&B[k * n], NULL, graph, remap);
+		}
+	}
+	GMRFLib_thread_id = id;
+
+	return GMRFLib_SUCCESS;
+}
 int GMRFLib_solve_lt_sparse_matrix_special_BAND(double *rhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth,
 						int findx, int toindx, int remapped)
 {
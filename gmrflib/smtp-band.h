@@ -62,6 +62,7 @@ void dtbsvspecial_(const char *, const char *, const char *, int *, int *, doubl
 int cmsd_(double *, double *, int *, int *, int *, double *, int *, double *);
 
 int GMRFLib_compute_reordering_BAND(int **remap, GMRFLib_graph_tp * graph);
+int GMRFLib_compute_reordering_BAND__intern(int **remap, GMRFLib_graph_tp * graph, int ioptpro);
 int GMRFLib_build_sparse_matrix_BAND(double **bandmatrix, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap, int bandwidth);
 int GMRFLib_factorise_sparse_matrix_BAND(double *band, GMRFLib_fact_info_tp * finfo, GMRFLib_graph_tp * graph, int bandwidth);
 int GMRFLib_free_fact_sparse_matrix_BAND(double *bchol);
@@ -70,6 +71,7 @@ int GMRFLib_solve_llt_sparse_matrix_BAND(double *rhs, double *bchol, GMRFLib_gra
 int GMRFLib_solve_lt_sparse_matrix_special_BAND(double *rhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth,
 						int findx, int toindx, int remapped);
 int GMRFLib_solve_l_sparse_matrix_BAND(double *rhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth);
+int GMRFLib_solve_nrhs_sparse_matrix_BAND(double *rhs, int nrhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth, int what);
 int GMRFLib_solve_l_sparse_matrix_special_BAND(double *rhs, double *bchol, GMRFLib_graph_tp * graph, int *remap, int bandwidth,
 					       int findx, int toindx, int remapped);
 int GMRFLib_log_determinant_BAND(double *logdet, double *bchol, GMRFLib_graph_tp * graph, int bandwidth);
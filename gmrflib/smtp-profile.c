@@ -30,7 +30,12 @@
 
 /*!
   \file smtp-profile.c
-  \brief Template for an interface to a new sparse-matrix library
+  \brief The profile (envelope, or skyline) sparse-matrix solver
+
+  The lower triangle of Q and its Cholesky triangle are stored row by row, from the first non-zero in each row up to the
+  diagonal, see GMRFLib_profile_tp. This profile is preserved by the factorisation, and all the inner loops run over contiguous
+  memory. For models with a small profile after reordering, like long temporal models, this is lighter than the supernodal
+  factorisation in TAUCS and the band solver in LAPACK.
 */
 
 #include "GMRFLib/GMRFLib.h"
@@ -43,69 +48,619 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 
 /* Pre-hg-Id: $Id: smtp-profile.c,v 1.10 2010/02/26 17:54:28 hrue Exp $ */
 
-int GMRFLib_compute_reordering_PROFILE(void)
+#define PIDX(p_, i_, j_) ((p_)->ptr[i_] + (size_t) ((j_) - (p_)->first[i_]))	/* index of element (i,j), j <= i, in p->val */
+
+int GMRFLib_compute_reordering_PROFILE(int **remap, GMRFLib_graph_tp * graph)
+{
+	/*
+	 * the profile reducing version (Gibbs-King) of the routine used for the band-solver
+	 */
+	return GMRFLib_compute_reordering_BAND__intern(remap, graph, 1);
+}
+int GMRFLib_build_sparse_matrix_PROFILE(GMRFLib_profile_tp ** profile, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap)
 {
-	abort();
+	/*
+	 * return the lower triangle of the precision matrix, in the mapped world, in profile storage
+	 */
+	int i, j, n, id, nan_error = 0;
+	GMRFLib_profile_tp *p = NULL;
+
+	id = GMRFLib_thread_id;
+	n = graph->n;
+	p = Calloc(1, GMRFLib_profile_tp);
+	p->n = n;
+	p->first = Calloc(n, int);
+	p->last = Calloc(n, int);
+	p->ptr = Calloc(n + 1, size_t);
+
+	for (i = 0; i < n; i++) {
+		int node = remap[i];
+		int first = node;
+
+		for (j = 0; j < graph->nnbs[i]; j++) {
+			first = IMIN(first, remap[graph->nbs[i][j]]);
+		}
+		p->first[node] = first;
+	}
+
+	p->ptr[0] = 0;
+	for (i = 0; i < n; i++) {
+		p->ptr[i + 1] = p->ptr[i] + (size_t) (i - p->first[i] + 1);
+	}
+
+	/*
+	 * last[j] = max{i : first[i] <= j}, which is non-decreasing in j
+	 */
+	for (i = 0; i < n; i++) {
+		p->last[i] = i;
+	}
+	for (i = 0; i < n; i++) {
+		p->last[p->first[i]] = IMAX(p->last[p->first[i]], i);
+	}
+	for (i = 1; i < n; i++) {
+		p->last[i] = IMAX(p->last[i], p->last[i - 1]);
+	}
+
+	p->val = Calloc(p->ptr[n], double);
+
+#pragma omp parallel for private(i)
+	for (i = 0; i < n; i++) {
+		int node = remap[i];
+		int jj, k;
+		double val;
+
+		GMRFLib_thread_id = id;
+
+		val = Qfunc(i, i, Qfunc_arg);
+		GMRFLib_STOP_IF_NAN_OR_INF(val, i, i);
+		p->val[PIDX(p, node, node)] = val;
+
+		for (k = 0; k < graph->nnbs[i]; k++) {
+			int nnode;
+
+			jj = graph->nbs[i][k];
+			nnode = remap[jj];
+			if (nnode < node) {
+				val = Qfunc(i, jj, Qfunc_arg);
+				GMRFLib_STOP_IF_NAN_OR_INF(val, i, jj);
+				p->val[PIDX(p, node, nnode)] = val;
+			}
+		}
+	}
+	GMRFLib_thread_id = id;
+	*profile = p;
+
+	if (GMRFLib_catch_error_for_inla) {
+		if (nan_error) {
+			return !GMRFLib_SUCCESS;
+		}
+	}
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_build_sparse_matrix_PROFILE(void)
+int GMRFLib_factorise_sparse_matrix_PROFILE(GMRFLib_profile_tp * profile, GMRFLib_fact_info_tp * finfo, GMRFLib_graph_tp * graph)
 {
-	abort();
+	/*
+	 * compute the Cholesky factorisation row by row, overwriting 'profile'. with L(i,k) and L(j,k) stored contiguously in
+	 * row i and j, each element is one dot-product.
+	 */
+	int i, j, k, kmin, n = profile->n;
+	double *Li, *Lj, tmp;
+
+	for (i = 0; i < n; i++) {
+		Li = &(profile->val[profile->ptr[i]]) - profile->first[i];	/* so that Li[k] = L(i,k) */
+		for (j = profile->first[i]; j < i; j++) {
+			Lj = &(profile->val[profile->ptr[j]]) - profile->first[j];
+			kmin = IMAX(profile->first[i], profile->first[j]);
+			tmp = Li[j];
+			for (k = kmin; k < j; k++) {
+				tmp -= Li[k] * Lj[k];
+			}
+			Li[j] = tmp / Lj[j];
+		}
+		tmp = Li[i];
+		for (k = profile->first[i]; k < i; k++) {
+			tmp -= SQR(Li[k]);
+		}
+		if (tmp <= 0.0 || ISNAN(tmp)) {
+			if (GMRFLib_catch_error_for_inla) {
+				fprintf(stdout, "\n\t%s\n\tFunction: %s(), Line: %1d, Thread: %1d\n\tFail to factorize Q. I will try to fix it...\n\n",
+					RCSId, __GMRFLib_FuncName, __LINE__, omp_get_thread_num());
+				return GMRFLib_EPOSDEF;
+			} else {
+				GMRFLib_ERROR(GMRFLib_EPOSDEF);
+			}
+		}
+		Li[i] = sqrt(tmp);
+	}
+
+	/*
+	 * provide some info about the factorization 
+	 */
+	for (i = 0, k = 0; i < graph->n; i++)
+		k += graph->nnbs[i];
+
+	finfo->n = graph->n;				       /* size of Q */
+	finfo->nnzero = k + graph->n;			       /* # non-zeros in Q */
+	finfo->nfillin = (int) (profile->ptr[n] - n) - (finfo->nnzero - graph->n) / 2;	/* fillin in L, counting the zeros in the profile */
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_factorise_sparse_matrix_PROFILE(void)
+int GMRFLib_free_fact_sparse_matrix_PROFILE(GMRFLib_profile_tp * profile)
 {
-	abort();
+	if (profile) {
+		Free(profile->first);
+		Free(profile->last);
+		Free(profile->ptr);
+		Free(profile->val);
+		Free(profile);
+	}
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_free_fact_sparse_matrix_PROFILE(void)
+GMRFLib_profile_tp *GMRFLib_duplicate_fact_PROFILE(GMRFLib_profile_tp * profile)
 {
-	abort();
+	GMRFLib_profile_tp *p = NULL;
+
+	if (!profile) {
+		return NULL;
+	}
+	p = Calloc(1, GMRFLib_profile_tp);
+	p->n = profile->n;
+	p->first = Calloc(p->n, int);
+	p->last = Calloc(p->n, int);
+	p->ptr = Calloc(p->n + 1, size_t);
+	p->val = Calloc(profile->ptr[p->n], double);
+	memcpy(p->first, profile->first, p->n * sizeof(int));
+	memcpy(p->last, profile->last, p->n * sizeof(int));
+	memcpy(p->ptr, profile->ptr, (p->n + 1) * sizeof(size_t));
+	memcpy(p->val, profile->val, profile->ptr[p->n] * sizeof(double));
+
+	return p;
+}
+GMRFLib_sizeof_tp GMRFLib_sizeof_fact_PROFILE(GMRFLib_profile_tp * profile)
+{
+	if (!profile) {
+		return 0;
+	}
+	return sizeof(GMRFLib_profile_tp) + 2 * profile->n * sizeof(int) + (profile->n + 1) * sizeof(size_t) + profile->ptr[profile->n] * sizeof(double);
+}
+
+/*
+  the solvers in the mapped world, x is overwritten by the solution
+*/
+static void GMRFLib_solve_l_PROFILE(GMRFLib_profile_tp * L, double *x)
+{
+	int i, k;
+	double *Li, tmp;
+
+	for (i = 0; i < L->n; i++) {
+		Li = &(L->val[L->ptr[i]]) - L->first[i];
+		tmp = x[i];
+		for (k = L->first[i]; k < i; k++) {
+			tmp -= Li[k] * x[k];
+		}
+		x[i] = tmp / Li[i];
+	}
+}
+static void GMRFLib_solve_lt_PROFILE(GMRFLib_profile_tp * L, double *x)
+{
+	int i, k;
+	double *Li, xi;
+
+	for (i = L->n - 1; i >= 0; i--) {
+		Li = &(L->val[L->ptr[i]]) - L->first[i];
+		xi = x[i] = x[i] / Li[i];
+		for (k = L->first[i]; k < i; k++) {
+			x[k] -= Li[k] * xi;
+		}
+	}
+}
+
+int GMRFLib_solve_lt_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap)
+{
+	/*
+	 * rhs in real world, profile in mapped word
+	 * 
+	 * solve L^Tx=rhs, rhs is overwritten by the solution 
+	 */
+	GMRFLib_convert_to_mapped(rhs, NULL, graph, remap);
+	GMRFLib_solve_lt_PROFILE(profile, rhs);
+	GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_solve_llt_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap)
+{
+	/*
+	 * rhs in real world, profile in mapped word
+	 * 
+	 * solve Q x=rhs, where Q=L L^T 
+	 */
+	GMRFLib_convert_to_mapped(rhs, NULL, graph, remap);
+	GMRFLib_solve_l_PROFILE(profile, rhs);
+	GMRFLib_solve_lt_PROFILE(profile, rhs);
+	GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_solve_lt_sparse_matrix_PROFILE(void)
+int GMRFLib_solve_l_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap)
 {
-	abort();
+	/*
+	 * rhs in real world, profile in mapped word
+	 * 
+	 * solve L x=rhs, rhs is overwritten by the solution 
+	 */
+	GMRFLib_convert_to_mapped(rhs, NULL, graph, remap);
+	GMRFLib_solve_l_PROFILE(profile, rhs);
+	GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_solve_llt_sparse_matrix_PROFILE(void)
+int GMRFLib_solve_nrhs_sparse_matrix_PROFILE(double *rhs, int nrhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap, int what)
 {
-	abort();
+	/*
+	 * rhs in real world, profile in mapped word. rhs is column-blocked, rhs[k*n + i] is element i of right hand side k, and
+	 * is overwritten by the solutions. what = 0: solve Lx=rhs, what = 1: solve L^Tx=rhs, what = 2: solve LL^Tx=rhs.
+	 */
+	int n, k, id;
+
+	n = graph->n;
+	if (n == 0 || nrhs <= 0) {
+		return GMRFLib_SUCCESS;
+	}
+
+	id = GMRFLib_thread_id;
+#pragma omp parallel for private(k) if (nrhs > 1)
+	for (k = 0; k < nrhs; k++) {
+		double *b = &rhs[(size_t) k * n];
+
+		GMRFLib_thread_id = id;
+		GMRFLib_convert_to_mapped(b, NULL, graph, remap);
+		if (what == 0 || what == 2) {
+			GMRFLib_solve_l_PROFILE(profile, b);
+		}
+		if (what == 1 || what == 2) {
+			GMRFLib_solve_lt_PROFILE(profile, b);
+		}
+		GMRFLib_convert_from_mapped(b, NULL, graph, remap);
+	}
+	GMRFLib_thread_id = id;
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_solve_l_sparse_matrix_PROFILE(void)
+int GMRFLib_solve_lt_sparse_matrix_special_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap,
+						   int findx, int toindx, int remapped)
 {
-	abort();
+	/*
+	 * rhs in real world, profile in mapped world.  solve L^Tx=b backward only from rhs[findx] up to rhs[toindx], where
+	 * rhs[j] for j > findx is the solution already. note that findx and toindx is in mapped world.  if remapped, do not
+	 * remap/remap-back the rhs before solving.
+	 */
+	int i, k;
+	double *Li, xi;
+	GMRFLib_profile_tp *L = profile;
+
+	if (!remapped)
+		GMRFLib_convert_to_mapped(rhs, NULL, graph, remap);
+
+	/*
+	 * first the contributions from the known part, then the backward solve. only rhs[toindx]...rhs[findx] is changed.
+	 */
+	for (i = findx + 1; i <= L->last[findx]; i++) {
+		if (L->first[i] <= findx) {
+			Li = &(L->val[L->ptr[i]]) - L->first[i];
+			xi = rhs[i];
+			for (k = IMAX(L->first[i], toindx); k <= findx; k++) {
+				rhs[k] -= Li[k] * xi;
+			}
+		}
+	}
+	for (i = findx; i >= toindx; i--) {
+		Li = &(L->val[L->ptr[i]]) - L->first[i];
+		xi = rhs[i] = rhs[i] / Li[i];
+		for (k = IMAX(L->first[i], toindx); k < i; k++) {
+			rhs[k] -= Li[k] * xi;
+		}
+	}
+
+	if (!remapped)
+		GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_solve_lt_sparse_matrix_special_PROFILE(void)
+int GMRFLib_solve_l_sparse_matrix_special_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap,
+						  int findx, int toindx, int remapped)
 {
-	abort();
+	/*
+	 * rhs in real world, profile in mapped world.  solve Lx=b forward only from rhs[findx] up to rhs[toindx], using only
+	 * this part of rhs. note that findx and toindx is in mapped world.  if remapped, do not remap/remap-back the rhs before
+	 * solving.
+	 */
+	int i, k;
+	double *Li, tmp;
+	GMRFLib_profile_tp *L = profile;
+
+	if (!remapped)
+		GMRFLib_convert_to_mapped(rhs, NULL, graph, remap);
+
+	for (i = findx; i <= toindx; i++) {
+		Li = &(L->val[L->ptr[i]]) - L->first[i];
+		tmp = rhs[i];
+		for (k = IMAX(L->first[i], findx); k < i; k++) {
+			tmp -= Li[k] * rhs[k];
+		}
+		rhs[i] = tmp / Li[i];
+	}
+
+	if (!remapped)
+		GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_solve_l_sparse_matrix_special_PROFILE(void)
+int GMRFLib_comp_cond_meansd_PROFILE(double *cmean, double *csd, int indx, double *x, int remapped, GMRFLib_profile_tp * profile,
+				     GMRFLib_graph_tp * graph, int *remap)
 {
-	abort();
+	/*
+	 * compute the conditonal mean and stdev for x[indx]|x[indx+1]...x[n-1] for the current value of x. if `remapped', then 
+	 * x is assumed to be remapped for possible (huge) speedup when used repeately.  note: indx is still the user world!!!
+	 */
+	int i, ii;
+	double b = 0.0, *Li;
+	GMRFLib_profile_tp *L = profile;
+
+	if (!remapped)
+		GMRFLib_convert_to_mapped(x, NULL, graph, remap);
+
+	ii = remap[indx];
+	for (i = ii + 1; i <= L->last[ii]; i++) {
+		if (L->first[i] <= ii) {
+			b -= L->val[PIDX(L, i, ii)] * x[i];
+		}
+	}
+	Li = &(L->val[L->ptr[ii]]) - L->first[ii];
+	*cmean = b / Li[ii];
+	*csd = 1.0 / Li[ii];
+
+	if (!remapped)
+		GMRFLib_convert_from_mapped(x, NULL, graph, remap);
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_comp_cond_meansd_PROFILE(void)
+int GMRFLib_log_determinant_PROFILE(double *logdet, GMRFLib_profile_tp * profile)
 {
-	abort();
+	int i;
+
+	for (i = 0, *logdet = 0.0; i < profile->n; i++)
+		*logdet += log(profile->val[profile->ptr[i + 1] - 1]);
+	*logdet *= 2;
+
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_log_determinant_PROFILE(void)
+int GMRFLib_compute_Qinv_PROFILE(GMRFLib_problem_tp * problem, int storage)
 {
-	abort();
+	/*
+	 * the recursions are computed for the elements in the profile of L, which is closed under the recursions; if L(k,i)
+	 * and L(j,i) are in the profile, k > j > i, then so is (k,j). the covariances are stored in the same format as L.
+	 *
+	 * the rest of this code is copied from the BAND version. be aware.... 
+	 */
+	int i, j, k, iii, jjj, kk, n, *inv_remap = NULL, *rremove = NULL, *nbs = NULL, nnbs, nrremove;
+	double tmp, Lii_inv, value, *Li, *cov_val;
+
+	GMRFLib_profile_tp *L = problem->sub_sm_fact.profile, cov;
+	map_id **Qinv_L = NULL;
+	map_ii *mapping = NULL;
+
+	n = problem->sub_graph->n;
+	cov = *L;
+	cov.val = cov_val = Calloc(L->ptr[n], double);
+
+#define Cov(i_, j_) cov_val[PIDX(&cov, IMAX(i_, j_), IMIN(i_, j_))]
+
+	/*
+	 * setup the hash-table for storing Qinv_L 
+	 */
+	Qinv_L = Calloc(n, map_id *);
+#pragma omp parallel for private(i)
+	for (i = 0; i < n; i++) {
+		Qinv_L[i] = Calloc(1, map_id);
+		map_id_init_hint(Qinv_L[i], L->last[i] - i + 1);
+	}
+
+	/*
+	 * do the recursions. nbs holds the non-zero structure of column i of L, below the diagonal
+	 */
+	nbs = Calloc(n, int);
+	for (i = n - 1; i >= 0; i--) {
+		for (k = i + 1, nnbs = 0; k <= L->last[i]; k++) {
+			if (L->first[k] <= i) {
+				nbs[nnbs++] = k;
+			}
+		}
+		Li = &(L->val[L->ptr[i]]) - L->first[i];
+		Lii_inv = 1.0 / Li[i];
+
+		for (jjj = nnbs - 1; jjj >= -1; jjj--) {
+			j = (jjj >= 0 ? nbs[jjj] : i);
+			for (kk = 0, tmp = 0.0; kk < nnbs; kk++) {
+				k = nbs[kk];
+				tmp += L->val[PIDX(L, k, i)] * Cov(k, j);
+			}
+			if (j == i) {
+				Cov(i, i) = value = Lii_inv * (Lii_inv - tmp);
+			} else {
+				Cov(i, j) = value = -Lii_inv * tmp;
+			}
+			map_id_set(Qinv_L[i], j, value);
+		}
+	}
+
+	/*
+	 * ----------->>>> the rest of this routine is copied from smtp-taucs.c <<<<<--------------- 
+	 */
+
+	/*
+	 * compute the mapping 
+	 */
+	inv_remap = Calloc(n, int);
+
+	for (k = 0; k < n; k++) {
+		inv_remap[problem->sub_sm_fact.remap[k]] = k;
+	}
+
+	/*
+	 * possible remove entries: options are GMRFLib_QINV_ALL GMRFLib_QINV_NEIGB GMRFLib_QINV_DIAG 
+	 */
+	if (storage & (GMRFLib_QINV_DIAG | GMRFLib_QINV_NEIGB)) {
+		rremove = Calloc(n, int);
+
+		for (i = 0; i < n; i++) {
+			iii = inv_remap[i];
+			if (storage & GMRFLib_QINV_DIAG) {
+				for (k = -1, nrremove = 0; (k = (int) map_id_next(Qinv_L[i], k)) != -1;) {
+					if ((j = Qinv_L[i]->contents[k].key) != i) {
+						rremove[nrremove++] = j;
+					}
+				}
+			} else {
+				for (k = -1, nrremove = 0; (k = (int) map_id_next(Qinv_L[i], k)) != -1;) {
+					j = Qinv_L[i]->contents[k].key;
+					if (j != i) {
+						jjj = inv_remap[j];
+						if (!GMRFLib_is_neighb(iii, jjj, problem->sub_graph)) {
+							rremove[nrremove++] = j;
+						}
+					}
+				}
+			}
+			for (k = 0; k < nrremove; k++) {
+				map_id_remove(Qinv_L[i], rremove[k]);
+			}
+			map_id_adjustcapacity(Qinv_L[i]);
+		}
+	}
+
+	/*
+	 * correct for constraints, if any. need `iremap' as the matrix terms, constr_m and qi_at_m, is in the sub_graph
+	 * coordinates without reordering!
+	 * 
+	 * not that this is correct for both hard and soft constraints, as the constr_m matrix contains the needed noise-term. 
+	 */
+	if (problem->sub_constr && problem->sub_constr->nc > 0) {
+#pragma omp parallel for private(i, iii, k, j, jjj, kk, value)
+		for (i = 0; i < n; i++) {
+			iii = inv_remap[i];
+			for (k = -1; (k = (int) map_id_next(Qinv_L[i], k)) != -1;) {
+				j = Qinv_L[i]->contents[k].key;
+				jjj = inv_remap[j];
+				map_id_get(Qinv_L[i], j, &value);
+				for (kk = 0; kk < problem->sub_constr->nc; kk++) {
+					value -= problem->constr_m[iii + kk * n] * problem->qi_at_m[jjj + kk * n];
+				}
+				map_id_set(Qinv_L[i], j, value);
+			}
+		}
+	}
+
+	/*
+	 * done. store Qinv 
+	 */
+	problem->sub_inverse = Calloc(1, GMRFLib_Qinv_tp);
+	problem->sub_inverse->Qinv = Qinv_L;
+
+	/*
+	 * compute the mapping for lookup using GMRFLib_Qinv_get(). here, the user lookup using a global index, which is then
+	 * transformed to the reordered sub_graph. 
+	 */
+	problem->sub_inverse->mapping = mapping = Calloc(1, map_ii);
+	map_ii_init_hint(mapping, n);
+	for (i = 0; i < n; i++) {
+		map_ii_set(mapping, problem->sub_graph->mothergraph_idx[i], problem->sub_sm_fact.remap[i]);
+	}
+
+	/*
+	 * cleanup 
+	 */
+	Free(cov_val);
+	Free(inv_remap);
+	Free(rremove);
+	Free(nbs);
+
+#undef Cov
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_compute_Qinv_PROFILE(void)
+
+/* 
+   from here is for internal use only. not documented
+*/
+int GMRFLib_bitmap_factorisation_PROFILE__intern(const char *filename, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph)
 {
-	abort();
+#define NBitsInByte 8
+#define SETBIT(im, jm, m, N) {						\
+		int local_im = (int)((im) * reduce_factor);		\
+		int local_jm = (int)((jm) * reduce_factor);		\
+		if (GMRFLib_bitmap_swap){				\
+			int itmp = local_im;				\
+			local_im = N-1-local_jm;			\
+			local_jm = itmp;				\
+		}							\
+		int ii = (local_im)/NBitsInByte;			\
+		GMRFLib_setbit(&bitmap[ ii+(local_jm)*(m)], (unsigned int) (NBitsInByte-1-((local_im)-ii*NBitsInByte))); \
+	}
+
+	int i, j, n = graph->n, N, m;
+	double reduce_factor;
+	unsigned char *bitmap;
+	FILE *fp;
+
+	if (GMRFLib_bitmap_max_dimension > 0 && n > GMRFLib_bitmap_max_dimension) {
+		N = GMRFLib_bitmap_max_dimension;
+		reduce_factor = (double) N / (double) n;
+	} else {
+		N = n;
+		reduce_factor = 1.0;
+	}
+
+	m = N / NBitsInByte;
+	if (m * NBitsInByte != N)
+		m++;
+	bitmap = Calloc(m * N, unsigned char);
+
+	for (i = 0; i < profile->n; i++) {
+		for (j = profile->first[i]; j <= i; j++) {
+			if (!ISZERO(profile->val[PIDX(profile, i, j)])) {
+				SETBIT(j, i, m, N);
+			}
+		}
+	}
+
+	fp = fopen(filename, "w");
+	if (fp) {
+		fprintf(fp, "P4\n%1d %1d\n", N, N);
+		for (i = 0; i < N; i++) {
+			fwrite(&bitmap[i * m], (unsigned int) m, 1, fp);
+		}
+		fclose(fp);
+	} else {
+		GMRFLib_ERROR(GMRFLib_EOPENFILE);
+	}
+	Free(bitmap);
 	return GMRFLib_SUCCESS;
+#undef SETBIT
+#undef NBitsInByte
 }
-
-int GMRFLib_bitmap_factorisation_PROFILE(void)
+int GMRFLib_bitmap_factorisation_PROFILE(const char *filename_body, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph)
 {
-	abort();
+	/*
+	 * create a bitmap-file of the factorization 
+	 */
+	char *filename;
+
+	GMRFLib_EWRAP0(GMRFLib_sprintf(&filename, "%s_L.pbm", (filename_body ? filename_body : "profile_L")));
+	GMRFLib_EWRAP0(GMRFLib_bitmap_factorisation_PROFILE__intern(filename, profile, graph));
+	Free(filename);
+
 	return GMRFLib_SUCCESS;
 }
+
+#undef PIDX
@@ -32,7 +32,7 @@
 
 /*!
   \file smtp-profile.h
-  \brief Typedefs and defines for the \ref smtp-profile.c (template only).
+  \brief Typedefs and defines for the \ref smtp-profile.c
 */
 
 #ifndef __GMRFLib_SMTP_PROFILE_H__
@@ -57,20 +57,27 @@ __BEGIN_DECLS
 
 /*
  */
-int GMRFLib_compute_reordering_PROFILE(void);
-int GMRFLib_build_sparse_matrix_PROFILE(void);
-int GMRFLib_factorise_sparse_matrix_PROFILE(void);
-int GMRFLib_free_fact_sparse_matrix_PROFILE(void);
-int GMRFLib_solve_lt_sparse_matrix_PROFILE(void);
-int GMRFLib_solve_llt_sparse_matrix_PROFILE(void);
-int GMRFLib_solve_l_sparse_matrix_PROFILE(void);
-int GMRFLib_solve_lt_sparse_matrix_special_PROFILE(void);
-int GMRFLib_solve_l_sparse_matrix_special_PROFILE(void);
-int GMRFLib_comp_cond_meansd_PROFILE(void);
-int GMRFLib_log_determinant_PROFILE(void);
-int GMRFLib_compute_Qinv_PROFILE(void);
-
-int GMRFLib_bitmap_factorisation_PROFILE(void);
+GMRFLib_profile_tp *GMRFLib_duplicate_fact_PROFILE(GMRFLib_profile_tp * profile);
+GMRFLib_sizeof_tp GMRFLib_sizeof_fact_PROFILE(GMRFLib_profile_tp * profile);
+int GMRFLib_bitmap_factorisation_PROFILE(const char *filename_body, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph);
+int GMRFLib_bitmap_factorisation_PROFILE__intern(const char *filename, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph);
+int GMRFLib_build_sparse_matrix_PROFILE(GMRFLib_profile_tp ** profile, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph,
+					int *remap);
+int GMRFLib_comp_cond_meansd_PROFILE(double *cmean, double *csd, int indx, double *x, int remapped, GMRFLib_profile_tp * profile,
+				     GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_compute_Qinv_PROFILE(GMRFLib_problem_tp * problem, int storage);
+int GMRFLib_compute_reordering_PROFILE(int **remap, GMRFLib_graph_tp * graph);
+int GMRFLib_factorise_sparse_matrix_PROFILE(GMRFLib_profile_tp * profile, GMRFLib_fact_info_tp * finfo, GMRFLib_graph_tp * graph);
+int GMRFLib_free_fact_sparse_matrix_PROFILE(GMRFLib_profile_tp * profile);
+int GMRFLib_log_determinant_PROFILE(double *logdet, GMRFLib_profile_tp * profile);
+int GMRFLib_solve_l_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_solve_l_sparse_matrix_special_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap,
+						  int findx, int toindx, int remapped);
+int GMRFLib_solve_llt_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_solve_lt_sparse_matrix_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_solve_lt_sparse_matrix_special_PROFILE(double *rhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap,
+						   int findx, int toindx, int remapped);
+int GMRFLib_solve_nrhs_sparse_matrix_PROFILE(double *rhs, int nrhs, GMRFLib_profile_tp * profile, GMRFLib_graph_tp * graph, int *remap, int what);
 
 __END_DECLS
 #endif
@@ -40,6 +40,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if !defined(WINDOWS)
+#include <sys/mman.h>
+#endif
+#include <sys/stat.h>
 #if !defined(__FreeBSD__)
 #include <malloc.h>
 #endif
@@ -177,7 +183,7 @@ supernodal_factor_matrix *GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(su
 	}
 
 	supernodal_factor_matrix *LL = NULL;
-	int n, np, n_sn;
+	int n_sn;
 
 	if (!L) {
 		return NULL;
@@ -188,26 +194,33 @@ supernodal_factor_matrix *GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(su
 	LL->n = L->n;
 	LL->n_sn = L->n_sn;
 
-	n = LL->n;
-	np = n + 1;
 	n_sn = LL->n_sn;
 
-	DUPLICATE(sn_size, np, int);
-	DUPLICATE(sn_up_size, np, int);
-	DUPLICATE(first_child, np, int);
-	DUPLICATE(next_child, np, int);
-	DUPLICATE(parent, np, int);
+	/*
+	 * the symbolic part is not changed by the numerical factorisation, so it is shared (read-only) and reference
+	 * counted. only the numerical part is copied.
+	 */
+#pragma omp critical (GMRFLib_taucs_symbolic)
+	{
+		if (!L->shared) {
+			GMRFLib_taucs_symbolic_tp *sh = Calloc(1, GMRFLib_taucs_symbolic_tp);
+			sh->refcount = 1;
+			L->shared = (void *) sh;
+		}
+		((GMRFLib_taucs_symbolic_tp *) L->shared)->refcount++;
+	}
+	LL->shared = L->shared;
+	LL->sn_size = L->sn_size;
+	LL->sn_up_size = L->sn_up_size;
+	LL->first_child = L->first_child;
+	LL->next_child = L->next_child;
+	LL->parent = L->parent;
+	LL->sn_struct = L->sn_struct;
+
 	DUPLICATE(sn_blocks_ld, n_sn, int);
 	DUPLICATE(up_blocks_ld, n_sn, int);
 
 	{
-		{
-			int i;
-			LL->sn_struct = (int **) Calloc(n_sn, int *);
-			for (i = 0; i < LL->n_sn; i++) {
-				DUPLICATE(sn_struct[i], LL->sn_up_size[i], int);
-			}
-		}
 		{
 			int i;
 			LL->sn_blocks = (double **) Calloc(n_sn, double *);
@@ -228,6 +241,309 @@ supernodal_factor_matrix *GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(su
 	return LL;
 }
 
+/*!
+  \brief Free a supernodal factor, which may share its symbolic part with other copies.
+
+  The shared symbolic part is free'd (or unmapped) together with the last copy.
+*/
+void GMRFLib_my_taucs_supernodal_factor_free(supernodal_factor_matrix * L)
+{
+	GMRFLib_taucs_symbolic_tp *sh = NULL;
+	int sn, last = 0;
+
+	if (!L) {
+		return;
+	}
+	if (!L->shared) {
+		taucs_supernodal_factor_free(L);
+		return;
+	}
+
+	sh = (GMRFLib_taucs_symbolic_tp *) L->shared;
+#pragma omp critical (GMRFLib_taucs_symbolic)
+	{
+		last = (--(sh->refcount) == 0);
+	}
+
+	if (L->sn_blocks) {
+		for (sn = 0; sn < L->n_sn; sn++) {
+			free(L->sn_blocks[sn]);
+		}
+	}
+	if (L->up_blocks) {
+		for (sn = 0; sn < L->n_sn; sn++) {
+			free(L->up_blocks[sn]);
+		}
+	}
+	free(L->sn_blocks);
+	free(L->up_blocks);
+	free(L->sn_blocks_ld);
+	free(L->up_blocks_ld);
+
+	if (last) {
+#if !defined(WINDOWS)
+		if (sh->map) {
+			/*
+			 * the arrays are in the mapped file, and only the array of pointers to the row-structures is allocated
+			 */
+			munmap(sh->map, sh->map_len);
+			Free(L->sn_struct);
+		} else
+#endif
+		{
+			if (L->sn_struct) {
+				for (sn = 0; sn < L->n_sn; sn++) {
+					free(L->sn_struct[sn]);
+				}
+			}
+			free(L->sn_struct);
+			free(L->sn_size);
+			free(L->sn_up_size);
+			free(L->first_child);
+			free(L->next_child);
+			free(L->parent);
+		}
+		Free(sh);
+	}
+	free(L);
+}
+
+#if !defined(WINDOWS)
+/*
+ * The on-disk cache of symbolic factorisations. The file contains a header followed by the arrays sn_size, sn_up_size,
+ * first_child, next_child (and parent if present), all of length n+1, and then the row-structures of the supernodes. It is
+ * mapped read-only and shared by all copies of the factor.
+ */
+typedef struct {
+	char magic[8];
+	int version;
+	int n;
+	int n_sn;
+	int flags;
+	int has_parent;
+	int dummy;
+	unsigned long int hash;
+	unsigned long int nstruct;
+} GMRFLib_taucs_symbolic_header_tp;
+
+#define GMRFLib_TAUCS_SYMBOLIC_MAGIC "GMRFsymb"
+#define GMRFLib_TAUCS_SYMBOLIC_VERSION (1)
+#define GMRFLib_TAUCS_SYMBOLIC_CACHE_LEN (8)
+
+static unsigned long int GMRFLib_taucs_pattern_hash(taucs_ccs_matrix * L)
+{
+	/*
+	 * FNV-1a over the pattern of the (reordered) matrix, one int at the time
+	 */
+	uint64_t h = (uint64_t) 14695981039346656037ULL;
+	int i, nnz = L->colptr[L->n];
+
+	h = (h ^ (uint64_t) (unsigned int) L->n) * (uint64_t) 1099511628211ULL;
+	for (i = 0; i <= L->n; i++) {
+		h = (h ^ (uint64_t) (unsigned int) L->colptr[i]) * (uint64_t) 1099511628211ULL;
+	}
+	for (i = 0; i < nnz; i++) {
+		h = (h ^ (uint64_t) (unsigned int) L->rowind[i]) * (uint64_t) 1099511628211ULL;
+	}
+	return (unsigned long int) h;
+}
+
+static char *GMRFLib_taucs_symbolic_fnm(unsigned long int hash)
+{
+	char *fnm = NULL;
+
+	GMRFLib_sprintf(&fnm, "%s/symbolic-%016lx.dat", GMRFLib_reorder_cache_dir, hash);
+	return fnm;
+}
+
+static int GMRFLib_taucs_symbolic_write(supernodal_factor_matrix * L, unsigned long int hash)
+{
+	GMRFLib_taucs_symbolic_header_tp head;
+	char *fnm = GMRFLib_taucs_symbolic_fnm(hash), *tmp = NULL;
+	size_t np = (size_t) L->n + 1;
+	int sn, ok;
+	FILE *fp;
+
+	memset((void *) &head, 0, sizeof(head));
+	memcpy((void *) head.magic, (void *) GMRFLib_TAUCS_SYMBOLIC_MAGIC, sizeof(head.magic));
+	head.version = GMRFLib_TAUCS_SYMBOLIC_VERSION;
+	head.n = L->n;
+	head.n_sn = L->n_sn;
+	head.flags = L->flags;
+	head.has_parent = (L->parent ? 1 : 0);
+	head.hash = hash;
+	for (sn = 0; sn < L->n_sn; sn++) {
+		head.nstruct += (unsigned long int) L->sn_up_size[sn];
+	}
+
+	/*
+	 * write to a temporary file and rename it, so that concurrent runs never map a partial file
+	 */
+	GMRFLib_sprintf(&tmp, "%s.%1d", fnm, (int) getpid());
+	fp = fopen(tmp, "wb");
+	if (fp) {
+		ok = (fwrite(&head, sizeof(head), 1, fp) == 1);
+		ok = ok && (fwrite(L->sn_size, sizeof(int), np, fp) == np);
+		ok = ok && (fwrite(L->sn_up_size, sizeof(int), np, fp) == np);
+		ok = ok && (fwrite(L->first_child, sizeof(int), np, fp) == np);
+		ok = ok && (fwrite(L->next_child, sizeof(int), np, fp) == np);
+		if (head.has_parent) {
+			ok = ok && (fwrite(L->parent, sizeof(int), np, fp) == np);
+		}
+		for (sn = 0; sn < L->n_sn && ok; sn++) {
+			ok = (fwrite(L->sn_struct[sn], sizeof(int), (size_t) L->sn_up_size[sn], fp) == (size_t) L->sn_up_size[sn]);
+		}
+		ok = (fclose(fp) == 0) && ok;
+		if (!ok || rename(tmp, fnm)) {
+			remove(tmp);
+		}
+	}
+	Free(tmp);
+	Free(fnm);
+
+	return GMRFLib_SUCCESS;
+}
+
+static supernodal_factor_matrix *GMRFLib_taucs_symbolic_read(unsigned long int hash, int n)
+{
+	GMRFLib_taucs_symbolic_header_tp *head = NULL;
+	GMRFLib_taucs_symbolic_tp *sh = NULL;
+	supernodal_factor_matrix *L = NULL;
+	char *fnm = GMRFLib_taucs_symbolic_fnm(hash);
+	struct stat st;
+	size_t np = (size_t) n + 1, len;
+	void *map;
+	int fd, sn, *ip;
+
+	fd = open(fnm, O_RDONLY);
+	Free(fnm);
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &st) || (size_t) st.st_size < sizeof(GMRFLib_taucs_symbolic_header_tp)) {
+		close(fd);
+		return NULL;
+	}
+	map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+
+	head = (GMRFLib_taucs_symbolic_header_tp *) map;
+	len = sizeof(GMRFLib_taucs_symbolic_header_tp) + sizeof(int) * ((4 + (head->has_parent ? 1 : 0)) * np + head->nstruct);
+	if (memcmp(head->magic, GMRFLib_TAUCS_SYMBOLIC_MAGIC, sizeof(head->magic)) || head->version != GMRFLib_TAUCS_SYMBOLIC_VERSION ||
+	    head->n != n || head->hash != hash || (size_t) st.st_size != len) {
+		munmap(map, (size_t) st.st_size);
+		return NULL;
+	}
+
+	sh = Calloc(1, GMRFLib_taucs_symbolic_tp);
+	sh->refcount = 1;
+	sh->map = map;
+	sh->map_len = len;
+
+	L = Calloc(1, supernodal_factor_matrix);
+	L->flags = head->flags;
+	L->uplo = 'l';
+	L->n = head->n;
+	L->n_sn = head->n_sn;
+	L->shared = (void *) sh;
+
+	ip = (int *) ((char *) map + sizeof(GMRFLib_taucs_symbolic_header_tp));
+	L->sn_size = ip;
+	ip += np;
+	L->sn_up_size = ip;
+	ip += np;
+	L->first_child = ip;
+	ip += np;
+	L->next_child = ip;
+	ip += np;
+	if (head->has_parent) {
+		L->parent = ip;
+		ip += np;
+	}
+	L->sn_struct = Calloc(IMAX(1, L->n_sn), int *);
+	for (sn = 0; sn < L->n_sn; sn++) {
+		L->sn_struct[sn] = ip;
+		ip += L->sn_up_size[sn];
+	}
+
+	L->sn_blocks_ld = Calloc(IMAX(1, L->n_sn), int);
+	L->sn_blocks = Calloc(IMAX(1, L->n_sn), double *);
+	L->up_blocks_ld = Calloc(IMAX(1, L->n_sn), int);
+	L->up_blocks = Calloc(IMAX(1, L->n_sn), double *);
+
+	return L;
+}
+#endif							       /* !defined(WINDOWS) */
+
+/*!
+  \brief Return the symbolic factorisation of L from the cache, or NULL if the cache is not in use.
+
+  If \c GMRFLib_reorder_cache_dir is set and the matrix is large, the symbolic factorisation is looked up in the process-wide
+  cache, then in the on-disk cache (keyed by a hash of the pattern of L, which includes the reordering), and is computed and
+  stored only if both fail. All factors returned for the same pattern share one read-only copy of the symbolic part.
+
+  The cache needs mmap() and is not in use on Windows, where the symbolic factorisation is always computed in-core.
+*/
+supernodal_factor_matrix *GMRFLib_my_taucs_symbolic_cache(taucs_ccs_matrix * L)
+{
+#if defined(WINDOWS)
+	return NULL;
+#else
+	static struct {
+		unsigned long int hash;
+		int n;
+		supernodal_factor_matrix *symb_fact;
+	} cache[GMRFLib_TAUCS_SYMBOLIC_CACHE_LEN];
+	static int ncache = 0;
+
+	supernodal_factor_matrix *master = NULL, *symb_fact = NULL;
+	unsigned long int hash;
+	int i;
+
+	if (!GMRFLib_reorder_cache_dir || !L || L->n < GMRFLib_TAUCS_SYMBOLIC_CACHE_MIN_N) {
+		return NULL;
+	}
+
+	hash = GMRFLib_taucs_pattern_hash(L);
+#pragma omp critical (GMRFLib_taucs_symbolic_cache)
+	{
+		for (i = 0; i < ncache && !master; i++) {
+			if (cache[i].hash == hash && cache[i].n == L->n) {
+				master = cache[i].symb_fact;
+			}
+		}
+		if (!master) {
+			master = GMRFLib_taucs_symbolic_read(hash, L->n);
+			if (!master) {
+				master = (supernodal_factor_matrix *) taucs_ccs_factor_llt_symbolic(L);
+				if (master) {
+					GMRFLib_taucs_symbolic_write(master, hash);
+				}
+			}
+			if (master && ncache < GMRFLib_TAUCS_SYMBOLIC_CACHE_LEN) {
+				cache[ncache].hash = hash;
+				cache[ncache].n = L->n;
+				cache[ncache].symb_fact = master;
+				ncache++;
+			} else {
+				/*
+				 * no room, so the caller gets the master itself
+				 */
+				symb_fact = master;
+			}
+		}
+	}
+
+	if (!symb_fact && master) {
+		symb_fact = GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(master);
+	}
+	return symb_fact;
+#endif
+}
+
 GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_nnz(supernodal_factor_matrix * L)
 {
 	/*
@@ -266,6 +582,26 @@ GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_computing_time(super
 	}
 	return siz;
 }
+double GMRFLib_my_taucs_supernodal_factor_matrix_flops(supernodal_factor_matrix * L)
+{
+	/*
+	 * return the number of flops needed to factorise L, which is the sum of the squared column-counts
+	 */
+	double flops = 0.0, c;
+	int sn, jp;
+
+	if (!L) {
+		return flops;
+	}
+
+	for (sn = 0; sn < L->n_sn; sn++) {
+		for (jp = 0; jp < L->sn_size[sn]; jp++) {
+			c = (double) (L->sn_up_size[sn] - jp);
+			flops += c * c;
+		}
+	}
+	return flops;
+}
 GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_sizeof(supernodal_factor_matrix * L)
 {
 	/*
@@ -432,10 +768,103 @@ int GMRFLib_compute_reordering_TAUCS_orig(int **remap, GMRFLib_graph_tp * graph)
 
 	return GMRFLib_SUCCESS;
 }
+static char *GMRFLib_taucs_remap_fnm(GMRFLib_graph_tp * graph, GMRFLib_reorder_tp reorder, GMRFLib_global_node_tp * gn_ptr, int nseps)
+{
+	char *fnm = NULL;
+	unsigned long int h;
+
+	h = GMRFLib_graph_hash(graph);
+	h ^= ((unsigned long int) reorder + 1UL) * 0x9e3779b97f4a7c15UL;
+	h ^= ((unsigned long int) nseps + 1UL) * 0xc2b2ae3d27d4eb4fUL;
+	if (gn_ptr) {
+		h ^= (unsigned long int) (gn_ptr->degree) * 0x94d049bb133111ebUL;
+		h ^= (unsigned long int) (gn_ptr->factor * 1.0E6) * 0xbf58476d1ce4e5b9UL;
+	}
+	GMRFLib_sprintf(&fnm, "%s/remap-%016lx.dat", GMRFLib_reorder_cache_dir, h);
+
+	return fnm;
+}
+static int GMRFLib_taucs_remap_read(int **remap, int n, const char *fnm)
+{
+	int nn = -1, i, ok = 0, *r = NULL;
+	char *seen = NULL;
+	FILE *fp;
+
+	fp = fopen(fnm, "rb");
+	if (!fp) {
+		return !GMRFLib_SUCCESS;
+	}
+	if (fread(&nn, sizeof(int), 1, fp) == 1 && nn == n) {
+		r = Calloc(n, int);
+		if (fread(r, sizeof(int), (size_t) n, fp) == (size_t) n) {
+			/*
+			 * make sure its a permutation
+			 */
+			seen = Calloc(n, char);
+			for (i = 0, ok = 1; i < n && ok; i++) {
+				ok = (r[i] >= 0 && r[i] < n && !seen[r[i]]);
+				if (ok) {
+					seen[r[i]] = 1;
+				}
+			}
+			Free(seen);
+		}
+	}
+	fclose(fp);
+
+	if (!ok) {
+		Free(r);
+		return !GMRFLib_SUCCESS;
+	}
+	*remap = r;
+	return GMRFLib_SUCCESS;
+}
+static int GMRFLib_taucs_remap_write(int *remap, int n, const char *fnm)
+{
+	char *tmp = NULL;
+	int ok;
+	FILE *fp;
+
+	GMRFLib_sprintf(&tmp, "%s.%1d", fnm, (int) getpid());
+	fp = fopen(tmp, "wb");
+	if (fp) {
+		ok = (fwrite(&n, sizeof(int), 1, fp) == 1);
+		ok = ok && (fwrite(remap, sizeof(int), (size_t) n, fp) == (size_t) n);
+		ok = (fclose(fp) == 0) && ok;
+		if (!ok || rename(tmp, fnm)) {
+			remove(tmp);
+		}
+	}
+	Free(tmp);
+
+	return GMRFLib_SUCCESS;
+}
 int GMRFLib_compute_reordering_TAUCS(int **remap, GMRFLib_graph_tp * graph, GMRFLib_reorder_tp reorder, GMRFLib_global_node_tp * gn_ptr)
 {
 	/*
-	 * new improved version which treats global nodes spesifically. 
+	 * for large graphs, use the on-disk cache of reorderings, if in use 
+	 */
+	if (GMRFLib_reorder_cache_dir && graph && graph->n >= GMRFLib_TAUCS_SYMBOLIC_CACHE_MIN_N) {
+		char *fnm = GMRFLib_taucs_remap_fnm(graph, reorder, gn_ptr, GMRFLib_metis_nseps);
+		int retval = GMRFLib_SUCCESS;
+
+		if (GMRFLib_taucs_remap_read(remap, graph->n, fnm) != GMRFLib_SUCCESS) {
+			retval = GMRFLib_compute_reordering_TAUCS_nseps(remap, graph, reorder, gn_ptr, GMRFLib_metis_nseps);
+			if (retval == GMRFLib_SUCCESS && *remap) {
+				GMRFLib_taucs_remap_write(*remap, graph->n, fnm);
+			}
+		}
+		Free(fnm);
+
+		return retval;
+	}
+
+	return GMRFLib_compute_reordering_TAUCS_nseps(remap, graph, reorder, gn_ptr, GMRFLib_metis_nseps);
+}
+int GMRFLib_compute_reordering_TAUCS_nseps(int **remap, GMRFLib_graph_tp * graph, GMRFLib_reorder_tp reorder, GMRFLib_global_node_tp * gn_ptr, int nseps)
+{
+	/*
+	 * new improved version which treats global nodes spesifically. `nseps' is the number of separators used by METIS.
 	 */
 	int i, j, k, ic, ne, n, ns, nnz, *perm = NULL, *iperm = NULL, limit, free_subgraph, *iperm_new = NULL, simple;
 	char *fixed = NULL, *p = NULL;
@@ -544,7 +973,7 @@ int GMRFLib_compute_reordering_TAUCS(int **remap, GMRFLib_graph_tp * graph, GMRF
 			break;
 		case GMRFLib_REORDER_DEFAULT:
 		case GMRFLib_REORDER_METIS:
-			p = GMRFLib_strdup("metis");
+			GMRFLib_sprintf(&p, "metis:%1d", IMAX(1, nseps));
 			break;
 		case GMRFLib_REORDER_GENMMD:
 			p = GMRFLib_strdup("genmmd");
@@ -571,7 +1000,17 @@ int GMRFLib_compute_reordering_TAUCS(int **remap, GMRFLib_graph_tp * graph, GMRF
 			GMRFLib_ASSERT(0 == 1, GMRFLib_ESNH);
 			p = NULL;
 		}
-		taucs_ccs_order(Q, &perm, &iperm, p);
+		if (!strncmp(p, "metis", 5)) {
+			/*
+			 * METIS use the global random number generator in libc, so it is not thread-safe.
+			 */
+#pragma omp critical (GMRFLib_metis)
+			{
+				taucs_ccs_order(Q, &perm, &iperm, p);
+			}
+		} else {
+			taucs_ccs_order(Q, &perm, &iperm, p);
+		}
 		Free(p);
 
 		GMRFLib_ASSERT(iperm, GMRFLib_ESNH);
@@ -656,126 +1095,294 @@ int GMRFLib_compute_reordering_TAUCS(int **remap, GMRFLib_graph_tp * graph, GMRF
 
 	return GMRFLib_SUCCESS;
 }
-int GMRFLib_build_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap)
+/*
+  compute the pattern of the reordered Q. the layout is identical to the one produced by taucs_ccs_permute_symmetrically() applied to
+  the (unpermuted) matrix in graph-order, so the values are stored bit-for-bit at the same positions as before.
+*/
+GMRFLib_Qpattern_tp *GMRFLib_build_Qpattern_TAUCS(GMRFLib_graph_tp * graph, int *remap)
 {
-	int i, j, k, ic, ne, n, nnz, *perm = NULL, *iperm = NULL, id, nan_error = 0;
-	taucs_ccs_matrix *Q = NULL;
-
-	id = GMRFLib_thread_id;
+	int i, j, k, ic, I, J, n, *len = NULL;
+	GMRFLib_Qpattern_tp *qp = NULL;
 
 	if (!graph || graph->n == 0) {
-		*L = NULL;
-		return GMRFLib_SUCCESS;
+		return NULL;
 	}
 
 	n = graph->n;
-	for (i = 0, nnz = n; i < n; i++) {
-		nnz += graph->nnbs[i];
-	}
-
-	Q = taucs_ccs_create(n, n, nnz, TAUCS_DOUBLE);
-	GMRFLib_ASSERT(Q, GMRFLib_EMEMORY);
-	Q->flags = (TAUCS_DOUBLE | TAUCS_SYMMETRIC | TAUCS_TRIANGULAR | TAUCS_LOWER);
-	Q->colptr[0] = 0;
-
-#if defined(_OPENMP)
-	/*
-	 * first, do a first pass to set the indices; then fill the matrix using omp 
-	 */
-	int *ic_idx = Calloc(n, int);
+	qp = Calloc(1, GMRFLib_Qpattern_tp);
+	qp->n = n;
+	qp->row_start = Calloc(n + 1, int);
 
 	for (i = 0, ic = 0; i < n; i++) {
-		Q->rowind[ic] = i;
-		ic_idx[i] = ic;
+		qp->row_start[i] = ic;
 		ic++;
-		ne = 1;
+		for (k = 0; k < graph->nnbs[i]; k++) {
+			if (graph->nbs[i][k] > i) {
+				break;
+			}
+			ic++;
+		}
+	}
+	qp->row_start[n] = ic;
+	qp->nnz = ic;
+	qp->colptr = Calloc(n + 1, int);
+	qp->rowind = Calloc(qp->nnz, int);
+	qp->vidx = Calloc(qp->nnz, int);
 
+	/*
+	 * remap is the inverse permutation, as used in taucs_ccs_permute_symmetrically()
+	 */
+	len = Calloc(n, int);
+	for (i = 0; i < n; i++) {
+		len[remap[i]]++;
 		for (k = 0; k < graph->nnbs[i]; k++) {
 			j = graph->nbs[i][k];
 			if (j > i) {
 				break;
 			}
-			Q->rowind[ic] = j;
-			ic++;
-			ne++;
+			len[IMIN(remap[i], remap[j])]++;
 		}
-		Q->colptr[i + 1] = Q->colptr[i] + ne;
 	}
-#pragma omp parallel for private(i, ic, k, j)
-	for (i = 0; i < n; i++) {
-		double val;
-
-		ic = ic_idx[i];
-		GMRFLib_thread_id = id;
-
-		val = Qfunc(i, i, Qfunc_arg);
-		GMRFLib_STOP_IF_NAN_OR_INF(val, i, i);
-		Q->values.d[ic++] = val;
+	qp->colptr[0] = 0;
+	for (j = 0; j < n; j++) {
+		qp->colptr[j + 1] = qp->colptr[j] + len[j];
+		len[j] = qp->colptr[j];
+	}
 
+	for (i = 0, ic = 0; i < n; i++) {
+		J = remap[i];
+		qp->rowind[len[J]] = J;
+		qp->vidx[ic++] = len[J]++;
 		for (k = 0; k < graph->nnbs[i]; k++) {
 			j = graph->nbs[i][k];
 			if (j > i) {
 				break;
 			}
+			I = IMAX(remap[i], remap[j]);
+			J = IMIN(remap[i], remap[j]);
+			qp->rowind[len[J]] = I;
+			qp->vidx[ic++] = len[J]++;
+		}
+	}
+	Free(len);
 
-			val = Qfunc(i, j, Qfunc_arg);
-			GMRFLib_STOP_IF_NAN_OR_INF(val, i, j);
-			Q->values.d[ic++] = val;
+	return qp;
+}
+
+GMRFLib_Qpattern_tp *GMRFLib_share_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp)
+{
+	/*
+	 * the pattern is read-only, so we just increase the counter of additional users, as for GMRFLib_share_graph()
+	 */
+	if (qp) {
+#pragma omp critical (GMRFLib_nref)
+		{
+			qp->nref++;
 		}
 	}
-	GMRFLib_thread_id = id;
-	Free(ic_idx);
+	return qp;
+}
 
-	if (GMRFLib_catch_error_for_inla) {
-		if (nan_error) {
-			return !GMRFLib_SUCCESS;
+int GMRFLib_free_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp)
+{
+	int shared = 0;
+
+	if (!qp) {
+		return GMRFLib_SUCCESS;
+	}
+
+	/*
+	 * if the pattern is shared, then just drop this reference
+	 */
+#pragma omp critical (GMRFLib_nref)
+	{
+		if (qp->nref > 0) {
+			qp->nref--;
+			shared = 1;
 		}
 	}
-#else
-	for (i = 0, ic = 0; i < n; i++) {
-		double val;
+	if (shared) {
+		return GMRFLib_SUCCESS;
+	}
 
-		Q->rowind[ic] = i;
+	if (qp->Q) {
+		/*
+		 * colptr and rowind belongs to the pattern
+		 */
+		Free(qp->Q->values.d);
+		Free(qp->Q);
+	}
+	Free(qp->colptr);
+	Free(qp->rowind);
+	Free(qp->row_start);
+	Free(qp->vidx);
+	Free(qp);
 
-		val = Qfunc(i, i, Qfunc_arg);
-		GMRFLib_STOP_IF_NAN_OR_INF(val, i, i);
-		Q->values.d[ic] = val;
+	return GMRFLib_SUCCESS;
+}
 
-		ic++;
-		ne = 1;
+GMRFLib_sizeof_tp GMRFLib_sizeof_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp)
+{
+	if (!qp) {
+		return 0;
+	}
+	return sizeof(GMRFLib_Qpattern_tp) + (2 * (qp->n + 1) + 2 * qp->nnz) * sizeof(int) +
+	    (qp->Q ? sizeof(taucs_ccs_matrix) + qp->nnz * sizeof(double) : 0);
+}
 
-		for (k = 0; k < graph->nnbs[i]; k++) {
-			j = graph->nbs[i][k];
-			if (j > i) {
-				break;
+static taucs_ccs_matrix *GMRFLib_claim_Q_TAUCS(GMRFLib_Qpattern_tp * qp)
+{
+	/*
+	 * return the matrix stored in the pattern, or a temporary one if it is in use. in both cases, colptr and rowind are those
+	 * of the pattern, so only the values are to be filled in.
+	 */
+	taucs_ccs_matrix *Q = NULL;
+
+#pragma omp critical (GMRFLib_Qpattern)
+	{
+		if (!qp->Q_in_use) {
+			if (!qp->Q) {
+				qp->Q = Calloc(1, taucs_ccs_matrix);
+				qp->Q->values.d = Calloc(IMAX(1, qp->nnz), double);
 			}
-			Q->rowind[ic] = j;
+			qp->Q_in_use = 1;
+			Q = qp->Q;
+		}
+	}
+	if (!Q) {
+		Q = Calloc(1, taucs_ccs_matrix);
+		Q->values.d = Calloc(IMAX(1, qp->nnz), double);
+	}
+	Q->n = Q->m = qp->n;
+	Q->flags = (TAUCS_DOUBLE | TAUCS_SYMMETRIC | TAUCS_TRIANGULAR | TAUCS_LOWER);
+	Q->colptr = qp->colptr;
+	Q->rowind = qp->rowind;
 
-			val = Qfunc(i, j, Qfunc_arg);
-			GMRFLib_STOP_IF_NAN_OR_INF(val, i, j);
-			Q->values.d[ic] = val;
+	return Q;
+}
 
-			ic++;
-			ne++;
+static int GMRFLib_release_Q_TAUCS(taucs_ccs_matrix * Q, GMRFLib_Qpattern_tp * qp)
+{
+	/*
+	 * release a matrix from GMRFLib_claim_Q_TAUCS(). matrices which do not share the pattern, are free'd as usual
+	 */
+	if (!Q) {
+		return GMRFLib_SUCCESS;
+	}
+	if (!qp || Q->colptr != qp->colptr) {
+		taucs_ccs_free(Q);
+	} else if (Q == qp->Q) {
+#pragma omp critical (GMRFLib_Qpattern)
+		{
+			qp->Q_in_use = 0;
 		}
-		Q->colptr[i + 1] = Q->colptr[i] + ne;
+	} else {
+		Free(Q->values.d);
+		Free(Q);
 	}
+	return GMRFLib_SUCCESS;
+}
+
+int GMRFLib_build_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap,
+				      GMRFLib_Qpattern_tp ** Qpattern)
+{
+	/*
+	 * build the reordered Q. the pattern is computed once and stored in *Qpattern (if Qpattern != NULL); later calls only fill in
+	 * the values at their permuted positions, in the matrix kept with the pattern, so there is no need to build and permute a
+	 * temporary matrix.
+	 */
+	int i, j, k, n, id, nan_error = 0;
+	taucs_ccs_matrix *Q = NULL;
+	GMRFLib_Qpattern_tp *qp = NULL;
+	GMRFLib_tabulate_Qfunc_arg_tp *tab = NULL;
+
+	id = GMRFLib_thread_id;
+
+	if (!graph || graph->n == 0) {
+		*L = NULL;
+		return GMRFLib_SUCCESS;
+	}
+
+	n = graph->n;
+	if (Qpattern) {
+		if (!*Qpattern) {
+			*Qpattern = GMRFLib_build_Qpattern_TAUCS(graph, remap);
+		}
+		qp = *Qpattern;
+	} else {
+		qp = GMRFLib_build_Qpattern_TAUCS(graph, remap);
+	}
+	GMRFLib_ASSERT(qp && qp->n == n, GMRFLib_ESNH);
+
+	if (Qpattern) {
+		Q = GMRFLib_claim_Q_TAUCS(qp);
+	} else {
+		Q = taucs_ccs_create(n, n, qp->nnz, TAUCS_DOUBLE);
+		GMRFLib_ASSERT(Q, GMRFLib_EMEMORY);
+		Q->flags = (TAUCS_DOUBLE | TAUCS_SYMMETRIC | TAUCS_TRIANGULAR | TAUCS_LOWER);
+		memcpy(Q->colptr, qp->colptr, (n + 1) * sizeof(int));
+		memcpy(Q->rowind, qp->rowind, qp->nnz * sizeof(int));
+	}
+
+	if (Qfunc == GMRFLib_tabulate_Qfunction_std) {
+		tab = (GMRFLib_tabulate_Qfunc_arg_tp *) Qfunc_arg;
+	}
+	if (tab && tab->flat && tab->graph == graph) {
+		/*
+		 * the tabulated values are in the same graph-ordered listing as vidx, so just scatter them
+		 */
+#pragma omp parallel for private(i, k)
+		for (i = 0; i < n; i++) {
+			double val;
+			int *vidx = qp->vidx + qp->row_start[i];
+			double *tval = tab->flat + tab->row_start[i];
+			int len = qp->row_start[i + 1] - qp->row_start[i];
+
+			for (k = 0; k < len; k++) {
+				val = tval[k];
+				GMRFLib_STOP_IF_NAN_OR_INF(val, i, (k == 0 ? i : graph->nbs[i][k - 1]));
+				Q->values.d[vidx[k]] = val;
+			}
+		}
+	} else {
+#pragma omp parallel for private(i, k, j)
+		for (i = 0; i < n; i++) {
+			double val;
+			int *vidx = qp->vidx + qp->row_start[i];
+
+			GMRFLib_thread_id = id;
+
+			val = Qfunc(i, i, Qfunc_arg);
+			GMRFLib_STOP_IF_NAN_OR_INF(val, i, i);
+			Q->values.d[*vidx++] = val;
+
+			for (k = 0; k < graph->nnbs[i]; k++) {
+				j = graph->nbs[i][k];
+				if (j > i) {
+					break;
+				}
+				val = Qfunc(i, j, Qfunc_arg);
+				GMRFLib_STOP_IF_NAN_OR_INF(val, i, j);
+				Q->values.d[*vidx++] = val;
+			}
+		}
+	}
+	GMRFLib_thread_id = id;
+
 	if (GMRFLib_catch_error_for_inla) {
 		if (nan_error) {
+			GMRFLib_release_Q_TAUCS(Q, (Qpattern ? qp : NULL));
+			if (!Qpattern) {
+				GMRFLib_free_Qpattern_TAUCS(qp);
+			}
+			*L = NULL;
 			return !GMRFLib_SUCCESS;
 		}
 	}
-#endif
-	iperm = remap;					       /* yes, this is correct */
-	perm = Calloc(n, int);
-
-	for (i = 0; i < n; i++) {
-		perm[iperm[i]] = i;
+	if (!Qpattern) {
+		GMRFLib_free_Qpattern_TAUCS(qp);
 	}
-	*L = taucs_ccs_permute_symmetrically(Q, perm, iperm);  /* permute the matrix */
-
-	taucs_ccs_free(Q);
-	Free(perm);
+	*L = Q;
 
 	if (0) {
 		static int count = 0;
@@ -803,8 +1410,12 @@ int GMRFLib_build_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, GMRFLib_Qfunc_tp *
 	return GMRFLib_SUCCESS;
 }
 
-int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_factor_matrix ** symb_fact, GMRFLib_fact_info_tp * finfo, double **L_inv_diag)
+int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_factor_matrix ** symb_fact, GMRFLib_fact_info_tp * finfo, double **L_inv_diag,
+					  GMRFLib_Qpattern_tp * Qpattern)
 {
+	/*
+	 * on entry, *L is Q as build by GMRFLib_build_sparse_matrix_TAUCS(), which is released to Qpattern (if it is from there)
+	 */
 	int flags, k, retval;
 
 	if (!L) {
@@ -818,6 +1429,9 @@ int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_fact
 	finfo->nnzero = 2 * k + (*L)->n;
 
 	flags = (*L)->flags;
+	if (!*symb_fact) {
+		*symb_fact = GMRFLib_my_taucs_symbolic_cache(*L);
+	}
 	if (!*symb_fact) {
 		*symb_fact = (supernodal_factor_matrix *) taucs_ccs_factor_llt_symbolic(*L);
 	}
@@ -827,12 +1441,14 @@ int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_fact
 		if (GMRFLib_catch_error_for_inla) {
 			fprintf(stdout, "\n\t%s\n\tFunction: %s(), Line: %1d, Thread: %1d\n\tFail to factorize Q. I will try to fix it...\n\n",
 				RCSId, __GMRFLib_FuncName, __LINE__, omp_get_thread_num());
+			GMRFLib_release_Q_TAUCS(*L, Qpattern);
+			*L = NULL;
 			return GMRFLib_EPOSDEF;
 		} else {
 			GMRFLib_ERROR(GMRFLib_EPOSDEF);
 		}
 	}
-	taucs_ccs_free(*L);
+	GMRFLib_release_Q_TAUCS(*L, Qpattern);
 
 	if (include_zeros_in_L) {
 		/*
@@ -920,40 +1536,248 @@ int GMRFLib_factorise_sparse_matrix_TAUCS_OLD(taucs_ccs_matrix ** L, GMRFLib_fac
 		if (!L_fact) {
 			GMRFLib_ERROR(GMRFLib_EPOSDEF);
 		}
-		taucs_ccs_free(*L);
-		*L = L_fact;
-		break;
+		taucs_ccs_free(*L);
+		*L = L_fact;
+		break;
+
+	default:
+		abort();
+	}
+
+	/*
+	 * some last info 
+	 */
+	k = (*L)->colptr[(*L)->n] - (*L)->n;
+	finfo->nfillin = k - (finfo->nnzero - finfo->n) / 2;
+
+	return GMRFLib_SUCCESS;
+}
+
+int GMRFLib_free_fact_sparse_matrix_TAUCS(taucs_ccs_matrix * L, double *L_inv_diag, supernodal_factor_matrix * symb_fact)
+{
+	if (L) {
+		taucs_ccs_free(L);
+	}
+	Free(L_inv_diag);
+	if (symb_fact) {
+		GMRFLib_my_taucs_supernodal_factor_free(symb_fact);
+	}
+	return GMRFLib_SUCCESS;
+}
+
+int GMRFLib_free_fact_sparse_matrix_TAUCS_OLD(taucs_ccs_matrix * L)
+{
+	if (L) {
+		taucs_ccs_free(L);
+	}
+	return GMRFLib_SUCCESS;
+}
+
+/* 
+   the out-of-core version. the factorisation is written to a set of files in GMRFLib_ooc_dir, and the factor is only read back
+   in parts as needed, so the memory used is bounded by GMRFLib_ooc_memory. the routines which need the whole triangle, like
+   Qinv and the partial solves, must load it first, using GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(), and one-off users free it
+   again with GMRFLib_unload_fact_sparse_matrix_TAUCS_OOC(). the files are shared by duplicated problems.
+
+   the out-of-core factorisation and the access to the files are serialised, as they share the memory budget and the file
+   handle is not thread-safe.
+*/
+int GMRFLib_factorise_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, GMRFLib_ooc_fact_tp ** L_ooc, GMRFLib_fact_info_tp * finfo, GMRFLib_Qpattern_tp * Qpattern)
+{
+	static int count = 0;
+	int k, retval = 0, n_sn = 0, sn, *sn_size = NULL, *sn_up_size = NULL;
+	double nnz_L = 0.0;
+	char *dir = NULL, *basename = NULL;
+	taucs_io_handle *io = NULL;
+
+	if (!L) {
+		return GMRFLib_SUCCESS;
+	}
+	/*
+	 * compute some info about the factorization 
+	 */
+	k = (*L)->colptr[(*L)->n] - (*L)->n;
+	finfo->n = (*L)->n;
+	finfo->nnzero = 2 * k + (*L)->n;
+
+	dir = (GMRFLib_ooc_dir ? GMRFLib_ooc_dir : (getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp"));
+
+#pragma omp critical (GMRFLib_taucs_ooc)
+	{
+		GMRFLib_sprintf(&basename, "%s/gmrflib-ooc-%1d-%1d", dir, (int) getpid(), count++);
+		io = taucs_io_create_multifile(basename);
+		if (io) {
+			retval = taucs_ooc_factor_llt(*L, io, GMRFLib_ooc_memory);
+			if (retval) {
+				taucs_io_delete(io);
+				io = NULL;
+			} else {
+				taucs_io_read(io, 0, 1, 1, TAUCS_INT, &n_sn);
+				sn_size = Calloc(n_sn + 1, int);
+				sn_up_size = Calloc(n_sn + 1, int);
+				taucs_io_read(io, 3, 1, n_sn, TAUCS_INT, sn_size);
+				taucs_io_read(io, 4, 1, n_sn, TAUCS_INT, sn_up_size);
+			}
+		}
+	}
+	if (io) {
+		*L_ooc = Calloc(1, GMRFLib_ooc_fact_tp);
+		(*L_ooc)->io = io;
+	}
+	if (!io && !retval) {
+		GMRFLib_ERROR_MSG_NO_RETURN(GMRFLib_EOPENFILE, basename);
+		Free(basename);
+		return GMRFLib_EOPENFILE;
+	}
+	Free(basename);
+
+	if (retval) {
+		if (GMRFLib_catch_error_for_inla) {
+			fprintf(stdout, "\n\t%s\n\tFunction: %s(), Line: %1d, Thread: %1d\n\tFail to factorize Q. I will try to fix it...\n\n",
+				RCSId, __GMRFLib_FuncName, __LINE__, omp_get_thread_num());
+			GMRFLib_release_Q_TAUCS(*L, Qpattern);
+			*L = NULL;
+			return GMRFLib_EPOSDEF;
+		} else {
+			GMRFLib_ERROR(GMRFLib_EPOSDEF);
+		}
+	}
+	GMRFLib_release_Q_TAUCS(*L, Qpattern);
+	*L = NULL;
+
+	/*
+	 * some last info. the number of elements in L follows from the size of the supernodes, as the diagonal blocks are lower
+	 * triangular
+	 */
+	for (sn = 0; sn < n_sn; sn++) {
+		nnz_L += (double) sn_size[sn] * (double) sn_up_size[sn] - (double) sn_size[sn] * (sn_size[sn] - 1.0) / 2.0;
+	}
+	finfo->nfillin = (int) nnz_L - finfo->n - (finfo->nnzero - finfo->n) / 2;
+	Free(sn_size);
+	Free(sn_up_size);
+
+	return GMRFLib_SUCCESS;
+}
+
+int GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, double **L_inv_diag, GMRFLib_ooc_fact_tp * L_ooc)
+{
+	/*
+	 * load the factorisation on disk into L and compute L_inv_diag, unless they are there already.
+	 */
+	if (*L && *L_inv_diag) {
+		return GMRFLib_SUCCESS;
+	}
+#pragma omp critical (GMRFLib_taucs_ooc)
+	{
+		if (!*L && L_ooc) {
+			*L = taucs_ooc_factor_to_ccs(L_ooc->io);
+		}
+		if (*L && !*L_inv_diag) {
+			int i;
+			double *d = Calloc((*L)->n, double);
 
-	default:
-		abort();
+			for (i = 0; i < (*L)->n; i++) {
+				d[i] = 1.0 / (*L)->values.d[((*L)->colptr)[i]];
+			}
+			*L_inv_diag = d;
+		}
 	}
+	if (!*L) {
+		GMRFLib_ERROR(GMRFLib_EREADFILE);
+	}
+
+	return GMRFLib_SUCCESS;
+}
 
+int GMRFLib_unload_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, double **L_inv_diag)
+{
 	/*
-	 * some last info 
+	 * free the triangle loaded by GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(). the factorisation on disk is kept.
 	 */
-	k = (*L)->colptr[(*L)->n] - (*L)->n;
-	finfo->nfillin = k - (finfo->nnzero - finfo->n) / 2;
+	if (*L) {
+		taucs_ccs_free(*L);
+		*L = NULL;
+	}
+	Free(*L_inv_diag);
 
 	return GMRFLib_SUCCESS;
 }
 
-int GMRFLib_free_fact_sparse_matrix_TAUCS(taucs_ccs_matrix * L, double *L_inv_diag, supernodal_factor_matrix * symb_fact)
+GMRFLib_ooc_fact_tp *GMRFLib_share_fact_TAUCS_OOC(GMRFLib_ooc_fact_tp * L_ooc)
+{
+	/*
+	 * the files are read-only, so we just increase the counter of additional users, as for GMRFLib_share_Qpattern_TAUCS()
+	 */
+	if (L_ooc) {
+#pragma omp critical (GMRFLib_nref)
+		{
+			L_ooc->nref++;
+		}
+	}
+	return L_ooc;
+}
+
+int GMRFLib_free_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix * L, double *L_inv_diag, GMRFLib_ooc_fact_tp * L_ooc)
 {
+	int shared = 0;
+
 	if (L) {
 		taucs_ccs_free(L);
 	}
 	Free(L_inv_diag);
-	if (symb_fact) {
-		taucs_supernodal_factor_free(symb_fact);
+	if (L_ooc) {
+#pragma omp critical (GMRFLib_nref)
+		{
+			if (L_ooc->nref > 0) {
+				L_ooc->nref--;
+				shared = 1;
+			}
+		}
+		if (!shared) {
+#pragma omp critical (GMRFLib_taucs_ooc)
+			{
+				taucs_io_delete(L_ooc->io);
+			}
+			Free(L_ooc);
+		}
 	}
 	return GMRFLib_SUCCESS;
 }
 
-int GMRFLib_free_fact_sparse_matrix_TAUCS_OLD(taucs_ccs_matrix * L)
+int GMRFLib_solve_llt_sparse_matrix_TAUCS_OOC(double *rhs, GMRFLib_ooc_fact_tp * L_ooc, GMRFLib_graph_tp * graph, int *remap)
 {
-	if (L) {
-		taucs_ccs_free(L);
+	int retval;
+	double *b = NULL;
+
+	GMRFLib_EWRAP0(GMRFLib_convert_to_mapped(rhs, NULL, graph, remap));
+	b = Calloc(graph->n, double);
+	memcpy(b, rhs, graph->n * sizeof(double));
+
+#pragma omp critical (GMRFLib_taucs_ooc)
+	{
+		retval = taucs_ooc_solve_llt(L_ooc->io, rhs, b);
+	}
+	Free(b);
+	if (retval) {
+		GMRFLib_ERROR(GMRFLib_EMEMORY);
+	}
+	GMRFLib_convert_from_mapped(rhs, NULL, graph, remap);
+
+	return GMRFLib_SUCCESS;
+}
+
+int GMRFLib_log_determinant_TAUCS_OOC(double *logdet, GMRFLib_ooc_fact_tp * L_ooc)
+{
+	int retval;
+
+#pragma omp critical (GMRFLib_taucs_ooc)
+	{
+		retval = taucs_ooc_log_determinant(L_ooc->io, logdet);
+	}
+	if (retval) {
+		GMRFLib_ERROR(GMRFLib_EMEMORY);
 	}
+
 	return GMRFLib_SUCCESS;
 }
 int GMRFLib_solve_l_sparse_matrix_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap)
@@ -1013,6 +1837,82 @@ int GMRFLib_solve_llt_sparse_matrix_TAUCS(double *rhs, taucs_ccs_matrix * L, GMR
 
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_solve_nrhs_sparse_matrix_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap, int what)
+{
+	/*
+	 * rhs in real world, L in mapped world. rhs is column-blocked, rhs[k*n + i] is element i of right hand side k, and is
+	 * overwritten by the solutions. what = 0: solve Lx=rhs, what = 1: solve L^Tx=rhs, what = 2: solve LL^Tx=rhs.
+	 *
+	 * the right hand sides are processed in blocks of GMRFLib_NRHS_BLOCK, which are stored interleaved (row-major) while
+	 * solving, so L is traversed only once per block and the innermost loops run over contiguous memory. the blocks are
+	 * solved in parallel.
+	 */
+	int n, nblock, b, id;
+
+	n = graph->n;
+	if (n == 0 || nrhs <= 0) {
+		return GMRFLib_SUCCESS;
+	}
+
+	nblock = (nrhs + GMRFLib_NRHS_BLOCK - 1) / GMRFLib_NRHS_BLOCK;
+	id = GMRFLib_thread_id;
+
+#pragma omp parallel for private(b) schedule(dynamic) if (nblock > 1)
+	for (b = 0; b < nblock; b++) {
+		int i, k, k0, nb;
+		double *X = NULL, *col = NULL;
+
+		GMRFLib_thread_id = id;
+		k0 = b * GMRFLib_NRHS_BLOCK;
+		nb = IMIN(GMRFLib_NRHS_BLOCK, nrhs - k0);
+		X = Calloc(n * nb, double);
+
+		for (k = 0; k < nb; k++) {
+			col = &rhs[(size_t) (k0 + k) * n];
+			for (i = 0; i < n; i++) {
+				X[remap[i] * nb + k] = col[i];
+			}
+		}
+
+		switch (what) {
+		case 0:
+			GMRFLib_my_taucs_dccs_solve_l_block(L, X, nb);
+			break;
+		case 1:
+			GMRFLib_my_taucs_dccs_solve_lt_block(L, X, nb);
+			break;
+		case 2:
+			GMRFLib_my_taucs_dccs_solve_l_block(L, X, nb);
+			GMRFLib_my_taucs_dccs_solve_lt_block(L, X, nb);
+			break;
+		default:
+			assert(0 == 1);
+		}
+
+		for (k = 0; k < nb; k++) {
+			col = &rhs[(size_t) (k0 + k) * n];
+			for (i = 0; i < n; i++) {
+				col[i] = X[remap[i] * nb + k];
+			}
+		}
+		Free(X);
+	}
+	GMRFLib_thread_id = id;
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_solve_l_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap)
+{
+	return GMRFLib_solve_nrhs_sparse_matrix_TAUCS(rhs, nrhs, L, graph, remap, 0);
+}
+int GMRFLib_solve_lt_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap)
+{
+	return GMRFLib_solve_nrhs_sparse_matrix_TAUCS(rhs, nrhs, L, graph, remap, 1);
+}
+int GMRFLib_solve_llt_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap)
+{
+	return GMRFLib_solve_nrhs_sparse_matrix_TAUCS(rhs, nrhs, L, graph, remap, 2);
+}
 int GMRFLib_solve_lt_sparse_matrix_special_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap, int findx, int toindx, int remapped)
 {
 	/*
@@ -1184,7 +2084,9 @@ int GMRFLib_compute_Qinv_TAUCS(GMRFLib_problem_tp * problem, int storage)
 		/*
 		 * we have now modified the code so that zero's maintains in L, so we do not need the checking-step any longer. 
 		 */
-		GMRFLib_EWRAP0(GMRFLib_compute_Qinv_TAUCS_compute(problem, storage, NULL));
+		if (GMRFLib_compute_Qinv_TAUCS_compute_etree(problem, storage, problem->sub_sm_fact.L) != GMRFLib_SUCCESS) {
+			GMRFLib_EWRAP0(GMRFLib_compute_Qinv_TAUCS_compute(problem, storage, NULL));
+		}
 	} else {
 		/*
 		 * strategy:
@@ -1491,6 +2393,284 @@ taucs_ccs_matrix *GMRFLib_compute_Qinv_TAUCS_add_elements(taucs_ccs_matrix * L,
 
 	return LL;
 }
+/*
+  compute the elements S_ij of Qinv, for (i,j) in the pattern of L, into the flat array S which is aligned with L->values.d. 
+
+  The recursion is done by columns: for (i,j) in the pattern of L, i >= j
+
+      S_ij = (delta_ij/L_jj - sum_{k>j} L_kj S_ik) / L_jj
+
+  and S_ik needed for column j are all found in columns k > j, which are the ancestors of j in the elimination tree. Hence a
+  column can be computed as soon as its parent is done, and the subtrees of the children are independent. The tree is traversed
+  from the root(s) using tasks: after column j is done, each child, except the first, starts a task for its subtree (if it has more
+  than GMRFLib_QINV_ETREE_MIN_PARALLEL columns), while the first child is continued in the same task. A chain in the tree is then
+  done by one thread without any synchronisation. The off-diagonal terms of each column is computed by merging the rows of
+  column j with the rows of column r, r in struct(L_{.j}), which require the rows to be sorted within each column and the pattern
+  to be closed (zeros kept in L).
+
+  return !GMRFLib_SUCCESS if these requirements are not satisfied, in which case nothing is computed.
+*/
+static int GMRFLib_Qinv_etree_column_TAUCS(double *S, taucs_ccs_matrix * L, int jj, double *acc)
+{
+	/*
+	 * compute column jj of S, using the columns of its ancestors. acc is scratch of length at least the length of column jj.
+	 */
+	int a, b, m, q, q_end, r, p0;
+	double Ljj, sum;
+
+	p0 = L->colptr[jj];
+	m = L->colptr[jj + 1] - p0;			       /* the rows are p0+1...p0+m-1 */
+	Ljj = L->values.d[p0];
+
+	memset(acc, 0, m * sizeof(double));
+	for (b = 1; b < m; b++) {
+		/*
+		 * column r holds S(r, r) and S(rowind, r) for the rows of column jj that are larger than r
+		 */
+		r = L->rowind[p0 + b];
+		acc[b] += L->values.d[p0 + b] * S[L->colptr[r]];
+		q = L->colptr[r] + 1;
+		q_end = L->colptr[r + 1];
+		for (a = b + 1; a < m; a++) {
+			while (q < q_end && L->rowind[q] < L->rowind[p0 + a]) {
+				q++;
+			}
+			if (q == q_end || L->rowind[q] != L->rowind[p0 + a]) {
+				return !GMRFLib_SUCCESS;
+			}
+			acc[a] += L->values.d[p0 + b] * S[q];
+			acc[b] += L->values.d[p0 + a] * S[q];
+		}
+	}
+	for (a = 1, sum = 0.0; a < m; a++) {
+		S[p0 + a] = -acc[a] / Ljj;
+		sum += L->values.d[p0 + a] * S[p0 + a];
+	}
+	S[p0] = (1.0 / Ljj - sum) / Ljj;
+
+	return GMRFLib_SUCCESS;
+}
+
+static void GMRFLib_Qinv_etree_subtree_TAUCS(double *S, taucs_ccs_matrix * L, int jj, int *child_ptr, int *child, int *size, double **acc,
+					    int *fail)
+{
+	/*
+	 * compute the subtree with root jj. acc[tid] is the scratch for thread tid, which is only used within one column.
+	 */
+	int k, c, failed;
+
+	while (1) {
+#pragma omp atomic read
+		failed = *fail;
+		if (failed) {
+			return;
+		}
+		if (GMRFLib_Qinv_etree_column_TAUCS(S, L, jj, acc[omp_get_thread_num()]) != GMRFLib_SUCCESS) {
+#pragma omp atomic write
+			*fail = 1;
+			return;
+		}
+		if (child_ptr[jj + 1] == child_ptr[jj]) {
+			return;
+		}
+		for (k = child_ptr[jj] + 1; k < child_ptr[jj + 1]; k++) {
+			c = child[k];
+#pragma omp task firstprivate(c) if (size[c] > GMRFLib_QINV_ETREE_MIN_PARALLEL)
+			GMRFLib_Qinv_etree_subtree_TAUCS(S, L, c, child_ptr, child, size, acc, fail);
+		}
+		jj = child[child_ptr[jj]];
+	}
+}
+
+int GMRFLib_Qinv_etree_TAUCS(double *S, taucs_ccs_matrix * L)
+{
+	int i, j, jp, n, max_len, tmax, *parent = NULL, *size = NULL, *child_ptr = NULL, *child = NULL, *fill = NULL, fail = 0;
+	double **acc = NULL;
+
+	n = L->n;
+	max_len = 0;
+	for (j = 0; j < n && !fail; j++) {
+		max_len = IMAX(max_len, L->colptr[j + 1] - L->colptr[j]);
+		if (L->rowind[L->colptr[j]] != j) {
+			fail = 1;
+		}
+		for (jp = L->colptr[j] + 1; jp < L->colptr[j + 1]; jp++) {
+			if (L->rowind[jp] <= L->rowind[jp - 1]) {
+				fail = 1;
+				break;
+			}
+		}
+	}
+	if (fail) {
+		return !GMRFLib_SUCCESS;
+	}
+
+	/*
+	 * the elimination tree, the children of each column and the size of each subtree. parent[j] > j, so the sizes are
+	 * accumulated from the leaves and up
+	 */
+	parent = Calloc(n, int);
+	size = Calloc(n, int);
+	child_ptr = Calloc(n + 2, int);
+	child = Calloc(n + 1, int);
+	fill = Calloc(n + 1, int);
+	for (j = 0; j < n; j++) {
+		parent[j] = (L->colptr[j + 1] - L->colptr[j] > 1 ? L->rowind[L->colptr[j] + 1] : n);	/* the roots are children of 'n' */
+		child_ptr[parent[j] + 1]++;
+	}
+	for (j = 0; j < n + 1; j++) {
+		child_ptr[j + 1] += child_ptr[j];
+		fill[j] = child_ptr[j];
+	}
+	for (j = 0; j < n; j++) {
+		child[fill[parent[j]]++] = j;
+		size[j]++;
+		if (parent[j] < n) {
+			size[parent[j]] += size[j];
+		}
+	}
+
+	/*
+	 * one scratch array for each thread in the team 
+	 */
+#pragma omp parallel
+	{
+#pragma omp single
+		{
+			int k, c;
+
+			tmax = omp_get_num_threads();
+			acc = Calloc(tmax, double *);
+			for (k = 0; k < tmax; k++) {
+				acc[k] = Calloc(IMAX(1, max_len), double);
+			}
+			for (k = child_ptr[n]; k < child_ptr[n + 1]; k++) {
+				c = child[k];
+#pragma omp task firstprivate(c) if (size[c] > GMRFLib_QINV_ETREE_MIN_PARALLEL)
+				GMRFLib_Qinv_etree_subtree_TAUCS(S, L, c, child_ptr, child, size, acc, &fail);
+			}
+		}
+	}
+
+	for (i = 0; i < tmax; i++) {
+		Free(acc[i]);
+	}
+	Free(acc);
+	Free(parent);
+	Free(size);
+	Free(child_ptr);
+	Free(child);
+	Free(fill);
+
+	return (fail ? !GMRFLib_SUCCESS : GMRFLib_SUCCESS);
+}
+
+int GMRFLib_compute_Qinv_TAUCS_compute_etree(GMRFLib_problem_tp * problem, int storage, taucs_ccs_matrix * L)
+{
+	/*
+	 * as GMRFLib_compute_Qinv_TAUCS_compute(), but use the (parallel) column-recursion in GMRFLib_Qinv_etree_TAUCS() storing the
+	 * results in a flat array aligned with L. the entries requested by 'storage' are kept in this layout, so that
+	 * GMRFLib_Qinv_get() is a lookup in one column and not a hash probe.
+	 */
+	int i, n, nc, *inv_remap = NULL, *colptr = NULL, *rowind = NULL;
+	double *S = NULL, *values = NULL;
+	GMRFLib_Qinv_tp *qi = NULL;
+
+	n = L->n;
+	S = Calloc(IMAX(1, L->colptr[n]), double);
+	if (GMRFLib_Qinv_etree_TAUCS(S, L) != GMRFLib_SUCCESS) {
+		Free(S);
+		return !GMRFLib_SUCCESS;
+	}
+
+	inv_remap = Calloc(n, int);
+	for (i = 0; i < n; i++) {
+		inv_remap[problem->sub_sm_fact.remap[i]] = i;
+	}
+
+	/*
+	 * the requested elements. options are GMRFLib_QINV_ALL GMRFLib_QINV_NEIGB GMRFLib_QINV_DIAG. with GMRFLib_QINV_ALL, the
+	 * layout is that of L, otherwise the columns are compressed in a second pass.
+	 */
+	colptr = Calloc(n + 1, int);
+	if (storage & (GMRFLib_QINV_DIAG | GMRFLib_QINV_NEIGB)) {
+		int *keep = Calloc(IMAX(1, L->colptr[n]), int);
+
+#pragma omp parallel for private(i) schedule(static)
+		for (i = 0; i < n; i++) {
+			int jp, iii = inv_remap[i];
+
+			keep[L->colptr[i]] = 1;
+			for (jp = L->colptr[i] + 1; jp < L->colptr[i + 1] && !(storage & GMRFLib_QINV_DIAG); jp++) {
+				keep[jp] = GMRFLib_is_neighb(iii, inv_remap[L->rowind[jp]], problem->sub_graph);
+			}
+		}
+		for (i = 0; i < n; i++) {
+			int jp;
+
+			colptr[i + 1] = colptr[i];
+			for (jp = L->colptr[i]; jp < L->colptr[i + 1]; jp++) {
+				colptr[i + 1] += keep[jp];
+			}
+		}
+		rowind = Calloc(IMAX(1, colptr[n]), int);
+		values = Calloc(IMAX(1, colptr[n]), double);
+		for (i = 0; i < n; i++) {
+			int jp, k = colptr[i];
+
+			for (jp = L->colptr[i]; jp < L->colptr[i + 1]; jp++) {
+				if (keep[jp]) {
+					rowind[k] = L->rowind[jp];
+					values[k++] = S[jp];
+				}
+			}
+		}
+		Free(keep);
+		Free(S);
+	} else {
+		memcpy(colptr, L->colptr, (n + 1) * sizeof(int));
+		rowind = Calloc(IMAX(1, colptr[n]), int);
+		memcpy(rowind, L->rowind, colptr[n] * sizeof(int));
+		values = S;
+	}
+
+	/*
+	 * correct for constraints, if any (see GMRFLib_compute_Qinv_TAUCS_compute()).
+	 */
+	nc = (problem->sub_constr ? problem->sub_constr->nc : 0);
+	if (nc) {
+#pragma omp parallel for private(i) schedule(static)
+		for (i = 0; i < n; i++) {
+			int jp, iii, jjj, kk;
+
+			iii = inv_remap[i];
+			for (jp = colptr[i]; jp < colptr[i + 1]; jp++) {
+				jjj = inv_remap[rowind[jp]];
+				for (kk = 0; kk < nc; kk++) {
+					values[jp] -= problem->constr_m[iii + kk * n] * problem->qi_at_m[jjj + kk * n];
+				}
+			}
+		}
+	}
+
+	problem->sub_inverse = qi = Calloc(1, GMRFLib_Qinv_tp);
+	qi->values = values;
+	qi->colptr = colptr;
+	qi->rowind = rowind;
+	qi->n_map = problem->n;
+	qi->map = Calloc(IMAX(1, qi->n_map), int);
+	for (i = 0; i < qi->n_map; i++) {
+		qi->map[i] = -1;
+	}
+	for (i = 0; i < n; i++) {
+		qi->map[problem->sub_graph->mothergraph_idx[i]] = problem->sub_sm_fact.remap[i];
+	}
+
+	Free(inv_remap);
+
+	return GMRFLib_SUCCESS;
+}
+
 int GMRFLib_compute_Qinv_TAUCS_compute(GMRFLib_problem_tp * problem, int storage, taucs_ccs_matrix * Lmatrix)
 {
 	/*
@@ -1821,6 +3001,73 @@ int GMRFLib_my_taucs_dccs_solve_llt(void *vL, double *x)
 	}
 	return 0;
 }
+int GMRFLib_my_taucs_dccs_solve_l_block(void *vL, double *X, int nrhs)
+{
+	/*
+	 * solve LX=B for nrhs right hand sides stored interleaved, X[i*nrhs + k], which is overwritten by the solution.
+	 */
+	taucs_ccs_matrix *L = (taucs_ccs_matrix *) vL;
+
+	return GMRFLib_my_taucs_dccs_solve_l_block_range(vL, X, nrhs, 0, L->n - 1);
+}
+int GMRFLib_my_taucs_dccs_solve_l_block_range(void *vL, double *X, int nrhs, int from, int to)
+{
+	/*
+	 * as GMRFLib_my_taucs_dccs_solve_l_block(), but where B is zero in the rows before 'from' and only the rows from,...,to of
+	 * the solution are needed. X holds only these rows, X[(i-from)*nrhs + k].
+	 */
+	taucs_ccs_matrix *L = (taucs_ccs_matrix *) vL;
+	int i, j, k, ip;
+	double Aij, iAjj, *xi = NULL, *xj = NULL;
+
+	for (j = from; j <= to; j++) {
+		ip = L->colptr[j];
+		iAjj = 1.0 / L->values.d[ip];
+		xj = &X[(j - from) * nrhs];
+		for (k = 0; k < nrhs; k++) {
+			xj[k] *= iAjj;
+		}
+		for (ip = L->colptr[j] + 1; ip < L->colptr[j + 1]; ip++) {
+			i = L->rowind[ip];
+			if (i > to) {
+				continue;
+			}
+			Aij = L->values.d[ip];
+			xi = &X[(i - from) * nrhs];
+			for (k = 0; k < nrhs; k++) {
+				xi[k] -= Aij * xj[k];
+			}
+		}
+	}
+	return 0;
+}
+int GMRFLib_my_taucs_dccs_solve_lt_block(void *vL, double *X, int nrhs)
+{
+	/*
+	 * solve L^TX=B for nrhs right hand sides stored interleaved, X[i*nrhs + k], which is overwritten by the solution.
+	 */
+	taucs_ccs_matrix *L = (taucs_ccs_matrix *) vL;
+	int i, j, k, jp;
+	double Aij, iAii, *xi = NULL, *xj = NULL;
+
+	for (i = L->n - 1; i >= 0; i--) {
+		xi = &X[i * nrhs];
+		for (jp = L->colptr[i] + 1; jp < L->colptr[i + 1]; jp++) {
+			j = L->rowind[jp];
+			Aij = L->values.d[jp];
+			xj = &X[j * nrhs];
+			for (k = 0; k < nrhs; k++) {
+				xi[k] -= Aij * xj[k];
+			}
+		}
+		jp = L->colptr[i];
+		iAii = 1.0 / L->values.d[jp];
+		for (k = 0; k < nrhs; k++) {
+			xi[k] *= iAii;
+		}
+	}
+	return 0;
+}
 int GMRFLib_my_taucs_dccs_solve_l(void *vL, double *x)
 {
 	taucs_ccs_matrix *L = (taucs_ccs_matrix *) vL;
@@ -56,6 +56,25 @@
 
 __BEGIN_DECLS
 
+/*!
+  \brief Only matrices of at least this size use the cache of symbolic factorisations.
+ */
+#define GMRFLib_TAUCS_SYMBOLIC_CACHE_MIN_N (5000)
+
+/*!
+  \brief Subtrees of the elimination tree with at most this many columns are done by the thread that reaches them in GMRFLib_Qinv_etree_TAUCS().
+ */
+#define GMRFLib_QINV_ETREE_MIN_PARALLEL (32)
+
+/*!
+  \brief The reference-counted symbolic part of a supernodal factor, which is shared read-only between its copies.
+ */
+typedef struct {
+	int refcount;					       /* the number of factors using it */
+	void *map;					       /* if non-NULL, the arrays are in this read-only mapping */
+	size_t map_len;
+} GMRFLib_taucs_symbolic_tp;
+
 /* 
    
  */
@@ -63,11 +82,25 @@ __BEGIN_DECLS
 int GMRFLib_compute_reordering_TAUCS_orig(int **remap, GMRFLib_graph_tp * graph);
 int GMRFLib_compute_reordering_TAUCS(int **remap, GMRFLib_graph_tp * graph, GMRFLib_reorder_tp reorder,
 				     GMRFLib_global_node_tp *gn_ptr);
-int GMRFLib_build_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_compute_reordering_TAUCS_nseps(int **remap, GMRFLib_graph_tp * graph, GMRFLib_reorder_tp reorder,
+					   GMRFLib_global_node_tp *gn_ptr, int nseps);
+int GMRFLib_build_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, GMRFLib_Qfunc_tp * Qfunc, void *Qfunc_arg, GMRFLib_graph_tp * graph, int *remap,
+				      GMRFLib_Qpattern_tp ** Qpattern);
+GMRFLib_Qpattern_tp *GMRFLib_build_Qpattern_TAUCS(GMRFLib_graph_tp * graph, int *remap);
+GMRFLib_Qpattern_tp *GMRFLib_share_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp);
+int GMRFLib_free_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp);
 int GMRFLib_factorise_sparse_matrix_TAUCS_OLD(taucs_ccs_matrix ** L, GMRFLib_fact_info_tp * finfo);
-int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_factor_matrix ** symb_fact, GMRFLib_fact_info_tp * finfo, double **L_inv_diag);
+int GMRFLib_factorise_sparse_matrix_TAUCS(taucs_ccs_matrix ** L, supernodal_factor_matrix ** symb_fact, GMRFLib_fact_info_tp * finfo, double **L_inv_diag,
+					  GMRFLib_Qpattern_tp * Qpattern);
 int GMRFLib_free_fact_sparse_matrix_TAUCS(taucs_ccs_matrix * L, double *L_inv_diag, supernodal_factor_matrix * symb_fact);
 int GMRFLib_free_fact_sparse_matrix_TAUCS_OLD(taucs_ccs_matrix * L);
+int GMRFLib_factorise_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, GMRFLib_ooc_fact_tp ** L_ooc, GMRFLib_fact_info_tp * finfo, GMRFLib_Qpattern_tp * Qpattern);
+int GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, double **L_inv_diag, GMRFLib_ooc_fact_tp * L_ooc);
+int GMRFLib_unload_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix ** L, double **L_inv_diag);
+int GMRFLib_free_fact_sparse_matrix_TAUCS_OOC(taucs_ccs_matrix * L, double *L_inv_diag, GMRFLib_ooc_fact_tp * L_ooc);
+int GMRFLib_solve_llt_sparse_matrix_TAUCS_OOC(double *rhs, GMRFLib_ooc_fact_tp * L_ooc, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_log_determinant_TAUCS_OOC(double *logdet, GMRFLib_ooc_fact_tp * L_ooc);
+GMRFLib_ooc_fact_tp *GMRFLib_share_fact_TAUCS_OOC(GMRFLib_ooc_fact_tp * L_ooc);
 int GMRFLib_solve_lt_sparse_matrix_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
 int GMRFLib_solve_llt_sparse_matrix_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
 int GMRFLib_solve_lt_sparse_matrix_special_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap, int findx, int toindx, int remapped);
@@ -84,6 +117,13 @@ int GMRFLib_my_taucs_dccs_solve_llt(void *vL, double *x);
 int GMRFLib_solve_l_sparse_matrix_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
 int GMRFLib_my_taucs_dccs_solve_l(void *vL, double *x);
 int GMRFLib_my_taucs_dccs_solve_l_special(void *vL, double *x, double *b, int from_idx, int to_idx);
+int GMRFLib_my_taucs_dccs_solve_l_block(void *vL, double *X, int nrhs);
+int GMRFLib_my_taucs_dccs_solve_l_block_range(void *vL, double *X, int nrhs, int from, int to);
+int GMRFLib_my_taucs_dccs_solve_lt_block(void *vL, double *X, int nrhs);
+int GMRFLib_solve_nrhs_sparse_matrix_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap, int what);
+int GMRFLib_solve_l_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_solve_lt_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
+int GMRFLib_solve_llt_sparse_matrix_nrhs_TAUCS(double *rhs, int nrhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap);
 int GMRFLib_solve_l_sparse_matrix_special_TAUCS(double *rhs, taucs_ccs_matrix * L, GMRFLib_graph_tp * graph, int *remap, int findx, int toindx, int remapped);
 int GMRFLib_amdc(int n, int *pe, int *iw, int *len, int iwlen, int pfree, int *nv, int *next, int *last, int *head, int *elen, int *degree, int ncmpa, int *w);
 int GMRFLib_amdbarc(int n, int *pe, int *iw, int *len, int iwlen, int pfree, int *nv, int *next, int *last, int *head, int *elen, int *degree, int ncmpa, int *w);
@@ -91,10 +131,14 @@ int GMRFLib_amdbarc(int n, int *pe, int *iw, int *len, int iwlen, int pfree, int
 map_ii **GMRFLib_compute_Qinv_TAUCS_check(taucs_ccs_matrix * L);
 taucs_ccs_matrix *GMRFLib_compute_Qinv_TAUCS_add_elements(taucs_ccs_matrix * L, map_ii ** missing_elements);
 int GMRFLib_compute_Qinv_TAUCS_compute(GMRFLib_problem_tp * problem, int storage, taucs_ccs_matrix * Lmatrix);
+int GMRFLib_compute_Qinv_TAUCS_compute_etree(GMRFLib_problem_tp * problem, int storage, taucs_ccs_matrix * L);
+int GMRFLib_Qinv_etree_TAUCS(double *S, taucs_ccs_matrix * L);
 
 taucs_ccs_matrix *GMRFLib_my_taucs_dccs_duplicate(taucs_ccs_matrix * L, int flags);
 int GMRFLib_print_ccs_matrix(FILE *fp, taucs_ccs_matrix * L);
 supernodal_factor_matrix *GMRFLib_my_taucs_supernodal_factor_matrix_duplicate(supernodal_factor_matrix * L);
+void GMRFLib_my_taucs_supernodal_factor_free(supernodal_factor_matrix * L);
+supernodal_factor_matrix *GMRFLib_my_taucs_symbolic_cache(taucs_ccs_matrix * L);
 taucs_ccs_matrix *my_taucs_dsupernodal_factor_to_ccs(void *vL);
 
 /* 
@@ -103,8 +147,10 @@ taucs_ccs_matrix *my_taucs_dsupernodal_factor_to_ccs(void *vL);
 int GMRFLib_bitmap_factorisation_TAUCS__intern(taucs_ccs_matrix * L, const char *filename);
 int GMRFLib_bitmap_factorisation_TAUCS(const char *filename_body, taucs_ccs_matrix * L);
 GMRFLib_sizeof_tp GMRFLib_my_taucs_dccs_sizeof(taucs_ccs_matrix * L);
+GMRFLib_sizeof_tp GMRFLib_sizeof_Qpattern_TAUCS(GMRFLib_Qpattern_tp * qp);
 GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_sizeof(supernodal_factor_matrix * L);
 GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_computing_time(supernodal_factor_matrix * L);
+double GMRFLib_my_taucs_supernodal_factor_matrix_flops(supernodal_factor_matrix * L);
 GMRFLib_sizeof_tp GMRFLib_my_taucs_supernodal_factor_matrix_nnz(supernodal_factor_matrix * L);
 
 __END_DECLS
@@ -62,6 +62,11 @@ int GMRFLib_compute_reordering(GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp *
 		gn_ptr = &lgn;
 	}
 
+	/*
+	 * a new reordering invalidates the pattern of Q. the caller frees the old reordering, if any.
+	 */
+	sm_fact->Qpattern = NULL;
+
 	switch (GMRFLib_reorder) {
 	case GMRFLib_REORDER_DEFAULT:
 		/*
@@ -72,9 +77,10 @@ int GMRFLib_compute_reordering(GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp *
 			GMRFLib_EWRAP1(GMRFLib_compute_reordering_BAND(&(sm_fact->remap), graph));
 			break;
 		case GMRFLib_SMTP_PROFILE:
-			GMRFLib_EWRAP1(GMRFLib_compute_reordering_PROFILE());
+			GMRFLib_EWRAP1(GMRFLib_compute_reordering_PROFILE(&(sm_fact->remap), graph));
 			break;
 		case GMRFLib_SMTP_TAUCS:
+		case GMRFLib_SMTP_TAUCS_OOC:
 			GMRFLib_EWRAP1(GMRFLib_compute_reordering_TAUCS(&(sm_fact->remap), graph, GMRFLib_reorder, gn_ptr));
 			break;
 		default:
@@ -127,6 +133,8 @@ int GMRFLib_free_reordering(GMRFLib_sm_fact_tp * sm_fact)
 	if (sm_fact) {
 		Free(sm_fact->remap);
 		sm_fact->bandwidth = 0;
+		GMRFLib_free_Qpattern_TAUCS(sm_fact->Qpattern);
+		sm_fact->Qpattern = NULL;
 	}
 	GMRFLib_LEAVE_ROUTINE;
 	return GMRFLib_SUCCESS;
@@ -152,16 +160,24 @@ int GMRFLib_build_sparse_matrix(GMRFLib_sm_fact_tp * sm_fact, GMRFLib_Qfunc_tp *
 		}
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_build_sparse_matrix_PROFILE());
+		if (GMRFLib_catch_error_for_inla) {
+			ret = GMRFLib_build_sparse_matrix_PROFILE(&(sm_fact->profile), Qfunc, Qfunc_arg, graph, sm_fact->remap);
+			if (ret != GMRFLib_SUCCESS) {
+				return ret;
+			}
+		} else {
+			GMRFLib_EWRAP1(GMRFLib_build_sparse_matrix_PROFILE(&(sm_fact->profile), Qfunc, Qfunc_arg, graph, sm_fact->remap));
+		}
 		break;
 	case GMRFLib_SMTP_TAUCS:
+	case GMRFLib_SMTP_TAUCS_OOC:
 		if (GMRFLib_catch_error_for_inla) {
-			ret = GMRFLib_build_sparse_matrix_TAUCS(&(sm_fact->L), Qfunc, Qfunc_arg, graph, sm_fact->remap);
+			ret = GMRFLib_build_sparse_matrix_TAUCS(&(sm_fact->L), Qfunc, Qfunc_arg, graph, sm_fact->remap, &(sm_fact->Qpattern));
 			if (ret != GMRFLib_SUCCESS) {
 				return ret;
 			}
 		} else {
-			GMRFLib_EWRAP1(GMRFLib_build_sparse_matrix_TAUCS(&(sm_fact->L), Qfunc, Qfunc_arg, graph, sm_fact->remap));
+			GMRFLib_EWRAP1(GMRFLib_build_sparse_matrix_TAUCS(&(sm_fact->L), Qfunc, Qfunc_arg, graph, sm_fact->remap, &(sm_fact->Qpattern)));
 		}
 		break;
 	default:
@@ -193,16 +209,35 @@ int GMRFLib_factorise_sparse_matrix(GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_
 		}
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_factorise_sparse_matrix_PROFILE());
+		if (GMRFLib_catch_error_for_inla) {
+			ret = GMRFLib_factorise_sparse_matrix_PROFILE(sm_fact->profile, &(sm_fact->finfo), graph);
+			if (ret != GMRFLib_SUCCESS) {
+				return ret;
+			}
+		} else {
+			GMRFLib_EWRAP1(GMRFLib_factorise_sparse_matrix_PROFILE(sm_fact->profile, &(sm_fact->finfo), graph));
+		}
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		if (GMRFLib_catch_error_for_inla) {
-			ret = GMRFLib_factorise_sparse_matrix_TAUCS(&(sm_fact->L), &(sm_fact->symb_fact), &(sm_fact->finfo), &(sm_fact->L_inv_diag));
+			ret = GMRFLib_factorise_sparse_matrix_TAUCS(&(sm_fact->L), &(sm_fact->symb_fact), &(sm_fact->finfo), &(sm_fact->L_inv_diag),
+								     sm_fact->Qpattern);
+			if (ret != GMRFLib_SUCCESS) {
+				return ret;
+			}
+		} else {
+			GMRFLib_EWRAP1(GMRFLib_factorise_sparse_matrix_TAUCS(&(sm_fact->L), &(sm_fact->symb_fact), &(sm_fact->finfo), &(sm_fact->L_inv_diag),
+									      sm_fact->Qpattern));
+		}
+		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		if (GMRFLib_catch_error_for_inla) {
+			ret = GMRFLib_factorise_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_ooc), &(sm_fact->finfo), sm_fact->Qpattern);
 			if (ret != GMRFLib_SUCCESS) {
 				return ret;
 			}
 		} else {
-			GMRFLib_EWRAP1(GMRFLib_factorise_sparse_matrix_TAUCS(&(sm_fact->L), &(sm_fact->symb_fact), &(sm_fact->finfo), &(sm_fact->L_inv_diag)));
+			GMRFLib_EWRAP1(GMRFLib_factorise_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_ooc), &(sm_fact->finfo), sm_fact->Qpattern));
 		}
 		break;
 	default:
@@ -229,13 +264,20 @@ int GMRFLib_free_fact_sparse_matrix(GMRFLib_sm_fact_tp * sm_fact)
 			sm_fact->bchol = NULL;
 			break;
 		case GMRFLib_SMTP_PROFILE:
-			GMRFLib_EWRAP1(GMRFLib_free_fact_sparse_matrix_PROFILE());
+			GMRFLib_EWRAP1(GMRFLib_free_fact_sparse_matrix_PROFILE(sm_fact->profile));
+			sm_fact->profile = NULL;
 			break;
 		case GMRFLib_SMTP_TAUCS:
 			GMRFLib_EWRAP1(GMRFLib_free_fact_sparse_matrix_TAUCS(sm_fact->L, sm_fact->L_inv_diag, sm_fact->symb_fact));
 			sm_fact->L = NULL;
 			sm_fact->symb_fact = NULL;
 			break;
+		case GMRFLib_SMTP_TAUCS_OOC:
+			GMRFLib_EWRAP1(GMRFLib_free_fact_sparse_matrix_TAUCS_OOC(sm_fact->L, sm_fact->L_inv_diag, sm_fact->L_ooc));
+			sm_fact->L = NULL;
+			sm_fact->L_inv_diag = NULL;
+			sm_fact->L_ooc = NULL;
+			break;
 		default:
 			GMRFLib_ASSERT(1 == 0, GMRFLib_ESNH);
 			break;
@@ -260,11 +302,15 @@ int GMRFLib_solve_l_sparse_matrix(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GMR
 		GMRFLib_EWRAP1(GMRFLib_solve_l_sparse_matrix_BAND(rhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_solve_l_sparse_matrix_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_solve_l_sparse_matrix_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP1(GMRFLib_solve_l_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_solve_l_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -290,11 +336,15 @@ int GMRFLib_solve_lt_sparse_matrix(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GM
 		GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_BAND(rhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_solve_lt_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -320,11 +370,21 @@ int GMRFLib_solve_llt_sparse_matrix(double *rhs, GMRFLib_sm_fact_tp * sm_fact, G
 		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_BAND(rhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		/*
+		 * use the triangle in memory if it is loaded already
+		 */
+		if (sm_fact->L) {
+			GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap));
+		} else {
+			GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_TAUCS_OOC(rhs, sm_fact->L_ooc, graph, sm_fact->remap));
+		}
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -334,6 +394,87 @@ int GMRFLib_solve_llt_sparse_matrix(double *rhs, GMRFLib_sm_fact_tp * sm_fact, G
 
 	return GMRFLib_SUCCESS;
 }
+
+/*!
+  \brief Solve \f$Lx=b\f$ for several right hand sides
+
+  The \c nrhs right hand sides are stored column-blocked in \c rhs, so that right hand side \c k starts at \c rhs[k*graph->n], and
+  are overwritten by the solutions. This is faster than calling GMRFLib_solve_l_sparse_matrix() for each of them, as the factor is
+  traversed once for each block of GMRFLib_NRHS_BLOCK right hand sides, and the blocks are solved in parallel.
+*/
+int GMRFLib_solve_l_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph)
+{
+	GMRFLib_ENTER_ROUTINE;
+	GMRFLib_EWRAP1(GMRFLib_solve_nrhs_sparse_matrix(rhs, nrhs, sm_fact, graph, 0));
+	GMRFLib_LEAVE_ROUTINE;
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Solve \f$L^Tx=b\f$ for several right hand sides
+
+  See GMRFLib_solve_l_sparse_matrix_nrhs() for the storage of \c rhs.
+*/
+int GMRFLib_solve_lt_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph)
+{
+	GMRFLib_ENTER_ROUTINE;
+	GMRFLib_EWRAP1(GMRFLib_solve_nrhs_sparse_matrix(rhs, nrhs, sm_fact, graph, 1));
+	GMRFLib_LEAVE_ROUTINE;
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Solve \f$LL^Tx=b\f$ or \f$Qx=b\f$ for several right hand sides
+
+  See GMRFLib_solve_l_sparse_matrix_nrhs() for the storage of \c rhs.
+*/
+int GMRFLib_solve_llt_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph)
+{
+	GMRFLib_ENTER_ROUTINE;
+	GMRFLib_EWRAP1(GMRFLib_solve_nrhs_sparse_matrix(rhs, nrhs, sm_fact, graph, 2));
+	GMRFLib_LEAVE_ROUTINE;
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_solve_nrhs_sparse_matrix(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph, int what)
+{
+	/*
+	 * rhs in real world, column-blocked. what = 0: solve Lx=rhs, what = 1: solve L^Tx=rhs, what = 2: solve LL^Tx=rhs.
+	 */
+	switch (sm_fact->smtp) {
+	case GMRFLib_SMTP_BAND:
+		GMRFLib_EWRAP0(GMRFLib_solve_nrhs_sparse_matrix_BAND(rhs, nrhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth, what));
+		break;
+	case GMRFLib_SMTP_PROFILE:
+		GMRFLib_EWRAP0(GMRFLib_solve_nrhs_sparse_matrix_PROFILE(rhs, nrhs, sm_fact->profile, graph, sm_fact->remap, what));
+		break;
+	case GMRFLib_SMTP_TAUCS:
+		GMRFLib_EWRAP0(GMRFLib_solve_nrhs_sparse_matrix_TAUCS(rhs, nrhs, sm_fact->L, graph, sm_fact->remap, what));
+		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		if (what == 2 && !sm_fact->L) {
+			/*
+			 * solve them one by one, streaming through the factorisation on disk
+			 */
+			int k;
+
+			for (k = 0; k < nrhs; k++) {
+				GMRFLib_EWRAP0(GMRFLib_solve_llt_sparse_matrix_TAUCS_OOC(&rhs[k * graph->n], sm_fact->L_ooc, graph, sm_fact->remap));
+			}
+		} else {
+			GMRFLib_EWRAP0(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+			GMRFLib_EWRAP0(GMRFLib_solve_nrhs_sparse_matrix_TAUCS(rhs, nrhs, sm_fact->L, graph, sm_fact->remap, what));
+		}
+		break;
+	default:
+		GMRFLib_ERROR(GMRFLib_ESNH);
+		break;
+	}
+
+	return GMRFLib_SUCCESS;
+}
 int GMRFLib_solve_llt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph, int idx)
 {
 	/*
@@ -352,7 +493,7 @@ int GMRFLib_solve_llt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm
 		/*
 		 * not implemented yet, so we're using the default (and fail-safe) version 
 		 */
-		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		/*
@@ -360,6 +501,10 @@ int GMRFLib_solve_llt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm
 		 */
 		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_special_TAUCS(rhs, sm_fact->L, sm_fact->L_inv_diag, graph, sm_fact->remap, idx));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_solve_llt_sparse_matrix_special_TAUCS(rhs, sm_fact->L, sm_fact->L_inv_diag, graph, sm_fact->remap, idx));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -387,11 +532,15 @@ int GMRFLib_solve_lt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm_
 			       (rhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth, findx, toindx, remapped));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP0(GMRFLib_solve_lt_sparse_matrix_special_PROFILE());
+		GMRFLib_EWRAP0(GMRFLib_solve_lt_sparse_matrix_special_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap, findx, toindx, remapped));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP0(GMRFLib_solve_lt_sparse_matrix_special_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap, findx, toindx, remapped));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP0(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP0(GMRFLib_solve_lt_sparse_matrix_special_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap, findx, toindx, remapped));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -416,11 +565,15 @@ int GMRFLib_solve_l_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm_f
 		GMRFLib_EWRAP0(GMRFLib_solve_l_sparse_matrix_special_BAND(rhs, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth, findx, toindx, remapped));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP0(GMRFLib_solve_l_sparse_matrix_special_PROFILE());
+		GMRFLib_EWRAP0(GMRFLib_solve_l_sparse_matrix_special_PROFILE(rhs, sm_fact->profile, graph, sm_fact->remap, findx, toindx, remapped));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP0(GMRFLib_solve_l_sparse_matrix_special_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap, findx, toindx, remapped));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP0(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP0(GMRFLib_solve_l_sparse_matrix_special_TAUCS(rhs, sm_fact->L, graph, sm_fact->remap, findx, toindx, remapped));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -439,11 +592,18 @@ int GMRFLib_log_determinant(double *logdet, GMRFLib_sm_fact_tp * sm_fact, GMRFLi
 		GMRFLib_EWRAP0(GMRFLib_log_determinant_BAND(logdet, sm_fact->bchol, graph, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP0(GMRFLib_log_determinant_PROFILE());
+		GMRFLib_EWRAP0(GMRFLib_log_determinant_PROFILE(logdet, sm_fact->profile));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP0(GMRFLib_log_determinant_TAUCS(logdet, sm_fact->L));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		if (sm_fact->L) {
+			GMRFLib_EWRAP0(GMRFLib_log_determinant_TAUCS(logdet, sm_fact->L));
+		} else {
+			GMRFLib_EWRAP0(GMRFLib_log_determinant_TAUCS_OOC(logdet, sm_fact->L_ooc));
+		}
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -462,11 +622,15 @@ int GMRFLib_comp_cond_meansd(double *cmean, double *csd, int indx, double *x, in
 		GMRFLib_EWRAP1(GMRFLib_comp_cond_meansd_BAND(cmean, csd, indx, x, remapped, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_comp_cond_meansd_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_comp_cond_meansd_PROFILE(cmean, csd, indx, x, remapped, sm_fact->profile, graph, sm_fact->remap));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP1(GMRFLib_comp_cond_meansd_TAUCS(cmean, csd, indx, x, remapped, sm_fact->L, graph, sm_fact->remap));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_comp_cond_meansd_TAUCS(cmean, csd, indx, x, remapped, sm_fact->L, graph, sm_fact->remap));
+		break;
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -485,11 +649,22 @@ int GMRFLib_bitmap_factorisation(const char *filename_body, GMRFLib_sm_fact_tp *
 		GMRFLib_EWRAP1(GMRFLib_bitmap_factorisation_BAND(filename_body, sm_fact->bchol, graph, sm_fact->remap, sm_fact->bandwidth));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP1(GMRFLib_bitmap_factorisation_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_bitmap_factorisation_PROFILE(filename_body, sm_fact->profile, graph));
 		break;
 	case GMRFLib_SMTP_TAUCS:
 		GMRFLib_EWRAP1(GMRFLib_bitmap_factorisation_TAUCS(filename_body, sm_fact->L));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+	{
+		int loaded = (sm_fact->L == NULL);
+
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag), sm_fact->L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_bitmap_factorisation_TAUCS(filename_body, sm_fact->L));
+		if (loaded) {
+			GMRFLib_unload_fact_sparse_matrix_TAUCS_OOC(&(sm_fact->L), &(sm_fact->L_inv_diag));
+		}
+		break;
+	}
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
@@ -504,20 +679,37 @@ int GMRFLib_compute_Qinv(void *problem, int storage)
 {
 	GMRFLib_problem_tp *p = (GMRFLib_problem_tp *) problem;
 
+	GMRFLib_ENTER_ROUTINE;
 	switch (p->sub_sm_fact.smtp) {
 	case GMRFLib_SMTP_BAND:
-		GMRFLib_EWRAP0(GMRFLib_compute_Qinv_BAND(p, storage));
+		GMRFLib_EWRAP1(GMRFLib_compute_Qinv_BAND(p, storage));
 		break;
 	case GMRFLib_SMTP_PROFILE:
-		GMRFLib_EWRAP0(GMRFLib_compute_Qinv_PROFILE());
+		GMRFLib_EWRAP1(GMRFLib_compute_Qinv_PROFILE(p, storage));
 		break;
 	case GMRFLib_SMTP_TAUCS:
-		GMRFLib_EWRAP0(GMRFLib_compute_Qinv_TAUCS(p, storage));
+		GMRFLib_EWRAP1(GMRFLib_compute_Qinv_TAUCS(p, storage));
 		break;
+	case GMRFLib_SMTP_TAUCS_OOC:
+	{
+		/*
+		 * Qinv is computed on the pattern of L, so it needs the triangle in memory. free it again if it was loaded here, as
+		 * Qinv is computed once for each factorisation.
+		 */
+		int loaded = (p->sub_sm_fact.L == NULL);
+
+		GMRFLib_EWRAP1(GMRFLib_load_fact_sparse_matrix_TAUCS_OOC(&(p->sub_sm_fact.L), &(p->sub_sm_fact.L_inv_diag), p->sub_sm_fact.L_ooc));
+		GMRFLib_EWRAP1(GMRFLib_compute_Qinv_TAUCS(p, storage));
+		if (loaded) {
+			GMRFLib_unload_fact_sparse_matrix_TAUCS_OOC(&(p->sub_sm_fact.L), &(p->sub_sm_fact.L_inv_diag));
+		}
+		break;
+	}
 	default:
 		GMRFLib_ERROR(GMRFLib_ESNH);
 		break;
 	}
+	GMRFLib_LEAVE_ROUTINE;
 	return GMRFLib_SUCCESS;
 }
 
@@ -526,7 +718,7 @@ int GMRFLib_compute_Qinv(void *problem, int storage)
 */
 int GMRFLib_valid_smtp(int smtp)
 {
-	if ((smtp == GMRFLib_SMTP_BAND) || (smtp == GMRFLib_SMTP_PROFILE) || (smtp == GMRFLib_SMTP_TAUCS)) {
+	if ((smtp == GMRFLib_SMTP_BAND) || (smtp == GMRFLib_SMTP_PROFILE) || (smtp == GMRFLib_SMTP_TAUCS) || (smtp == GMRFLib_SMTP_TAUCS_OOC)) {
 		return GMRFLib_TRUE;
 	} else {
 		return GMRFLib_FALSE;
@@ -66,6 +66,12 @@ typedef struct
 }
 	GMRFLib_global_node_tp;
 
+/*!
+  \brief The number of right hand sides solved together in one pass over the factor, in the multiple right hand sides solvers
+  GMRFLib_solve_l_sparse_matrix_nrhs() and friends.
+*/
+#define GMRFLib_NRHS_BLOCK (16)
+
 
 
 typedef enum {
@@ -81,9 +87,14 @@ typedef enum {
 	GMRFLib_SMTP_TAUCS = 2,
 
 	/**
-	 * \brief An empty template. Not in use.
+	 * \brief The profile (envelope, or skyline) solver
+	 */
+	GMRFLib_SMTP_PROFILE = 3,
+
+	/**
+	 * \brief The out-of-core solver in the TAUCS-library, for problems where the Cholesky triangle does not fit in memory
 	 */
-	GMRFLib_SMTP_PROFILE = 3
+	GMRFLib_SMTP_TAUCS_OOC = 4
 } GMRFLib_smtp_tp;
 
 typedef enum {
@@ -151,6 +162,85 @@ typedef enum {
 	GMRFLib_REORDER_REVERSE_IDENTITY
 } GMRFLib_reorder_tp;
 
+/*! 
+  \struct GMRFLib_Qpattern_tp sparse-interface.h
+  \brief The sparsity pattern of the reordered Q, as used by the TAUCS-solver.
+
+  The pattern depends only on the graph and the reordering, and is computed once. For each new Q, only the values are filled in,
+  directly at their permuted position.
+ */
+typedef struct {
+
+	/**
+	 *  \brief Size of Q 
+	 */
+	int n;
+
+	/**
+	 *  \brief Number of elements in the lower triangle of Q, including the diagonal
+	 */
+	int nnz;
+
+	/**
+	 *  \brief The column-pointers of the permuted lower triangle of Q (length n+1)
+	 */
+	int *colptr;
+
+	/**
+	 *  \brief The row-indices of the permuted lower triangle of Q (length nnz)
+	 */
+	int *rowind;
+
+	/**
+	 *  \brief row_start[i] is the first element of node i in the graph-ordered listing (diagonal, then nbs[i][k] < i) (length n+1)
+	 */
+	int *row_start;
+
+	/**
+	 *  \brief vidx[k] is the index into the permuted values for element k in the graph-ordered listing (length nnz)
+	 */
+	int *vidx;
+
+	/**
+	 *  \brief For internal use only: the reordered Q, which shares \c colptr and \c rowind with this pattern, so that only its
+	 *  values are refilled for each new Q
+	 */
+	taucs_ccs_matrix *Q;
+
+	/**
+	 *  \brief For internal use only: TRUE while \c Q is used, between building and factorising Q. Other users then get a
+	 *  temporary matrix which also shares \c colptr and \c rowind
+	 */
+	int Q_in_use;
+
+	/**
+	 *  \brief For internal use only: the number of additional users of this (read-only) pattern
+	 *
+	 * Set by GMRFLib_share_Qpattern_TAUCS(). GMRFLib_free_Qpattern_TAUCS() only decrease this counter while it is positive,
+	 * as for GMRFLib_graph_tp::nref and GMRFLib_constr_tp::nref. \n\n
+	 */
+	int nref;
+} GMRFLib_Qpattern_tp;
+
+/*! 
+  \struct GMRFLib_ooc_fact_tp sparse-interface.h
+  \brief The Cholesky factorisation on disk, as used by the out-of-core TAUCS-solver.
+
+  The files are read-only once written, so a duplicated problem shares them, see GMRFLib_share_fact_TAUCS_OOC().
+ */
+typedef struct {
+
+	/**
+	 *  \brief The TAUCS handle to the files
+	 */
+	taucs_io_handle *io;
+
+	/**
+	 *  \brief For internal use only: the number of additional users of the files, as for GMRFLib_Qpattern_tp::nref
+	 */
+	int nref;
+} GMRFLib_ooc_fact_tp;
+
 /*! 
   \struct GMRFLib_fact_info_tp problem-setup.h
   \brief Description of Qmatrix
@@ -173,6 +263,41 @@ typedef struct {
 	int nfillin;
 } GMRFLib_fact_info_tp;
 
+/*! 
+  \struct GMRFLib_profile_tp sparse-interface.h
+  \brief A lower triangular matrix in profile (envelope) storage, as used by GMRFLib_SMTP_PROFILE
+
+  Row \c i holds the elements in columns <tt>first[i], ..., i</tt>, stored contiguously in <tt>val[ptr[i]], ..., val[ptr[i+1]-1]</tt>,
+  so the diagonal is the last one. The Cholesky triangle has the same profile as the lower triangle of \c Q.
+ */
+typedef struct {
+
+	/**
+	 *  \brief Size of the matrix
+	 */
+	int n;
+
+	/**
+	 *  \brief The column of the first element in each row
+	 */
+	int *first;
+
+	/**
+	 *  \brief The last row whose profile includes column \c j, for each column \c j
+	 */
+	int *last;
+
+	/**
+	 *  \brief The start of each row in \c val (length n+1)
+	 */
+	size_t *ptr;
+
+	/**
+	 *  \brief The values
+	 */
+	double *val;
+} GMRFLib_profile_tp;
+
 typedef struct {
 
 	/**
@@ -195,6 +320,11 @@ typedef struct {
 	 */
 	int bandwidth;
 
+	/**
+	 *  \brief The Cholesky factorisation (smtp == PROFILE)
+	 */
+	GMRFLib_profile_tp *profile;
+
 	/**
 	 *  \brief The Cholesky factorisation (smtp == TAUCS)
 	 */
@@ -210,6 +340,17 @@ typedef struct {
 	 */
 	double *L_inv_diag;
 
+	/**
+	 *  \brief The sparsity pattern of the permuted Q (smtp == TAUCS)
+	 */
+	GMRFLib_Qpattern_tp *Qpattern;
+
+	/**
+	 *  \brief The Cholesky factorisation on disk (smtp == TAUCS_OOC). \c L and \c L_inv_diag are only loaded from this one
+	 *  when needed.
+	 */
+	GMRFLib_ooc_fact_tp *L_ooc;
+
 	 /**
 	 *  \brief Info about the factorization 
 	 */
@@ -234,6 +375,10 @@ int GMRFLib_solve_llt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * fa
 int GMRFLib_solve_lt_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph, int findx, int toindx, int remapped);
 int GMRFLib_solve_l_sparse_matrix(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
 int GMRFLib_solve_l_sparse_matrix_special(double *rhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph, int findx, int toindx, int remapped);
+int GMRFLib_solve_l_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
+int GMRFLib_solve_lt_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
+int GMRFLib_solve_llt_sparse_matrix_nrhs(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
+int GMRFLib_solve_nrhs_sparse_matrix(double *rhs, int nrhs, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph, int what);
 int GMRFLib_comp_cond_meansd(double *cmean, double *csd, int indx, double *x, int remapped, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
 int GMRFLib_log_determinant(double *logdet, GMRFLib_sm_fact_tp * sm_fact, GMRFLib_graph_tp * graph);
 int GMRFLib_compute_Qinv(void *problem, int storage);
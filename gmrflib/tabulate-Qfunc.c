@@ -95,6 +95,26 @@ static unsigned char ADD_MULTIPLE_ENTRIES = 0;		       /* 1: allow, 0: no allow
 		}							\
 	}
 
+static double tabulate_flat_get(GMRFLib_tabulate_Qfunc_arg_tp * args, int node, int nnode)
+{
+	/*
+	 * Q_ij is stored in the row of max(i,j). the neighbours are sorted, so the position of min(i,j) is found by bisection 
+	 */
+	int i = IMAX(node, nnode), j = IMIN(node, nnode), m, half, *base, *nbs;
+
+	if (i == j) {
+		return args->flat[args->row_start[i]];
+	}
+	nbs = base = args->graph->nbs[i];
+	m = args->graph->nnbs[i];
+	while (m > 1) {
+		half = m / 2;
+		base = (base[half] <= j ? base + half : base);
+		m -= half;
+	}
+	return (m && *base == j ? args->flat[args->row_start[i] + 1 + (int) (base - nbs)] : 0.0);
+}
+
 double GMRFLib_tabulate_Qfunction(int node, int nnode, void *arg)
 {
 	GMRFLib_tabulate_Qfunc_arg_tp *args = NULL;
@@ -103,11 +123,18 @@ double GMRFLib_tabulate_Qfunction(int node, int nnode, void *arg)
 	args = (GMRFLib_tabulate_Qfunc_arg_tp *) arg;
 	prec = GMRFLib_SET_PREC(args);
 
+	if (args->flat) {
+		return prec * tabulate_flat_get(args, node, nnode);
+	}
 	return prec * (*map_id_ptr(args->values[IMIN(node, nnode)], IMAX(node, nnode)));
 }
 double GMRFLib_tabulate_Qfunction_std(int node, int nnode, void *arg)
 {
 	GMRFLib_tabulate_Qfunc_arg_tp *args = (GMRFLib_tabulate_Qfunc_arg_tp *) arg;
+
+	if (args->flat) {
+		return tabulate_flat_get(args, node, nnode);
+	}
 	return (*map_id_ptr(args->values[IMIN(node, nnode)], IMAX(node, nnode)));
 }
 
@@ -165,28 +192,35 @@ int GMRFLib_tabulate_Qfunc(GMRFLib_tabulate_Qfunc_tp ** tabulate_Qfunc, GMRFLib_
 		arg->log_prec_omp = NULL;
 	}
 
-	arg->values = Calloc(graph->n, map_id *);
+	/*
+	 * the values are stored in one array, in the graph-ordered listing (Q_ii, then Q_ij for the neighbours j < i), which is
+	 * the same listing as in GMRFLib_Qpattern_tp. Q_ij is evaluated as Qfunc(min(i,j), max(i,j)).
+	 */
+	arg->graph = GMRFLib_share_graph(graph);
+	arg->row_start = Calloc(graph->n + 1, int);
+	for (i = 0; i < graph->n; i++) {
+		int k;
+
+		for (k = 0; k < graph->nnbs[i] && graph->nbs[i][k] < i; k++);
+		arg->row_start[i + 1] = arg->row_start[i] + 1 + k;
+	}
+	arg->flat = Calloc(IMAX(1, arg->row_start[graph->n]), double);
 
 #pragma omp parallel for private(i)
 	for (i = 0; i < graph->n; i++) {
-		int j, k, count;
+		int j, k;
+		double *val = arg->flat + arg->row_start[i];
 
 		GMRFLib_thread_id = id;
 		GMRFLib_meminfo_thread_id = mem_id;
 
-		arg->values[i] = Calloc(1, map_id);	       /* allocate hash-table */
-		for (j = 0, count = 1; j < graph->nnbs[i]; j++) {	/* count the number of terms in the hash-table */
-			if (graph->nbs[i][j] > i) {
-				count++;
-			}
-		}
-		map_id_init_hint(arg->values[i], count);       /* init hash with count number of elms */
-		map_id_set(arg->values[i], i, (*Qfunc) (i, i, Qfunc_arg));	/* diagonal */
-		for (j = 0, count = 1; j < graph->nnbs[i]; j++) {
-			k = graph->nbs[i][j];
-			if (k > i) {			       /* store only those */
-				map_id_set(arg->values[i], k, (*Qfunc) (i, k, Qfunc_arg));
+		*val++ = (*Qfunc) (i, i, Qfunc_arg);  /* diagonal */
+		for (k = 0; k < graph->nnbs[i]; k++) {
+			j = graph->nbs[i][k];
+			if (j > i) {
+				break;
 			}
+			*val++ = (*Qfunc) (j, i, Qfunc_arg);
 		}
 	}
 	GMRFLib_thread_id = id;
@@ -717,11 +751,16 @@ int GMRFLib_free_tabulate_Qfunc(GMRFLib_tabulate_Qfunc_tp * tabulate_Qfunc)
 	if (tabulate_Qfunc) {
 		arg = (GMRFLib_tabulate_Qfunc_arg_tp *) tabulate_Qfunc->Qfunc_arg;
 
-		for (i = 0; i < arg->n; i++) {
-			map_id_free(arg->values[i]);
-			Free(arg->values[i]);
+		if (arg->values) {
+			for (i = 0; i < arg->n; i++) {
+				map_id_free(arg->values[i]);
+				Free(arg->values[i]);
+			}
+			Free(arg->values);
 		}
-		Free(arg->values);
+		Free(arg->flat);
+		Free(arg->row_start);
+		GMRFLib_free_graph(arg->graph);
 		Free(arg->log_prec_omp);
 		Free(arg);
 		Free(tabulate_Qfunc);
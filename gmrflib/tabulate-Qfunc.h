@@ -64,6 +64,9 @@ __BEGIN_DECLS
     typedef struct {
 	int n;						       /* the size of the graph */
 	map_id **values;				       /* hash-table for the values */
+	GMRFLib_graph_tp *graph;			       /* if not NULL, the values are in 'flat' instead */
+	int *row_start;					       /* flat[row_start[i]] is Q_ii, followed by Q_ij for nbs[i][k] = j < i */
+	double *flat;					       /* the values in the graph-ordered listing, as in GMRFLib_Qpattern_tp */
 	double *prec;					       /* precision */
 	double *log_prec;				       /* log(prec) */
 	double **log_prec_omp;				       /* log(prec) thread dependent */
@@ -485,6 +485,8 @@ typedef struct {
 
 	int *up_blocks_ld;				       /* lda of update blocks */
 	taucs_datatype **up_blocks;			       /* update blocks */
+
+	void *shared;					       /* GMRFLib: the symbolic part is shared with other copies, if non-NULL */
 } supernodal_factor_matrix;
 
 __END_DECLS
@@ -220,6 +220,14 @@ int taucs_ooc_factor_llt(taucs_ccs_matrix * A, taucs_io_handle * L, double memor
 int taucs_ooc_solve_llt(void *L /* actual type: taucs_io_handle* */ ,
 			void *x, void *b);
 
+int taucs_dtl(ooc_log_determinant) (void *L /* actual type: taucs_io_handle* */ ,
+				    double *logdet);
+taucs_ccs_matrix *taucs_dtl(ooc_factor_to_ccs) (void *L /* actual type: taucs_io_handle* */ );
+
+int taucs_ooc_log_determinant(void *L /* actual type: taucs_io_handle* */ ,
+			      double *logdet);
+taucs_ccs_matrix *taucs_ooc_factor_to_ccs(void *L /* actual type: taucs_io_handle* */ );
+
 /*********************************************************/
 
 /* Out-of-core Sparse LU                                 */
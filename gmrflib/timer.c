@@ -36,6 +36,11 @@
   The normal usage is to use \c GMRFLib_cpu() to get the CPU time used since a fixed reference,
   and \c GMRFLib_timer_full_report() to display statistics of the most computational demanding
   routines in \c GMRFLib (if  \c GMRFLib_collect_timer_statistics = \c TRUE).
+
+  Each call-site of \c GMRFLib_ENTER_ROUTINE and \c GMRFLib_LEAVE_ROUTINE registers its (stripped) function name once, and
+  keeps the slot-number in a static variable. Timings are accumulated in a table private to each thread without any locking,
+  and the tables of all threads are merged when reporting. Both wall-clock time and CPU time (of the calling thread) are
+  collected.
  
   \sa GMRFLib_collect_timer_statistics
 */
@@ -53,7 +58,6 @@
 
 #include "GMRFLib/GMRFLib.h"
 #include "GMRFLib/GMRFLibP.h"
-#include "GMRFLib/hashP.h"
 
 #ifndef HGVERSION
 #define HGVERSION
@@ -62,7 +66,16 @@ static const char RCSId[] = "file: " __FILE__ "  " HGVERSION;
 
 /* Pre-hg-Id: $Id: timer.c,v 1.58 2010/03/16 22:39:25 hrue Exp $ */
 
-static map_strvp *GMRFLib_timer_hashtable;
+/*
+ * the registered names, and the per-thread tables. a thread adds its table to the list the first time it use the timer.
+ */
+static char *GMRFLib_timer_names[GMRFLib_TIMER_MAX_SLOTS];
+static int GMRFLib_timer_nslots = 0;
+static GMRFLib_timer_hashval_tp **GMRFLib_timer_tables = NULL;
+static int GMRFLib_timer_ntables = 0;
+
+static GMRFLib_timer_hashval_tp *GMRFLib_timer_table = NULL;
+#pragma omp threadprivate(GMRFLib_timer_table)
 
 /* 
    if we have openmp, then use this function
@@ -109,6 +122,25 @@ double GMRFLib_cpu_default(void)
 #endif							       /* if defined(__linux__)... */
 #endif							       /* if defined(_OPENMP)... */
 
+#if defined(__linux__) || defined(__linux)
+#include <time.h>
+double GMRFLib_cpu_thread(void)
+{
+	/*
+	 * the CPU time used by the calling thread 
+	 */
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1.0e-9;
+}
+#else
+double GMRFLib_cpu_thread(void)
+{
+	return (double) clock() / (double) CLOCKS_PER_SEC;
+}
+#endif
+
 /*
   here are functions for storing and reporting timing information
 */
@@ -116,8 +148,8 @@ int GMRFLib_timer_compare(const void *a, const void *b)
 {
 	const GMRFLib_timer_hashval_tp *aa, *bb;
 
-	aa = (const GMRFLib_timer_hashval_tp *) (((const map_strvp_element *) a)->value);
-	bb = (const GMRFLib_timer_hashval_tp *) (((const map_strvp_element *) b)->value);
+	aa = (const GMRFLib_timer_hashval_tp *) a;
+	bb = (const GMRFLib_timer_hashval_tp *) b;
 
 	/*
 	 * sort by name if both are empty 
@@ -134,98 +166,168 @@ int GMRFLib_timer_compare(const void *a, const void *b)
 		return 1;
 	return (aa->ctime_acc / aa->ntimes > bb->ctime_acc / bb->ntimes ? -1 : 1);
 }
-int GMRFLib_timer_enter(const char *name)
+int GMRFLib_timer_register(const char *name)
 {
-#pragma omp critical
+	/*
+	 * return the slot for `name', and add it if its not already there. this is called once for each call-site. if the
+	 * table is full, all new names share slot 0.
+	 */
+	int i, slot = -1;
+
+#pragma omp critical (GMRFLib_timer_register)
 	{
-		GMRFLib_timer_hashval_tp *p;
-		void *vpp;
-		char *cname;
-
-		cname = GMRFLib_strdup(name);
-
-		if (!GMRFLib_timer_hashtable) {
-			{
-				if (!GMRFLib_timer_hashtable) {
-					int i;
-					map_strvp *tmp;
-
-					tmp = Calloc(GMRFLib_MAX_THREADS, map_strvp);
-					for (i = 0; i < GMRFLib_MAX_THREADS; i++) {
-						map_strvp_init_hint(&tmp[i], 30);	/* about the number of elmements in the hash-table */
-					}
-					GMRFLib_timer_hashtable = tmp;
-				}
+		if (GMRFLib_timer_nslots == 0) {
+			GMRFLib_timer_names[GMRFLib_timer_nslots++] = GMRFLib_strdup("(other)");
+		}
+		for (i = 0; i < GMRFLib_timer_nslots && slot < 0; i++) {
+			if (!strcmp(GMRFLib_timer_names[i], name)) {
+				slot = i;
 			}
 		}
-		if ((vpp = map_strvp_ptr(&GMRFLib_timer_hashtable[omp_get_thread_num()], cname))) {
-			p = *((GMRFLib_timer_hashval_tp **) vpp);
-			Free(cname);
-		} else {
-			p = Calloc(1, GMRFLib_timer_hashval_tp);
-			p->name = GMRFLib_strdup(name);
-			map_strvp_set(&GMRFLib_timer_hashtable[omp_get_thread_num()], cname, (void *) p);
+		if (slot < 0) {
+			if (GMRFLib_timer_nslots < GMRFLib_TIMER_MAX_SLOTS) {
+				slot = GMRFLib_timer_nslots;
+				GMRFLib_timer_names[slot] = GMRFLib_strdup(name);
+#pragma omp flush
+				GMRFLib_timer_nslots++;
+			} else {
+				slot = 0;
+			}
 		}
+	}
+	return slot;
+}
+GMRFLib_timer_hashval_tp *GMRFLib_timer_thread_table(void)
+{
+	/*
+	 * return the table for this thread, creating it if needed 
+	 */
+	if (!GMRFLib_timer_table) {
+		GMRFLib_timer_table = Calloc(GMRFLib_TIMER_MAX_SLOTS, GMRFLib_timer_hashval_tp);
+#pragma omp critical (GMRFLib_timer_tables)
+		{
+			GMRFLib_timer_tables = Realloc(GMRFLib_timer_tables, GMRFLib_timer_ntables + 1, GMRFLib_timer_hashval_tp *);
+			GMRFLib_timer_tables[GMRFLib_timer_ntables++] = GMRFLib_timer_table;
+		}
+	}
+	return GMRFLib_timer_table;
+}
+int GMRFLib_timer_enter_slot(int slot)
+{
+	GMRFLib_timer_hashval_tp *p = GMRFLib_timer_thread_table() + slot;
 
+	/*
+	 * if ctime_ref > 0.0, then this routine is already initialized. in this case, we keep the first. 
+	 */
+	if (p->ctime_ref <= 0.0) {
+		p->ctime_ref = GMRFLib_cpu();
+		p->cpu_ref = GMRFLib_cpu_thread();
+	}
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_timer_leave_slot(int slot)
+{
+	GMRFLib_timer_hashval_tp *p = GMRFLib_timer_thread_table() + slot;
+	double used;
+
+	if (p->ctime_ref <= 0.0) {
 		/*
-		 * if ctime_ref > 0.0, then this routine is already initialized. in this case, we keep the first. 
+		 * this is an ``illegal instruction''. _timer_leave is called without a corresponding call to _timer_enter.
+		 * this happens, with purpose, with some of the `__intern' routines, and in the _EWRAP() macro.
 		 */
-		if (p->ctime_ref <= 0.0) {
-			{
-				if (p->ctime_ref <= 0.0) {
-					p->ctime_ref = GMRFLib_cpu();
-				}
-			}
+	} else {
+		used = GMRFLib_cpu() - p->ctime_ref;
+		used = DMAX(0.0, used);			       /* yes */
+		p->ctime_acc += used;
+		p->ctime_acc2 += SQR(used);
+		if (p->ntimes) {
+			p->ctime_min = DMIN(p->ctime_min, used);
+			p->ctime_max = DMAX(p->ctime_max, used);
+		} else {
+			p->ctime_min = p->ctime_max = used;
 		}
+		p->cpu_acc += DMAX(0.0, GMRFLib_cpu_thread() - p->cpu_ref);
+
+		p->ctime_ref = -1.0;			       /* flag it specially */
+		p->ntimes++;
 	}
 	return GMRFLib_SUCCESS;
 }
+int GMRFLib_timer_enter(const char *name)
+{
+	return GMRFLib_timer_enter_slot(GMRFLib_timer_register(name));
+}
 int GMRFLib_timer_leave(const char *name)
 {
-#pragma omp critical
-	{
-		GMRFLib_timer_hashval_tp *p;
-		void *vpp;
-		double used;
-		char *cname;
-		int ret = 0;
-
-		cname = GMRFLib_strdup(name);
-
-		if ((vpp = map_strvp_ptr(&GMRFLib_timer_hashtable[omp_get_thread_num()], cname))) {
-			p = *((GMRFLib_timer_hashval_tp **) vpp);
-			Free(cname);
-		} else {
-			/*
-			 * this happen if _leave is executed but with no matching _enter, for example in the _EWRAP() macro. 
-			 */
-			Free(cname);
-			ret = 1;
-		}
+	return GMRFLib_timer_leave_slot(GMRFLib_timer_register(name));
+}
+int GMRFLib_timer_merge(GMRFLib_timer_hashval_tp ** merged, int *nmerged)
+{
+	/*
+	 * merge the tables for all threads. return a Calloc'ed array of length *nmerged, where the names are shared with the
+	 * registry and must not be free'd.
+	 */
+	int i, k, n;
+	GMRFLib_timer_hashval_tp *m = NULL, *p = NULL;
 
-		if (!ret) {
-			if (p->ctime_ref < 0.0) {
-				/*
-				 * this is an ``illegal instruction''. _timer_leave is called without a corresponding call to _timer_enter.
-				 * this happens, with purpose, with some of the `__intern' routines. 
-				 */
-			} else {
-				used = GMRFLib_cpu() - p->ctime_ref;
-				used = DMAX(0.0, used);	       /* yes */
-				p->ctime_acc += used;
-				p->ctime_acc2 += SQR(used);
-				if (p->ntimes) {
-					p->ctime_min = DMIN(p->ctime_min, used);
-					p->ctime_max = DMAX(p->ctime_max, used);
+#pragma omp critical (GMRFLib_timer_tables)
+	{
+		n = GMRFLib_timer_nslots;
+		m = Calloc(IMAX(1, n), GMRFLib_timer_hashval_tp);
+		for (i = 0; i < n; i++) {
+			m[i].name = GMRFLib_timer_names[i];
+			for (k = 0; k < GMRFLib_timer_ntables; k++) {
+				p = &(GMRFLib_timer_tables[k][i]);
+				if (!p->ntimes) {
+					continue;
+				}
+				if (m[i].ntimes) {
+					m[i].ctime_min = DMIN(m[i].ctime_min, p->ctime_min);
+					m[i].ctime_max = DMAX(m[i].ctime_max, p->ctime_max);
 				} else {
-					p->ctime_min = p->ctime_max = used;
+					m[i].ctime_min = p->ctime_min;
+					m[i].ctime_max = p->ctime_max;
 				}
-
-				p->ctime_ref = -1.0;	       /* flag it specially */
-				p->ntimes++;
+				m[i].ntimes += p->ntimes;
+				m[i].ctime_acc += p->ctime_acc;
+				m[i].ctime_acc2 += p->ctime_acc2;
+				m[i].cpu_acc += p->cpu_acc;
 			}
 		}
 	}
+	*merged = m;
+	*nmerged = n;
+
+	return GMRFLib_SUCCESS;
+}
+int GMRFLib_timer_lookup(const char *name, double *ntimes, double *wall, double *cpu)
+{
+	/*
+	 * return the merged statistics for function `name', or zeros if its not there 
+	 */
+	int i, n;
+	GMRFLib_timer_hashval_tp *m = NULL;
+
+	GMRFLib_timer_merge(&m, &n);
+	if (ntimes)
+		*ntimes = 0.0;
+	if (wall)
+		*wall = 0.0;
+	if (cpu)
+		*cpu = 0.0;
+	for (i = 0; i < n; i++) {
+		if (!strcmp(m[i].name, name)) {
+			if (ntimes)
+				*ntimes = m[i].ntimes;
+			if (wall)
+				*wall = m[i].ctime_acc;
+			if (cpu)
+				*cpu = m[i].cpu_acc;
+			break;
+		}
+	}
+	Free(m);
+
 	return GMRFLib_SUCCESS;
 }
 const char *GMRFLib_timer_strip_store(const char *name)
@@ -309,10 +411,11 @@ const char *GMRFLib_timer_strip(const char *name)
 
 int GMRFLib_timer_print_entry(FILE * ffp, GMRFLib_timer_hashval_tp * p)
 {
-	fprintf(ffp, "%-41s %10.6f %6d %10.6f %10.6f %10.6f %10.6f\n",
+	fprintf(ffp, "%-41s %10.6f %8d %10.6f %10.6f %10.6f %10.6f %10.6f\n",
 		p->name, (p->ntimes ? p->ctime_acc / p->ntimes : 0.0),
 		(int) p->ntimes, p->ctime_acc,
-		(p->ntimes ? sqrt(DMAX(0.0, p->ctime_acc2 / p->ntimes - SQR(p->ctime_acc / p->ntimes))) : 0.0), p->ctime_min, p->ctime_max);
+		(p->ntimes ? sqrt(DMAX(0.0, p->ctime_acc2 / p->ntimes - SQR(p->ctime_acc / p->ntimes))) : 0.0), p->ctime_min, p->ctime_max,
+		p->cpu_acc);
 
 	return GMRFLib_SUCCESS;
 }
@@ -323,47 +426,66 @@ int GMRFLib_timer_print_entry(FILE * ffp, GMRFLib_timer_hashval_tp * p)
   \param[in] fp Pointer to (an already open) file the report is written to.
   \param[in] name The name of the function for which statistics is to be reported. If \c name =
   \c NULL, then the statistics for all functions are displayed
+
+  The statistics are summed over all threads. Total, Stdev, Min and Max are wall-clock times, CPU is the CPU time used by the
+  calling threads.
                                                                                                                   
   \sa GMRFLib_timer_full_report
 */
 int GMRFLib_timer_report(FILE * fp, const char *name)
 {
-	GMRFLib_timer_hashval_tp *p;
-	void *vpp;
 	FILE *ffp;
-	const char *sep = "-------------------------------------------------------------------------------------------------------";
-	char *cname;
-	int k;
+	const char *sep = "------------------------------------------------------------------------------------------------------------------";
+	GMRFLib_timer_hashval_tp *m = NULL;
+	int i, n;
 
-	if (!GMRFLib_timer_hashtable) {
+	if (!GMRFLib_timer_ntables) {
 		return GMRFLib_SUCCESS;
 	}
 	ffp = (fp ? fp : stdout);
 
-	for (k = 0; k < GMRFLib_MAX_THREADS; k++) {
-		fprintf(ffp, "\n\nGMRFLib report on time usage for thread %1d\n%-41s %10s %6s %10s %10s %10s %10s\n%s\n",
-			k, "Function", "Mean", "N", "Total", "Stdev", "Min", "Max", sep);
-		if (name) {
-			cname = GMRFLib_strdup(name);
-			if ((vpp = map_strvp_ptr(&GMRFLib_timer_hashtable[k], cname))) {
-				p = *((GMRFLib_timer_hashval_tp **) vpp);
-				GMRFLib_timer_print_entry(ffp, p);
-			}
-			Free(cname);
-		} else {
-			map_strvp_element *all;
-			mapkit_size_t count, i;
+	GMRFLib_timer_merge(&m, &n);
+	qsort(m, (size_t) n, sizeof(GMRFLib_timer_hashval_tp), GMRFLib_timer_compare);
 
-			map_strvp_getall(&GMRFLib_timer_hashtable[k], &all, &count);
-			qsort(all, (size_t) count, sizeof(map_strvp_element), GMRFLib_timer_compare);
-			for (i = 0; i < count; i++) {
-				GMRFLib_timer_print_entry(ffp, (GMRFLib_timer_hashval_tp *) (all[i].value));
-			}
-			free(all);
-			all = NULL;
+	fprintf(ffp, "\n\nGMRFLib report on time usage for %1d threads\n%-41s %10s %8s %10s %10s %10s %10s %10s\n%s\n",
+		GMRFLib_timer_ntables, "Function", "Mean", "N", "Total", "Stdev", "Min", "Max", "CPU", sep);
+	for (i = 0; i < n; i++) {
+		if (!name || !strcmp(name, m[i].name)) {
+			GMRFLib_timer_print_entry(ffp, &m[i]);
 		}
-		fprintf(ffp, "%s\n", sep);
 	}
+	fprintf(ffp, "%s\n", sep);
+	Free(m);
+
+	return GMRFLib_SUCCESS;
+}
+
+/*!
+  \brief Write the statistics collected for all functions to \c fp as a JSON array.
+
+  The array has one object for each function called, with members \c "name", \c "n", \c "wall", \c "wall_min", \c "wall_max"
+  and \c "cpu" (in seconds, summed over threads). The array is not terminated with a newline, so it can be used as a value
+  inside an object written by the caller.
+*/
+int GMRFLib_timer_report_json(FILE * fp)
+{
+	GMRFLib_timer_hashval_tp *m = NULL;
+	int i, n, first = 1;
+
+	GMRFLib_timer_merge(&m, &n);
+	qsort(m, (size_t) n, sizeof(GMRFLib_timer_hashval_tp), GMRFLib_timer_compare);
+
+	fprintf(fp, "[");
+	for (i = 0; i < n; i++) {
+		if (m[i].ntimes) {
+			fprintf(fp, "%s\n\t\t{\"name\": \"%s\", \"n\": %.0f, \"wall\": %.6f, \"wall_min\": %.6f, \"wall_max\": %.6f, \"cpu\": %.6f}",
+				(first ? "" : ","), m[i].name, m[i].ntimes, m[i].ctime_acc, m[i].ctime_min, m[i].ctime_max, m[i].cpu_acc);
+			first = 0;
+		}
+	}
+	fprintf(fp, "\n\t]");
+	Free(m);
+
 	return GMRFLib_SUCCESS;
 }
 
@@ -379,7 +501,7 @@ int GMRFLib_timer_report(FILE * fp, const char *name)
 */
 int GMRFLib_timer_full_report(FILE * fp)
 {
-	if (!GMRFLib_timer_hashtable) {
+	if (!GMRFLib_timer_ntables) {
 		return GMRFLib_SUCCESS;
 	}
 	return GMRFLib_timer_report(fp, NULL);
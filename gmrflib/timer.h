@@ -68,27 +68,54 @@ __BEGIN_DECLS
 	double ctime_min;				       /* minimum time used */
 	double ctime_max;				       /* maximum times used */
 	double ctime_acc2;				       /* accumulated ctime^2 */
+
+	double cpu_acc;					       /* accumulated cpu-time for this thread */
+	double cpu_ref;					       /* last reference cpu-time */
 } GMRFLib_timer_hashval_tp;
 
+/*!
+  \brief The maximum number of different function names the timer can keep track of.
+*/
+#define GMRFLib_TIMER_MAX_SLOTS (1024)
+
 /*!
   \brief Macro to be placed at the entry point of each routine which CPU time is be monitored.
+
+  The name is registered only the first time, and the slot is kept in a static variable local to the call-site.
 */
-#define GMRFLib_ENTER_ROUTINE if (1) { if (GMRFLib_collect_timer_statistics) GMRFLib_timer_enter(GMRFLib_timer_strip(__GMRFLib_FuncName));}
+#define GMRFLib_ENTER_ROUTINE if (1) {					\
+		if (GMRFLib_collect_timer_statistics) {			\
+			static int _timer_slot = -1;			\
+			if (_timer_slot < 0) _timer_slot = GMRFLib_timer_register(GMRFLib_timer_strip(__GMRFLib_FuncName)); \
+			GMRFLib_timer_enter_slot(_timer_slot);		\
+		}							\
+	}
 
 /*!
   \brief Macro to be placed at \em each exit point of each routine which CPU time is be monitored.
 */
-#define GMRFLib_LEAVE_ROUTINE if (1) { if (GMRFLib_collect_timer_statistics) GMRFLib_timer_leave(GMRFLib_timer_strip(__GMRFLib_FuncName));}
-
+#define GMRFLib_LEAVE_ROUTINE if (1) {					\
+		if (GMRFLib_collect_timer_statistics) {			\
+			static int _timer_slot = -1;			\
+			if (_timer_slot < 0) _timer_slot = GMRFLib_timer_register(GMRFLib_timer_strip(__GMRFLib_FuncName)); \
+			GMRFLib_timer_leave_slot(_timer_slot);		\
+		}							\
+	}
+
 double GMRFLib_cpu_default(void);
-int GMRFLib_timer_table_expand(void);
-int GMRFLib_timer_find_entry(const char *name);
+double GMRFLib_cpu_thread(void);
 int GMRFLib_timer_compare(const void *a, const void *b);
-int GMRFLib_timer_table_sort(void);
+int GMRFLib_timer_register(const char *name);
+GMRFLib_timer_hashval_tp *GMRFLib_timer_thread_table(void);
+int GMRFLib_timer_enter_slot(int slot);
+int GMRFLib_timer_leave_slot(int slot);
 int GMRFLib_timer_enter(const char *name);
 int GMRFLib_timer_leave(const char *name);
+int GMRFLib_timer_merge(GMRFLib_timer_hashval_tp ** merged, int *nmerged);
+int GMRFLib_timer_lookup(const char *name, double *ntimes, double *wall, double *cpu);
 int GMRFLib_timer_print_entry(FILE * ffp, GMRFLib_timer_hashval_tp * p);
 int GMRFLib_timer_report(FILE * fp, const char *name);
+int GMRFLib_timer_report_json(FILE * fp);
 int GMRFLib_timer_full_report(FILE * fp);
 const char *GMRFLib_timer_strip_store(const char *name);
 const char *GMRFLib_timer_strip__intern(const char *name);
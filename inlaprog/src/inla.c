@@ -53,12 +53,14 @@ static const char RCSId[] = HGVERSION;
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <strings.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
 
 #if !defined(WINDOWS)
+#include <sys/mman.h>
 #include <sys/resource.h>
 #endif
 
@@ -102,7 +104,7 @@ static const char RCSId[] = HGVERSION;
 #define AR_MAXTHETA   (10)				       /* as given in models.R */
 #define LINK_MAXTHETA (10)				       /* as given in models.R */
 
-G_tp G = { 0, 1, INLA_MODE_DEFAULT, 4.0, 0.5, 2, 0, -1, 0, 0 };
+G_tp G = { 0, 0, 1, INLA_MODE_DEFAULT, 4.0, 0.5, 2, 0, -1, 0, 0 };
 
 /* 
    default values for priors
@@ -127,6 +129,11 @@ G_tp G = { 0, 1, INLA_MODE_DEFAULT, 4.0, 0.5, 2, 0, -1, 0, 0 };
 #define LINK_END  \
 	Free(_link_covariates)
 
+/* 
+   the theta-independent part of the log-likelihood for observation 'idx', from the cache if it is there. see inla_read_data_likelihood()
+ */
+#define LOGL_CONST(expr_) (ds->data_observations.logl_const ? ds->data_observations.logl_const[idx] : (expr_))
+
 #define PREDICTOR_INVERSE_LINK(xx_)  \
 	ds->predictor_invlinkfunc(xx_, MAP_FORWARD, ds->predictor_invlinkfunc_arg, _link_covariates)
 
@@ -2801,6 +2808,12 @@ int inla_read_data_all(double **x, int *n, const char *filename)
 		}
 		GMRFLib_matrix_free(M);
 
+		return INLA_OK;
+	} else if (inla_read_data_ascii(x, n, filename) == INLA_OK) {
+		/*
+		 * the fast reader for plain ascii-files 
+		 */
+		Free(c);
 		return INLA_OK;
 	} else {
 		GMRFLib_EWRAP0(GMRFLib_io_open(&io, filename, "r"));
@@ -2834,6 +2847,237 @@ int inla_read_data_all(double **x, int *n, const char *filename)
 		return INLA_OK;
 	}
 }
+int inla_parse_double(double *x, const char *s, size_t len)
+{
+	/*
+	 * parse the token s[0],...,s[len-1] as a double, without depending on the locale. the fast path is exact (correctly
+	 * rounded) for at most 15 significant digits and a decimal exponent |e| <= 22, as then both the mantissa and 10^e are
+	 * exact doubles and there is only one rounding. otherwise, use sscanf() as GMRFLib_io_read_next() does. return 1 if
+	 * successful, and 0 otherwise.
+	 */
+	static const double p10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const char *p = s, *end = s + len;
+	int neg = 0, ndigits = 0, nfrac = 0, e = 0, eneg = 0, any = 0;
+	uint64_t m = 0;
+
+	if (p < end && (*p == '-' || *p == '+')) {
+		neg = (*p == '-');
+		p++;
+	}
+	for (; p < end && isdigit((unsigned char) *p); p++) {
+		any = 1;
+		if (m || *p != '0') {
+			m = 10 * m + (uint64_t) (*p - '0');
+			ndigits++;
+		}
+	}
+	if (p < end && *p == '.') {
+		for (p++; p < end && isdigit((unsigned char) *p); p++) {
+			any = 1;
+			if (m || *p != '0') {
+				m = 10 * m + (uint64_t) (*p - '0');
+				ndigits++;
+			}
+			nfrac++;
+		}
+	}
+	if (any && p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (p < end && (*p == '-' || *p == '+')) {
+			eneg = (*p == '-');
+			p++;
+		}
+		if (!(p < end && isdigit((unsigned char) *p))) {
+			any = 0;
+		}
+		for (; p < end && isdigit((unsigned char) *p) && e < 10000; p++) {
+			e = 10 * e + (*p - '0');
+		}
+	}
+	e = (eneg ? -e : e) - nfrac;
+
+	if (any && p == end && ndigits <= 15 && IABS(e) <= 22) {
+		*x = (e >= 0 ? (double) m * p10[e] : (double) m / p10[-e]);
+		*x = (neg ? -*x : *x);
+		return 1;
+	}
+
+	/*
+	 * the slow path 
+	 */
+	char buf[128], *b = (len < sizeof(buf) ? buf : Calloc(len + 1, char));
+	int ok;
+
+	memcpy(b, s, len);
+	b[len] = '\0';
+	ok = (sscanf(b, "%lf", x) == 1);
+	if (b != buf) {
+		Free(b);
+	}
+
+	return ok;
+}
+int inla_read_data_ascii(double **x, int *n, const char *filename)
+{
+	/*
+	 * read all numbers in an ascii-file, as inla_read_data_all() but much faster for large files. the file is memory-mapped and
+	 * split at line boundaries into one chunk for each thread. the first pass count the tokens, so the output is allocated
+	 * exactly, and the second pass parse them directly into place.
+	 *
+	 * as GMRFLib_io_read_next(), lines starting with GMRFLib_IO_COMMENT_CHAR are skipped, tokens are separated by white-space, and
+	 * we stop at the first token that is not a number.
+	 *
+	 * return !INLA_OK if the file cannot be memory-mapped or is compressed, and then the caller must use the standard reader.
+	 */
+#if defined(WINDOWS)
+	return !INLA_OK;
+#else
+#define IS_SEP(c_) ((c_) == ' ' || (c_) == '\t' || (c_) == '\n' || (c_) == '\r')
+	int fd, nt, t;
+	size_t size, *from = NULL, *ntokens = NULL, *nparsed = NULL, *offset = NULL, total;
+	char *data = NULL, *failed = NULL;
+	struct stat sb;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		return !INLA_OK;
+	}
+	if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode)) {
+		close(fd);
+		return !INLA_OK;
+	}
+	size = (size_t) sb.st_size;
+	if (size == 0) {
+		close(fd);
+		*n = 0;
+		*x = NULL;
+		return INLA_OK;
+	}
+	data = (char *) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return !INLA_OK;
+	}
+	if (size >= 2 && (unsigned char) data[0] == 0x1f && (unsigned char) data[1] == 0x8b) {
+		/*
+		 * gzip'ed file, leave it to zlib 
+		 */
+		munmap(data, size);
+		return !INLA_OK;
+	}
+	madvise(data, size, MADV_SEQUENTIAL);
+
+	/*
+	 * split into chunks of at least 1Mb, at line boundaries 
+	 */
+	nt = IMAX(1, GMRFLib_openmp->max_threads);
+	if (1 + size / 1048576 < (size_t) nt) {
+		nt = (int) (1 + size / 1048576);
+	}
+	from = Calloc(nt + 1, size_t);
+	for (t = 1; t < nt; t++) {
+		size_t i = (t * size) / nt;
+		i = (i < from[t - 1] ? from[t - 1] : i);
+		while (i < size && data[i] != '\n') {
+			i++;
+		}
+		from[t] = (i < size ? i + 1 : size);
+	}
+	from[nt] = size;
+
+	ntokens = Calloc(nt, size_t);
+	nparsed = Calloc(nt, size_t);
+	offset = Calloc(nt + 1, size_t);
+	failed = Calloc(nt, char);
+
+	/*
+	 * go through the chunk of thread t. if 'xx' is NULL, then just count the tokens, otherwise parse them into xx[] and
+	 * stop at the first one that fails
+	 */
+#define SCAN_CHUNK(t_, xx_)						\
+	{								\
+		size_t i_ = from[t_], e_ = from[(t_) + 1], k_ = 0, tok_;	\
+		int new_line_ = 1;					\
+		while (i_ < e_) {					\
+			if (new_line_ && data[i_] == GMRFLib_IO_COMMENT_CHAR[0]) { \
+				while (i_ < e_ && data[i_] != '\n') i_++; \
+				continue;				\
+			}						\
+			new_line_ = (data[i_] == '\n');			\
+			if (IS_SEP(data[i_])) {				\
+				i_++;					\
+				continue;				\
+			}						\
+			tok_ = i_;					\
+			while (i_ < e_ && !IS_SEP(data[i_])) i_++;	\
+			if (xx_) {					\
+				if (!inla_parse_double(&((xx_)[k_]), data + tok_, i_ - tok_)) { \
+					failed[t_] = 1;			\
+					break;				\
+				}					\
+			}						\
+			k_++;						\
+		}							\
+		if (xx_) {						\
+			nparsed[t_] = k_;				\
+		} else {						\
+			ntokens[t_] = k_;				\
+		}							\
+	}
+
+#pragma omp parallel for private(t) num_threads(nt)
+	for (t = 0; t < nt; t++) {
+		double *null_ptr = NULL;
+		SCAN_CHUNK(t, null_ptr);
+	}
+
+	for (t = 0; t < nt; t++) {
+		offset[t + 1] = offset[t] + ntokens[t];
+	}
+	total = offset[nt];
+
+	double *c = (total ? Calloc(total, double) : NULL);
+	if (total) {
+#pragma omp parallel for private(t) num_threads(nt)
+		for (t = 0; t < nt; t++) {
+			double *xx = c + offset[t];
+			SCAN_CHUNK(t, xx);
+		}
+	}
+
+	/*
+	 * everything after the first token that is not a number is ignored 
+	 */
+	for (t = 0, total = 0; t < nt; t++) {
+		total += nparsed[t];
+		if (failed[t]) {
+			break;
+		}
+	}
+	GMRFLib_ASSERT(total <= (size_t) INT_MAX, GMRFLib_EPARAMETER);
+
+	*n = (int) total;
+	if (total == 0) {
+		Free(c);
+		*x = NULL;
+	} else {
+		*x = c;
+	}
+
+	munmap(data, size);
+	Free(from);
+	Free(ntokens);
+	Free(nparsed);
+	Free(offset);
+	Free(failed);
+
+	return INLA_OK;
+#undef SCAN_CHUNK
+#undef IS_SEP
+#endif
+}
 int inla_read_data_likelihood(inla_tp * mb, dictionary * ini, int sec)
 {
 	/*
@@ -3145,6 +3389,88 @@ int inla_read_data_likelihood(inla_tp * mb, dictionary * ini, int sec)
 		}
 	}
 
+	/*
+	 * the theta-independent part of the log-likelihood, which otherwise is recomputed for each observation in each evaluation of the
+	 * log-likelihood, for each theta. the expressions must be the same as in the log-likelihoods, so the results do not change.
+	 */
+	int ncache = 0;
+	double tref = GMRFLib_cpu();
+
+	switch (ds->data_id) {
+	case L_POISSON:
+	case L_ZEROINFLATEDPOISSON0:
+	case L_ZEROINFLATEDPOISSON1:
+	case L_ZEROINFLATEDPOISSON2:
+	case L_NBINOMIAL:
+	case L_ZEROINFLATEDNBINOMIAL0:
+	case L_ZEROINFLATEDNBINOMIAL1:
+	case L_ZEROINFLATEDNBINOMIAL2:
+	case L_ZEROINFLATEDNBINOMIAL1STRATA2:
+	case L_ZEROINFLATEDNBINOMIAL1STRATA3:
+	case L_BINOMIAL:
+	case L_ZEROINFLATEDBINOMIAL0:
+	case L_ZEROINFLATEDBINOMIAL1:
+	case L_ZEROINFLATEDBINOMIAL2:
+	case L_ZERO_N_INFLATEDBINOMIAL2:
+	case L_GAUSSIAN:
+	case L_GAMMA:
+		ncache = mb->predictor_ndata;
+		ds->data_observations.logl_const = Calloc(ncache, double);
+		for (i = 0; i < ncache; i++) {
+			double y = ds->data_observations.y[i];
+
+			switch (ds->data_id) {
+			case L_POISSON:
+			case L_ZEROINFLATEDPOISSON0:
+			case L_ZEROINFLATEDPOISSON1:
+			case L_ZEROINFLATEDPOISSON2:
+				ds->data_observations.logl_const[i] = gsl_sf_lnfact((unsigned int) y);
+				break;
+			case L_NBINOMIAL:
+			case L_ZEROINFLATEDNBINOMIAL0:
+			case L_ZEROINFLATEDNBINOMIAL1:
+			case L_ZEROINFLATEDNBINOMIAL2:
+			case L_ZEROINFLATEDNBINOMIAL1STRATA2:
+			case L_ZEROINFLATEDNBINOMIAL1STRATA3:
+				ds->data_observations.logl_const[i] = gsl_sf_lngamma(y + 1.0);
+				break;
+			case L_BINOMIAL:
+			case L_ZEROINFLATEDBINOMIAL0:
+			case L_ZEROINFLATEDBINOMIAL1:
+			case L_ZEROINFLATEDBINOMIAL2:
+			case L_ZERO_N_INFLATEDBINOMIAL2:
+				if (y <= ds->data_observations.nb[i]) {
+					ds->data_observations.logl_const[i] =
+					    gsl_sf_lnchoose((unsigned int) ds->data_observations.nb[i], (unsigned int) y);
+				} else if (ds->data_observations.d[i]) {
+					char *msg;
+					GMRFLib_sprintf(&msg, "%s: Binomial data[%1d] (nb,y) = (%g,%g) is void\n", ds->data_likelihood,
+							i, ds->data_observations.nb[i], y);
+					inla_error_general(msg);
+				}
+				break;
+			case L_GAUSSIAN:
+				ds->data_observations.logl_const[i] = log(ds->data_observations.weight_gaussian[i]);
+				break;
+			case L_GAMMA:
+				ds->data_observations.logl_const[i] = log(y);
+				break;
+			default:
+				assert(0 == 1);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	if (mb->verbose && ncache) {
+		/*
+		 * this is the time saved for each pass over the data, ie for each Newton-iteration for each theta
+		 */
+		printf("\t\tcached the constant part of the log-likelihood for %1d observations, saving %.4fs per pass over the data\n",
+		       ncache, GMRFLib_cpu() - tref);
+	}
+
 	Free(w);
 	Free(x);
 
@@ -3211,6 +3537,180 @@ int loglikelihood_inla(double *logll, double *x, int m, int idx, double *x_vec,
 	inla_tp *a = (inla_tp *) arg;
 	return a->loglikelihood[idx] (logll, x, m, idx, x_vec, a->loglikelihood_arg[idx]);
 }
+int loglikelihood_inla_batch(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, double *x_vec, void *arg)
+{
+	/*
+	 * the batch-version of loglikelihood_inla(). consecutive observations with the same likelihood and data-section are passed on
+	 * together to the batch-version of the likelihood, if there is one. those not done are left to the scalar version.
+	 */
+	inla_tp *a = (inla_tp *) arg;
+	int k = 0, kk;
+
+	while (k < n) {
+		GMRFLib_logl_tp *logl = a->loglikelihood[idx[k]];
+		void *logl_arg = a->loglikelihood_arg[idx[k]];
+
+		for (kk = k + 1; kk < n && a->loglikelihood[idx[kk]] == logl && a->loglikelihood_arg[idx[kk]] == logl_arg; kk++);
+
+		if (logl == loglikelihood_poisson) {
+			loglikelihood_batch_poisson(f0 + k, df + k, ddf + k, done + k, kk - k, idx + k, x0 + k, (Data_section_tp *) logl_arg);
+		} else if (logl == loglikelihood_binomial) {
+			loglikelihood_batch_binomial(f0 + k, df + k, ddf + k, done + k, kk - k, idx + k, x0 + k, (Data_section_tp *) logl_arg);
+		} else if (logl == loglikelihood_gaussian) {
+			loglikelihood_batch_gaussian(f0 + k, df + k, ddf + k, done + k, kk - k, idx + k, x0 + k, (Data_section_tp *) logl_arg);
+		} else if (logl == loglikelihood_negative_binomial) {
+			loglikelihood_batch_negative_binomial(f0 + k, df + k, ddf + k, done + k, kk - k, idx + k, x0 + k, (Data_section_tp *) logl_arg);
+		} else if (logl == loglikelihood_gamma) {
+			loglikelihood_batch_gamma(f0 + k, df + k, ddf + k, done + k, kk - k, idx + k, x0 + k, (Data_section_tp *) logl_arg);
+		}
+		k = kk;
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int loglikelihood_batch_poisson(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds)
+{
+	/*
+	 * y ~ Poisson(E*exp(x)) with the log-link. f0, df and ddf are wrt the linear predictor.
+	 */
+	if (ds->link_covariates || ds->predictor_invlinkfunc != link_log) {
+		return GMRFLib_SUCCESS;
+	}
+
+	int k, i;
+	double *y = ds->data_observations.y, *E = ds->data_observations.E, *normc = ds->data_observations.logl_const, eta, mu;
+
+	for (k = 0; k < n; k++) {
+		i = idx[k];
+		eta = x0[k] + OFFSET(i);
+		mu = E[i] * exp(eta);
+		f0[k] = y[i] * (eta + (E[i] > 0.0 ? log(E[i]) : 0.0)) - mu - normc[i];
+		df[k] = y[i] - mu;
+		ddf[k] = -mu;
+		done[k] = 1;
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int loglikelihood_batch_binomial(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds)
+{
+	/*
+	 * y ~ Binomial(nb, p) with the logit-link. the boundary cases p = 0 or 1 are left to the scalar version.
+	 */
+	if (ds->link_covariates || ds->predictor_invlinkfunc != link_logit) {
+		return GMRFLib_SUCCESS;
+	}
+
+	int k, i;
+	double *y = ds->data_observations.y, *nb = ds->data_observations.nb, *lchoose = ds->data_observations.logl_const, eta, p;
+
+	for (k = 0; k < n; k++) {
+		i = idx[k];
+		if (ISZERO(y[i]) && ISZERO(nb[i])) {
+			f0[k] = df[k] = ddf[k] = 0.0;
+			done[k] = 1;
+			continue;
+		}
+		eta = x0[k] + OFFSET(i);
+		p = exp(eta) / (1.0 + exp(eta));
+		if (p > 0.0 && p < 1.0) {
+			f0[k] = lchoose[i] + y[i] * log(p) + (nb[i] - y[i]) * log(1.0 - p);
+			df[k] = y[i] - nb[i] * p;
+			ddf[k] = -nb[i] * p * (1.0 - p);
+			done[k] = 1;
+		}
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int loglikelihood_batch_gaussian(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds)
+{
+	/*
+	 * y ~ Normal(x, 1/(weight*prec)) with the identity-link. logl_const holds log(weight).
+	 */
+	if (ds->link_covariates || ds->predictor_invlinkfunc != link_identity) {
+		return GMRFLib_SUCCESS;
+	}
+
+	int k, i;
+	double *y = ds->data_observations.y, *w = ds->data_observations.weight_gaussian, *lw = ds->data_observations.logl_const;
+	double lprec = ds->data_observations.log_prec_gaussian[GMRFLib_thread_id][0];
+	double prec = map_precision(lprec, MAP_FORWARD, NULL), res;
+
+	for (k = 0; k < n; k++) {
+		i = idx[k];
+		res = x0[k] + OFFSET(i) - y[i];
+		f0[k] = LOG_NORMC_GAUSSIAN + 0.5 * (lprec + lw[i] - SQR(res) * prec * w[i]);
+		df[k] = -prec * w[i] * res;
+		ddf[k] = -prec * w[i];
+		done[k] = 1;
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int loglikelihood_batch_negative_binomial(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds)
+{
+	/*
+	 * y ~ NegativeBinomial(size, p) with E(y) = E*exp(x) and the log-link. only variant 0, and the Poisson limit is left to the scalar
+	 * version. logl_const holds lgamma(y+1).
+	 */
+	if (ds->link_covariates || ds->predictor_invlinkfunc != link_log || ds->variant != 0) {
+		return GMRFLib_SUCCESS;
+	}
+
+	int k, i;
+	double *y = ds->data_observations.y, *E = ds->data_observations.E, *lfact = ds->data_observations.logl_const;
+	double size = exp(ds->data_observations.log_size[GMRFLib_thread_id][0]), lgamma_size = gsl_sf_lngamma(size);
+	double cutoff = 1.0e-4, mu, p;
+
+	for (k = 0; k < n; k++) {
+		i = idx[k];
+		mu = E[i] * exp(x0[k] + OFFSET(i));
+		if (mu / size > cutoff) {
+			p = size / (size + mu);
+			f0[k] = gsl_sf_lngamma(y[i] + size) - lgamma_size - lfact[i] + size * log(p) + y[i] * log(1.0 - p);
+			df[k] = size * (y[i] - mu) / (size + mu);
+			ddf[k] = -(size + y[i]) * size * mu / SQR(size + mu);
+			done[k] = 1;
+		}
+	}
+
+	return GMRFLib_SUCCESS;
+}
+int loglikelihood_batch_gamma(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds)
+{
+	/*
+	 * y ~ Gamma with mean exp(x) and precision phi*s, with the log-link. logl_const holds log(y).
+	 */
+	if (ds->link_covariates || ds->predictor_invlinkfunc != link_log) {
+		return GMRFLib_SUCCESS;
+	}
+
+	int k, i;
+	double *y = ds->data_observations.y, *s = ds->data_observations.gamma_weight, *ly = ds->data_observations.logl_const;
+	double phi_param = map_exp(ds->data_observations.gamma_log_prec[GMRFLib_thread_id][0], MAP_FORWARD, NULL);
+	double phi, phi_prev = -1.0, lgamma_phi = 0.0, eta, y_mu;
+
+	for (k = 0; k < n; k++) {
+		i = idx[k];
+		phi = phi_param * s[i];
+		if (phi != phi_prev) {
+			/*
+			 * the scalings are mostly equal, so this is mostly computed once
+			 */
+			lgamma_phi = gsl_sf_lngamma(phi);
+			phi_prev = phi;
+		}
+		eta = x0[k] + OFFSET(i);
+		y_mu = y[i] * exp(-eta);
+		f0[k] = -lgamma_phi + (phi - 1.0) * ly[i] + phi * log(phi) - phi * (eta + y_mu);
+		df[k] = -phi * (1.0 - y_mu);
+		ddf[k] = -phi * y_mu;
+		done[k] = 1;
+	}
+
+	return GMRFLib_SUCCESS;
+}
 double inla_Phi(double x)
 {
 	/*
@@ -3392,7 +3892,7 @@ int loglikelihood_gaussian(double *logll, double *x, int m, int idx, double *x_v
 
 	y = ds->data_observations.y[idx];
 	w = ds->data_observations.weight_gaussian[idx];
-	lprec = ds->data_observations.log_prec_gaussian[GMRFLib_thread_id][0] + log(w);
+	lprec = ds->data_observations.log_prec_gaussian[GMRFLib_thread_id][0] + LOGL_CONST(log(w));
 	prec = map_precision(ds->data_observations.log_prec_gaussian[GMRFLib_thread_id][0], MAP_FORWARD, NULL) * w;
 
 	LINK_INIT;
@@ -4127,7 +4627,7 @@ int loglikelihood_poisson(double *logll, double *x, int m, int idx, double *x_ve
 
 	int i;
 	Data_section_tp *ds = (Data_section_tp *) arg;
-	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = gsl_sf_lnfact((unsigned int) y), lambda;
+	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = LOGL_CONST(gsl_sf_lnfact((unsigned int) y)), lambda;
 
 	LINK_INIT;
 	if (m > 0) {
@@ -4165,7 +4665,7 @@ int loglikelihood_zeroinflated_poisson0(double *logll, double *x, int m, int idx
 
 	int i;
 	Data_section_tp *ds = (Data_section_tp *) arg;
-	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = gsl_sf_lnfact((unsigned int) y),
+	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = LOGL_CONST(gsl_sf_lnfact((unsigned int) y)),
 	    p = map_probability(ds->data_observations.prob_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), mu, lambda;
 
 	LINK_INIT;
@@ -4215,7 +4715,7 @@ int loglikelihood_zeroinflated_poisson1(double *logll, double *x, int m, int idx
 
 	int i;
 	Data_section_tp *ds = (Data_section_tp *) arg;
-	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = gsl_sf_lnfact((unsigned int) y),
+	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = LOGL_CONST(gsl_sf_lnfact((unsigned int) y)),
 	    p = map_probability(ds->data_observations.prob_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), mu, lambda, logA, logB;
 
 	LINK_INIT;
@@ -4269,7 +4769,7 @@ int loglikelihood_zeroinflated_poisson2(double *logll, double *x, int m, int idx
 
 	int i;
 	Data_section_tp *ds = (Data_section_tp *) arg;
-	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = gsl_sf_lnfact((unsigned int) y),
+	double y = ds->data_observations.y[idx], E = ds->data_observations.E[idx], normc = LOGL_CONST(gsl_sf_lnfact((unsigned int) y)),
 	    alpha = map_exp(ds->data_observations.zeroinflated_alpha_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), mu, log_mu, p, lambda;
 
 	LINK_INIT;
@@ -4429,7 +4929,7 @@ int loglikelihood_negative_binomial(double *logll, double *x, int m, int idx, do
 
 	LINK_INIT;
 	if (m > 0) {
-		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);	/* near always the case we'll need this one */
+		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));	/* near always the case we'll need this one */
 		for (i = 0; i < m; i++) {
 			lambda = PREDICTOR_INVERSE_LINK(x[i] + OFFSET(idx));
 			mu = E * lambda;
@@ -4499,7 +4999,7 @@ int loglikelihood_zeroinflated_negative_binomial0(double *logll, double *x, int
 			/*
 			 * this is constant for the NegativeBinomial 
 			 */
-			lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);
+			lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));
 
 			for (i = 0; i < m; i++) {
 				lambda = PREDICTOR_INVERSE_LINK(x[i] + OFFSET(idx));
@@ -4572,7 +5072,7 @@ int loglikelihood_zeroinflated_negative_binomial1(double *logll, double *x, int
 		/*
 		 * this is constant for the NegativeBinomial 
 		 */
-		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);
+		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));
 
 		if ((int) y == 0) {
 			for (i = 0; i < m; i++) {
@@ -4666,7 +5166,7 @@ int loglikelihood_zeroinflated_negative_binomial1_strata2(double *logll, double
 		/*
 		 * this is constant for the NegativeBinomial 
 		 */
-		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);
+		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));
 
 		if ((int) y == 0) {
 			for (i = 0; i < m; i++) {
@@ -4762,7 +5262,7 @@ int loglikelihood_zeroinflated_negative_binomial1_strata3(double *logll, double
 		/*
 		 * this is constant for the NegativeBinomial 
 		 */
-		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);
+		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));
 
 		if ((int) y == 0) {
 			for (i = 0; i < m; i++) {
@@ -4848,7 +5348,7 @@ int loglikelihood_zeroinflated_negative_binomial2(double *logll, double *x, int
 		/*
 		 * this is constant for the NegativeBinomial 
 		 */
-		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - gsl_sf_lngamma(y + 1.0);
+		lnorm = gsl_sf_lngamma(y + size) - gsl_sf_lngamma(size) - LOGL_CONST(gsl_sf_lngamma(y + 1.0));
 
 		if ((int) y == 0) {
 			for (i = 0; i < m; i++) {
@@ -4934,7 +5434,6 @@ int loglikelihood_binomial(double *logll, double *x, int m, int idx, double *x_v
 	if (m == 0) {
 		return GMRFLib_LOGL_COMPUTE_CDF;
 	}
-	int status;
 	Data_section_tp *ds = (Data_section_tp *) arg;
 	double y = ds->data_observations.y[idx], n = ds->data_observations.nb[idx], p;
 
@@ -4960,8 +5459,12 @@ int loglikelihood_binomial(double *logll, double *x, int m, int idx, double *x_v
 	LINK_INIT;
 	if (m > 0) {
 		gsl_sf_result res;
-		status = gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
-		assert(status == GSL_SUCCESS);
+		if (ds->data_observations.logl_const) {
+			res.val = ds->data_observations.logl_const[idx];
+		} else {
+			int status = gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
+			assert(status == GSL_SUCCESS);
+		}
 		for (i = 0; i < m; i++) {
 			p = PREDICTOR_INVERSE_LINK(x[i] + OFFSET(idx));
 			p = DMAX(0.0, DMIN(1.0, p));
@@ -5225,7 +5728,7 @@ int loglikelihood_zeroinflated_binomial0(double *logll, double *x, int m, int id
 		}
 	} else {
 		gsl_sf_result res;
-		gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
+		res.val = LOGL_CONST(gsl_sf_lnchoose((unsigned int) n, (unsigned int) y));
 		if (m > 0) {
 			for (i = 0; i < m; i++) {
 				prob = PREDICTOR_INVERSE_LINK(x[i] + OFFSET(idx));
@@ -5258,7 +5761,7 @@ int loglikelihood_zeroinflated_binomial1(double *logll, double *x, int m, int id
 	    p = map_probability(ds->data_observations.prob_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), prob = 0.0, logA, logB;
 
 	gsl_sf_result res;
-	gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
+	res.val = LOGL_CONST(gsl_sf_lnchoose((unsigned int) n, (unsigned int) y));
 
 	LINK_INIT;
 	if ((int) y == 0) {
@@ -5311,7 +5814,7 @@ int loglikelihood_zeroinflated_binomial2(double *logll, double *x, int m, int id
 	    alpha = map_exp(ds->data_observations.zeroinflated_alpha_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), logA, logB;
 
 	gsl_sf_result res;
-	gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
+	res.val = LOGL_CONST(gsl_sf_lnchoose((unsigned int) n, (unsigned int) y));
 
 	LINK_INIT;
 	if ((int) y == 0) {
@@ -5403,7 +5906,7 @@ int loglikelihood_zero_n_inflated_binomial2(double *logll, double *x, int m, int
 	    alpha2 = map_exp(ds->data_observations.zero_n_inflated_alpha2_intern[GMRFLib_thread_id][0], MAP_FORWARD, NULL), p, p1, p2, logA, logB;
 
 	gsl_sf_result res;
-	gsl_sf_lnchoose_e((unsigned int) n, (unsigned int) y, &res);
+	res.val = LOGL_CONST(gsl_sf_lnchoose((unsigned int) n, (unsigned int) y));
 
 	LINK_INIT;
 	if ((int) y == 0) {
@@ -5490,7 +5993,7 @@ int loglikelihood_gamma(double *logll, double *x, int m, int idx, double *x_vec,
 	double phi, mu, a, b, c;
 
 	phi = phi_param * s;
-	c = -gsl_sf_lngamma(phi) + (phi - 1.0) * log(y) + phi * log(phi);
+	c = -gsl_sf_lngamma(phi) + (phi - 1.0) * LOGL_CONST(log(y)) + phi * log(phi);
 	LINK_INIT;
 
 	if (m > 0) {
@@ -7220,6 +7723,7 @@ inla_tp *inla_build(const char *dict_filename, int verbose, int make_dir)
 	 * default: gaussian data is on, then its turned off... 
 	 */
 	mb->gaussian_data = GMRFLib_TRUE;
+	mb->logl_group_use = GMRFLib_TRUE;
 
 	/*
 	 * ...then parse the sections in this order: EXPERT, MODE, PROBLEM, PREDICTOR, DATA, FFIELD, LINEAR, INLA, UPDATE, LINCOMB, OUTPUT
@@ -7562,6 +8066,7 @@ inla_tp *inla_build(const char *dict_filename, int verbose, int make_dir)
 	mb->d = Calloc(mb->predictor_ndata, double);
 	mb->family_idx = Calloc(mb->predictor_ndata, double);
 	mb->len_family_idx = mb->predictor_ndata;
+	mb->logl_group = Calloc(mb->predictor_ndata, int);
 
 	for (i = 0; i < mb->predictor_ndata; i++) {
 		for (j = found = 0; j < mb->nds; j++) {
@@ -7578,16 +8083,47 @@ inla_tp *inla_build(const char *dict_filename, int verbose, int make_dir)
 
 		if (found) {
 			mb->family_idx[i] = k;
+			mb->logl_group[i] = k;
 			mb->loglikelihood[i] = mb->data_sections[k].loglikelihood;
 			mb->loglikelihood_arg[i] = (void *) &(mb->data_sections[k]);
 			mb->d[i] = mb->data_sections[k].data_observations.d[i];
 		} else {
 			mb->family_idx[i] = NAN;
+			mb->logl_group[i] = mb->nds;
 			mb->loglikelihood[i] = NULL;
 			mb->loglikelihood_arg[i] = NULL;
 			mb->d[i] = 0.0;
 		}
 	}
+
+	/*
+	 * the run table for the likelihood: the groups are the data-sections with observations, renumbered 0,1,..., and
+	 * mb->logl_ngroups for the rest. it is only used with the batch-likelihood, and there is nothing to group with one
+	 * data-section only.
+	 */
+	mb->logl_ngroups = 0;
+	if (mb->logl_group_use) {
+		int *new_group = Calloc(mb->nds + 1, int);
+
+		for (j = 0; j < mb->nds + 1; j++) {
+			new_group[j] = -1;
+		}
+		for (i = 0; i < mb->predictor_ndata; i++) {
+			if (mb->logl_group[i] < mb->nds && new_group[mb->logl_group[i]] < 0) {
+				new_group[mb->logl_group[i]] = mb->logl_ngroups++;
+			}
+		}
+		new_group[mb->nds] = mb->logl_ngroups;
+		for (i = 0; i < mb->predictor_ndata; i++) {
+			mb->logl_group[i] = new_group[mb->logl_group[i]];
+		}
+		Free(new_group);
+	}
+	GMRFLib_set_logl_group(loglikelihood_inla, (mb->logl_group_use ? mb->logl_group : NULL), mb->predictor_ndata, mb->logl_ngroups);
+	if (mb->verbose) {
+		printf("	group.likelihood = %1d (%1d groups)\n", (GMRFLib_logl_group_active(loglikelihood_inla) ? 1 : 0), mb->logl_ngroups);
+	}
+
 	mb->data_ntheta_all = 0;
 	for (j = 0; j < mb->nds; j++) {
 		mb->data_ntheta_all += mb->data_sections[j].data_ntheta + mb->data_sections[j].mix_ntheta + mb->data_sections[j].link_ntheta;
@@ -7938,6 +8474,8 @@ int inla_parse_problem(inla_tp * mb, dictionary * ini, int sec, int make_dir)
 		mb->strategy = GMRFLib_OPENMP_STRATEGY_LARGE;
 	} else if (!strcasecmp(openmp_strategy, "HUGE")) {
 		mb->strategy = GMRFLib_OPENMP_STRATEGY_HUGE;
+	} else if (!strcasecmp(openmp_strategy, "NESTED")) {
+		mb->strategy = GMRFLib_OPENMP_STRATEGY_NESTED;
 	} else {
 		GMRFLib_sprintf(&tmp, "Unknown openmp.strategy [%s]", openmp_strategy);
 		inla_error_general(tmp);
@@ -7948,8 +8486,12 @@ int inla_parse_problem(inla_tp * mb, dictionary * ini, int sec, int make_dir)
 	if (smtp) {
 		if (!strcasecmp(smtp, "GMRFLib_SMTP_BAND") || !strcasecmp(smtp, "BAND")) {
 			GMRFLib_smtp = GMRFLib_SMTP_BAND;
+		} else if (!strcasecmp(smtp, "GMRFLib_SMTP_PROFILE") || !strcasecmp(smtp, "PROFILE")) {
+			GMRFLib_smtp = GMRFLib_SMTP_PROFILE;
 		} else if (!strcasecmp(smtp, "GMRFLib_SMTP_TAUCS") || !strcasecmp(smtp, "TAUCS")) {
 			GMRFLib_smtp = GMRFLib_SMTP_TAUCS;
+		} else if (!strcasecmp(smtp, "GMRFLib_SMTP_TAUCS_OOC") || !strcasecmp(smtp, "TAUCS.OOC") || !strcasecmp(smtp, "OOC")) {
+			GMRFLib_smtp = GMRFLib_SMTP_TAUCS_OOC;
 		} else {
 			inla_error_field_is_void(__GMRFLib_FuncName, secname, "smtp", smtp);
 		}
@@ -7957,6 +8499,16 @@ int inla_parse_problem(inla_tp * mb, dictionary * ini, int sec, int make_dir)
 			printf("\t\tsmtp=[%s]\n", smtp);
 		}
 	}
+
+	/*
+	 * where to put the factorisation, and how much memory it can use, for smtp = TAUCS.OOC. the memory is given in Mb.
+	 */
+	GMRFLib_ooc_dir = GMRFLib_strdup(iniparser_getstring(ini, inla_string_join(secname, "OOC.DIR"), GMRFLib_ooc_dir));
+	GMRFLib_ooc_memory = 1048576.0 * iniparser_getdouble(ini, inla_string_join(secname, "OOC.MEMORY"), GMRFLib_ooc_memory / 1048576.0);
+	if (mb->verbose && GMRFLib_smtp == GMRFLib_SMTP_TAUCS_OOC) {
+		printf("\t\tooc.dir=[%s]\n", (GMRFLib_ooc_dir ? GMRFLib_ooc_dir : "(default)"));
+		printf("\t\tooc.memory=[%.1f Mb]\n", GMRFLib_ooc_memory / 1048576.0);
+	}
 	mb->dir = GMRFLib_strdup(iniparser_getstring(ini, inla_string_join(secname, "DIR"), GMRFLib_strdup("results-%1d")));
 	ok = 0;
 	int accept_argument = 0;
@@ -18464,6 +19016,19 @@ int inla_parse_INLA(inla_tp * mb, dictionary * ini, int sec, int make_dir)
 
 	memcpy((void *) &(mb->gn), (void *) &GMRFLib_global_node, sizeof(GMRFLib_global_node_tp));
 
+	if (iniparser_getboolean(ini, inla_string_join(secname, "BATCH.LIKELIHOOD"), 0)) {
+		GMRFLib_set_logl_batch(loglikelihood_inla, loglikelihood_inla_batch);
+	} else {
+		GMRFLib_set_logl_batch(loglikelihood_inla, NULL);
+	}
+	if (mb->verbose) {
+		printf("\t\tbatch.likelihood = %1d\n", (GMRFLib_get_logl_batch(loglikelihood_inla) ? 1 : 0));
+	}
+	mb->logl_group_use = iniparser_getboolean(ini, inla_string_join(secname, "GROUP.LIKELIHOOD"), 1);
+	if (mb->verbose) {
+		printf("\t\tgroup.likelihood = %1d\n", mb->logl_group_use);
+	}
+
 	r = GMRFLib_strdup(iniparser_getstring(ini, inla_string_join(secname, "REORDERING"), NULL));
 	if (mb->verbose) {
 		printf("\t\treordering = %s\n", (r ? r : "(default)"));
@@ -18482,6 +19047,14 @@ int inla_parse_INLA(inla_tp * mb, dictionary * ini, int sec, int make_dir)
 		GMRFLib_reorder = G.reorder;		       /* yes! */
 	}
 
+	/*
+	 * directory for the cache of optimal reorderings, which makes repeated runs on the same graph skip the search
+	 */
+	GMRFLib_reorder_cache_dir = GMRFLib_strdup(iniparser_getstring(ini, inla_string_join(secname, "REORDERING.CACHE"), NULL));
+	if (mb->verbose) {
+		printf("\t\treordering.cache = %s\n", (GMRFLib_reorder_cache_dir ? GMRFLib_reorder_cache_dir : "(none)"));
+	}
+
 	mb->ai_par->cpo_req_diff_logdens = iniparser_getdouble(ini, inla_string_join(secname, "CPO.REQ.DIFF.LOGDENS"), mb->ai_par->cpo_req_diff_logdens);
 	mb->ai_par->cpo_req_diff_logdens = iniparser_getdouble(ini, inla_string_join(secname, "CPO.DIFF"), mb->ai_par->cpo_req_diff_logdens);
 	mb->ai_par->cpo_req_diff_logdens = DMAX(0.0, mb->ai_par->cpo_req_diff_logdens);
@@ -23456,6 +24029,44 @@ int inla_output_detail_dic(const char *dir, GMRFLib_ai_dic_tp * dic, double *fam
 #undef PAD_WITH_NA
 	return INLA_OK;
 }
+int inla_output_timings(inla_tp * mb, double *time_used)
+{
+	/*
+	 * write the timings per phase, and the merged timer-statistics per routine, to timings.json in the results-directory.
+	 * time_used is [preparations, approx inference, output] as measured in main().
+	 */
+	FILE *fp;
+	char *fnm = NULL;
+	double *wc = mb->misc_output->wall_clock_time_used, hess_wall, hess_cpu, qinv_wall, qinv_cpu;
+
+	GMRFLib_timer_lookup("GMRFLib_domin_estimate_hessian", NULL, &hess_wall, &hess_cpu);
+	GMRFLib_timer_lookup("GMRFLib_compute_Qinv", NULL, &qinv_wall, &qinv_cpu);
+
+	GMRFLib_sprintf(&fnm, "%s/timings.json", mb->dir);
+	fp = fopen(fnm, "w");
+	if (!fp) {
+		inla_error_open_file(fnm);
+	}
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"max_threads\": %1d,\n", GMRFLib_MAX_THREADS);
+	fprintf(fp, "\t\"phases\": {\n");
+	fprintf(fp, "\t\t\"preparations\": %.6f,\n", time_used[0] + wc[0]);
+	fprintf(fp, "\t\t\"optimize\": %.6f,\n", DMAX(0.0, wc[1] - hess_wall));
+	fprintf(fp, "\t\t\"hessian\": %.6f,\n", hess_wall);
+	fprintf(fp, "\t\t\"integrate\": %.6f,\n", wc[2]);
+	fprintf(fp, "\t\t\"postprocess\": %.6f,\n", wc[3]);
+	fprintf(fp, "\t\t\"output\": %.6f,\n", time_used[2]);
+	fprintf(fp, "\t\t\"total\": %.6f\n", time_used[0] + time_used[1] + time_used[2]);
+	fprintf(fp, "\t},\n");
+	fprintf(fp, "\t\"Qinv\": {\"wall\": %.6f, \"cpu\": %.6f},\n", qinv_wall, qinv_cpu);
+	fprintf(fp, "\t\"routines\": ");
+	GMRFLib_timer_report_json(fp);
+	fprintf(fp, "\n}\n");
+	fclose(fp);
+	Free(fnm);
+
+	return INLA_OK;
+}
 int inla_output_misc(const char *dir, GMRFLib_ai_misc_output_tp * mo, int ntheta, char **theta_tag, char **theta_from, char **theta_to,
 		     double *lc_order, int verbose, inla_tp * mb)
 {
@@ -24208,6 +24819,303 @@ int inla_integrate_func(double *d_mean, double *d_stdev, double *d_mode, GMRFLib
 #undef MAP_STDEV
 	return GMRFLib_SUCCESS;
 }
+int inla_output_detail_columnar(const char *ndir, GMRFLib_density_tp ** density, GMRFLib_density_tp ** gdensity, double *locations,
+				int n, int nrep, Output_tp * output, const char *sdir, map_func_tp * func, void *func_arg,
+				GMRFLib_transform_array_func_tp ** tfunc, const char *tag, const char *modelname, int verbose)
+{
+	/*
+	 * Write all results for one component into one file, `results.bin', with layout
+	 *
+	 *   header | tag | modelname | column-names | columns | index | points
+	 *
+	 * The columns are ncol arrays of length n, each with one summary statistic for all nodes. The index is, for each density-set, a prefix-sum (length
+	 * n+1) into `points', which is an array of (x, density) pairs. All sizes are known after the first pass, so the file is preallocated and then filled
+	 * in parallel, each node writing to its own offsets.
+	 *
+	 * This output (option -B) is experimental. The R-interface uses it with inla.setOption(internal.columnar.mode=TRUE); the file is read with
+	 * inla.read.columnar.results() and expanded into the classic files by inla.expand.columnar.results(), which must be updated if the layout changes.
+	 */
+#define FUNC (func ? func : NULL)
+#define FUNC_ARG (func ? func_arg : NULL)
+#define TFUNC(_idx) (tfunc ? tfunc[_idx] : NULL)
+
+#define MAP_DENS(_dens, _x_user, _idx) (func ? (_dens)/(ABS(func(_x_user, MAP_DFORWARD, func_arg))) : \
+					(tfunc ? (_dens)/(ABS(tfunc[_idx]->func(_x_user, GMRFLib_TRANSFORM_DFORWARD, tfunc[_idx]->arg, tfunc[_idx]->cov))) : \
+					 (_dens)))
+
+#define MAP_X(_x_user, _idx) (func ? func(_x_user, MAP_FORWARD, func_arg) : \
+			      (tfunc ? tfunc[_idx]->func(_x_user, GMRFLib_TRANSFORM_FORWARD, tfunc[_idx]->arg, tfunc[_idx]->cov) : \
+			       (_x_user)))
+
+#define MAP_INCREASING(_idx) (func ? func(0.0, MAP_INCREASING, func_arg) : \
+			      (tfunc ? tfunc[_idx]->func(0.0, GMRFLib_TRANSFORM_INCREASING, tfunc[_idx]->arg, tfunc[_idx]->cov) : 1))
+
+#define MAP_DECREASING(_idx) (!MAP_INCREASING(_idx))
+
+#define ALIGN8(_n) ((((_n) + 7) / 8) * 8)
+#define ADD_COLUMN(_prefix, _fmt, _val) snprintf(names + (ncol++) * INLA_COLUMNAR_NAME_LEN, INLA_COLUMNAR_NAME_LEN, "%s" _fmt, _prefix, _val)
+
+	char *nndir = NULL, *msg = NULL, *names = NULL, *base = NULL;
+	int i, j, k, set, ncol = 0, nset = 0, ndiv, with_points, ncol_set;
+	int col_off[2] = { -1, -1 }, kld_col = -1;
+	size_t tag_len, model_len, off, total;
+	double **xx_layout = NULL, *cols = NULL;
+	int64_t *index = NULL;
+	GMRFLib_density_tp **dset[2] = { NULL, NULL };
+	inla_columnar_header_tp header;
+
+	assert(nrep > 0);
+	ndiv = n / nrep;
+	with_points = (output->return_marginals || strncmp("hyperparameter", sdir, 13) == 0);
+
+	if (inla_computed(density, n)) {
+		dset[nset++] = density;
+	}
+	if (inla_computed(gdensity, n)) {
+		dset[nset++] = gdensity;
+	}
+
+	/*
+	 * the column layout: `ID', then for each density-set: mean, sd, mode, quantiles and cdf. The kld between the two sets comes last.
+	 */
+	ncol_set = 3 + output->nquantiles + output->ncdf;
+	names = Calloc((1 + nset * ncol_set + 1) * INLA_COLUMNAR_NAME_LEN, char);
+	ADD_COLUMN((locations ? "location" : "ID"), "%s", "");
+	for (set = 0; set < nset; set++) {
+		const char *pre = (dset[set] == gdensity ? "gaussian:" : "");
+
+		col_off[set] = ncol;
+		ADD_COLUMN(pre, "%s", "mean");
+		ADD_COLUMN(pre, "%s", "sd");
+		ADD_COLUMN(pre, "%s", "mode");
+		for (j = 0; j < output->nquantiles; j++) {
+			ADD_COLUMN(pre, "quant:%g", output->quantiles[j]);
+		}
+		for (j = 0; j < output->ncdf; j++) {
+			ADD_COLUMN(pre, "cdf:%g", output->cdf[j]);
+		}
+	}
+	if (output->kld && inla_computed(density, n)) {
+		kld_col = ncol;
+		ADD_COLUMN("", "%s", "kld");
+	}
+
+	cols = Calloc(ncol * IMAX(1, n), double);
+	index = Calloc(IMAX(1, nset) * (n + 1), int64_t);
+	xx_layout = Calloc(IMAX(1, nset) * IMAX(1, n), double *);
+
+	/*
+	 * first pass: all summaries and the layout of each density
+	 */
+#pragma omp parallel for private(i, j, set)
+	for (i = 0; i < n; i++) {
+		double x, xp, p, x_user, d_mean, d_stdev, d_mode, *col;
+		int nn;
+
+		cols[i] = (locations ? locations[i % ndiv] : (double) i);
+		for (set = 0; set < nset; set++) {
+			GMRFLib_density_tp *d = dset[set][i];
+
+			col = cols + col_off[set] * n;
+			if (!d) {
+				for (j = 0; j < ncol_set; j++) {
+					col[j * n + i] = NAN;
+				}
+				index[set * (n + 1) + i + 1] = (with_points ? 3 : 0);
+				continue;
+			}
+			inla_integrate_func(&d_mean, &d_stdev, &d_mode, d, FUNC, FUNC_ARG, TFUNC(i));
+			col[0 * n + i] = d_mean;
+			col[1 * n + i] = d_stdev;
+			col[2 * n + i] = d_mode;
+			col += 3 * n;
+			for (j = 0; j < output->nquantiles; j++) {
+				p = output->quantiles[j];
+				GMRFLib_density_Pinv(&xp, (MAP_INCREASING(i) ? p : 1.0 - p), d);
+				x_user = GMRFLib_density_std2user(xp, d);
+				col[j * n + i] = MAP_X(x_user, i);
+			}
+			col += output->nquantiles * n;
+			for (j = 0; j < output->ncdf; j++) {
+				xp = output->cdf[j];
+				x = GMRFLib_density_user2std(xp, d);
+				GMRFLib_density_P(&p, x, d);
+				col[j * n + i] = (MAP_DECREASING(i) ? 1.0 - p : p);
+			}
+			if (with_points) {
+				GMRFLib_density_layout_x(&xx_layout[set * n + i], &nn, d);
+				index[set * (n + 1) + i + 1] = nn;
+			}
+		}
+		if (kld_col >= 0) {
+			double kld = NAN;
+
+			if (density[i]) {
+				GMRFLib_density_tp *gd = NULL;
+
+				if (nset == 2) {
+					gd = gdensity[i];
+				} else {
+					GMRFLib_density_create_normal(&gd, 0.0, 1.0, density[i]->std_mean, density[i]->std_stdev);
+				}
+				if (gd) {
+					if (G.fast_mode) {
+						GMRFLib_mkld_sym(&kld, gd, density[i]);
+					} else {
+						GMRFLib_kld_sym(&kld, gd, density[i]);
+					}
+				}
+				if (nset != 2) {
+					GMRFLib_free_density(gd);
+				}
+			}
+			cols[kld_col * n + i] = kld;
+		}
+	}
+
+	/*
+	 * prefix-sums gives each node its offset in `points'
+	 */
+	for (set = 0; set < nset; set++) {
+		int64_t *idx = index + set * (n + 1);
+
+		idx[0] = (set == 0 ? 0 : index[set * (n + 1) - 1]);
+		for (i = 0; i < n; i++) {
+			idx[i + 1] += idx[i];
+		}
+	}
+
+	tag_len = (tag ? strlen(tag) : 0);
+	model_len = (modelname ? strlen(modelname) : 0);
+
+	memset(&header, 0, sizeof(inla_columnar_header_tp));
+	memcpy(header.magic, INLA_COLUMNAR_MAGIC, sizeof(header.magic));
+	header.version = INLA_COLUMNAR_VERSION;
+	header.n = n;
+	header.nrep = nrep;
+	header.ncol = ncol;
+	header.nset = nset;
+	header.flags = (locations ? INLA_COLUMNAR_LOCATIONS : 0) | (with_points ? INLA_COLUMNAR_POINTS : 0) |
+	    (inla_computed(gdensity, n) ? INLA_COLUMNAR_GAUSSIAN : 0);
+	header.npoints = (nset > 0 ? index[nset * (n + 1) - 1] : 0);
+
+	off = ALIGN8(sizeof(inla_columnar_header_tp));
+	header.off_tag = off;
+	header.tag_len = tag_len;
+	off += ALIGN8(tag_len);
+	header.off_model = off;
+	header.model_len = model_len;
+	off += ALIGN8(model_len);
+	header.off_names = off;
+	off += (size_t) ncol *INLA_COLUMNAR_NAME_LEN;
+	header.off_columns = off;
+	off += (size_t) ncol *n * sizeof(double);
+	header.off_index = off;
+	off += (size_t) nset *(n + 1) * sizeof(int64_t);
+	header.off_points = off;
+	off += (size_t) header.npoints * 2 * sizeof(double);
+	total = off;
+
+	GMRFLib_sprintf(&nndir, "%s/%s", ndir, "results.bin");
+	inla_fnmfix(nndir);
+	if (verbose) {
+#pragma omp critical
+		{
+			printf("\t\tstore columnar results in[%s] size[%.3fMb]\n", nndir, total / 1048576.0);
+		}
+	}
+#if defined(WINDOWS)
+	base = Calloc(total, char);
+#else
+	int fd = open(nndir, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		inla_error_open_file(nndir);
+	}
+	if (ftruncate(fd, (off_t) total) != 0) {
+		GMRFLib_sprintf(&msg, "fail to allocate [%zu] bytes for file [%s]: %s", total, nndir, strerror(errno));
+		inla_error_general(msg);
+	}
+	base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		GMRFLib_sprintf(&msg, "fail to mmap file [%s]: %s", nndir, strerror(errno));
+		inla_error_general(msg);
+	}
+#endif
+
+	memcpy(base, &header, sizeof(inla_columnar_header_tp));
+	if (tag_len) {
+		memcpy(base + header.off_tag, tag, tag_len);
+	}
+	if (model_len) {
+		memcpy(base + header.off_model, modelname, model_len);
+	}
+	memcpy(base + header.off_names, names, (size_t) ncol * INLA_COLUMNAR_NAME_LEN);
+	memcpy(base + header.off_columns, cols, (size_t) ncol * n * sizeof(double));
+	if (nset) {
+		memcpy(base + header.off_index, index, (size_t) nset * (n + 1) * sizeof(int64_t));
+	}
+
+	/*
+	 * second pass: evaluate the densities directly into their slots
+	 */
+	if (with_points && nset) {
+		double *points = (double *) (base + header.off_points);
+
+#pragma omp parallel for private(i, k, set)
+		for (i = 0; i < n; i++) {
+			for (set = 0; set < nset; set++) {
+				GMRFLib_density_tp *d = dset[set][i];
+				int64_t first = index[set * (n + 1) + i];
+				int nn = (int) (index[set * (n + 1) + i + 1] - first);
+				double *pt = points + 2 * first, *xx = xx_layout[set * n + i];
+
+				for (k = 0; k < nn; k++) {
+					if (d) {
+						double x_user, dens, dens_user;
+
+						x_user = GMRFLib_density_std2user(xx[k], d);
+						GMRFLib_evaluate_density(&dens, xx[k], d);
+						dens_user = dens / d->std_stdev;
+						pt[2 * k] = MAP_X(x_user, i);
+						pt[2 * k + 1] = MAP_DENS(dens_user, x_user, i);
+					} else {
+						pt[2 * k] = pt[2 * k + 1] = NAN;
+					}
+				}
+				Free(xx);
+			}
+		}
+	}
+#if defined(WINDOWS)
+	FILE *fp = fopen(nndir, "wb");
+	if (!fp) {
+		inla_error_open_file(nndir);
+	}
+	fwrite(base, sizeof(char), total, fp);
+	fclose(fp);
+	Free(base);
+#else
+	munmap(base, total);
+	close(fd);
+#endif
+
+	Free(nndir);
+	Free(names);
+	Free(cols);
+	Free(index);
+	Free(xx_layout);
+
+#undef ALIGN8
+#undef ADD_COLUMN
+#undef MAP_DENS
+#undef MAP_X
+#undef MAP_INCREASING
+#undef MAP_DECREASING
+#undef FUNC
+#undef FUNC_ARG
+#undef TFUNC
+	return INLA_OK;
+}
 int inla_output_detail(const char *dir, GMRFLib_density_tp ** density, GMRFLib_density_tp ** gdensity, double *locations,
 		       int n, int nrep, Output_tp * output, const char *sdir,
 		       // Either this
@@ -24255,6 +25163,16 @@ int inla_output_detail(const char *dir, GMRFLib_density_tp ** density, GMRFLib_d
 		inla_error_general(msg);
 	}
 	Free(ssdir);
+	if (G.columnar) {
+		/*
+		 * everything goes into one file
+		 */
+		inla_output_detail_columnar(ndir, density, gdensity, locations, n, nrep, output, sdir, func, func_arg, tfunc, tag, modelname, verbose);
+		Free(ndir);
+		Free(d_mode);
+		Free(g_mode);
+		return INLA_OK;
+	}
 	if (1) {
 		GMRFLib_sprintf(&nndir, "%s/%s", ndir, "N");
 		inla_fnmfix(nndir);
@@ -25308,7 +26226,6 @@ int inla_qsolve(const char *Qfilename, const char *Afilename, const char *Bfilen
 	GMRFLib_tabulate_Qfunc_tp *tab;
 	GMRFLib_graph_tp *graph;
 	GMRFLib_problem_tp *problem;
-	int i;
 
 	GMRFLib_tabulate_Qfunc_from_file(&tab, &graph, Qfilename, -1, NULL, NULL, NULL);
 	if (G.reorder < 0) {
@@ -25323,17 +26240,14 @@ int inla_qsolve(const char *Qfilename, const char *Afilename, const char *Bfilen
 	assert(B->i == NULL);				       /* I want B as dense matrix */
 	assert(problem->n == B->nrow);
 
-#pragma omp parallel for private(i)
-	for (i = 0; i < B->ncol; i++) {
-		if (!strcasecmp(method, "solve")) {
-			GMRFLib_solve_llt_sparse_matrix(&(B->A[i * B->nrow]), &(problem->sub_sm_fact), problem->sub_graph);
-		} else if (!strcasecmp(method, "forward")) {
-			GMRFLib_solve_l_sparse_matrix(&(B->A[i * B->nrow]), &(problem->sub_sm_fact), problem->sub_graph);
-		} else if (!strcasecmp(method, "backward")) {
-			GMRFLib_solve_lt_sparse_matrix(&(B->A[i * B->nrow]), &(problem->sub_sm_fact), problem->sub_graph);
-		} else {
-			assert(0 == 1);
-		}
+	if (!strcasecmp(method, "solve")) {
+		GMRFLib_solve_llt_sparse_matrix_nrhs(B->A, B->ncol, &(problem->sub_sm_fact), problem->sub_graph);
+	} else if (!strcasecmp(method, "forward")) {
+		GMRFLib_solve_l_sparse_matrix_nrhs(B->A, B->ncol, &(problem->sub_sm_fact), problem->sub_graph);
+	} else if (!strcasecmp(method, "backward")) {
+		GMRFLib_solve_lt_sparse_matrix_nrhs(B->A, B->ncol, &(problem->sub_sm_fact), problem->sub_graph);
+	} else {
+		assert(0 == 1);
 	}
 
 	B->iA = NULL;
@@ -25414,15 +26328,26 @@ int inla_qsample(const char *filename, const char *outfile, const char *nsamples
 	M->elems = M->ncol * M->nrow;
 	M->A = Calloc(M->nrow * M->ncol, double);
 
-	for (i = 0; i < ns; i++) {
-		if (!S) {
-			GMRFLib_sample(problem);
-		} else {
+	if (!S) {
+		/*
+		 * generate all samples in one batch, then add the log-densities as the last row
+		 */
+		double *samples = Calloc(graph->n * ns, double), *logdens = Calloc(ns, double);
+
+		GMRFLib_sample_batch(problem, ns, samples, logdens);
+		for (i = 0; i < ns; i++) {
+			memcpy(&(M->A[i * M->nrow]), &(samples[i * graph->n]), graph->n * sizeof(double));
+			M->A[(i + 1) * M->nrow - 1] = logdens[i];
+		}
+		Free(samples);
+		Free(logdens);
+	} else {
+		for (i = 0; i < ns; i++) {
 			memcpy(problem->sample, &(S->A[i * S->nrow]), S->nrow * sizeof(double));
+			GMRFLib_evaluate(problem);
+			memcpy(&(M->A[i * M->nrow]), problem->sample, M->nrow * sizeof(double));
+			M->A[(i + 1) * M->nrow - 1] = problem->sub_logdens;
 		}
-		GMRFLib_evaluate(problem);
-		memcpy(&(M->A[i * M->nrow]), problem->sample, M->nrow * sizeof(double));
-		M->A[(i + 1) * M->nrow - 1] = problem->sub_logdens;
 	}
 
 	GMRFLib_write_fmesher_file(M, outfile, (long int) 0, -1);
@@ -26011,6 +26936,8 @@ int main(int argc, char **argv)
 	printf("\t\t-v\t: Verbose output.\n");				\
 	printf("\t\t-V\t: Print version and exit.\n");			\
 	printf("\t\t-b\t: Use binary output-files.\n");			\
+	printf("\t\t-B\t: Use one memory-mapped columnar results-file per component (experimental; inla.setOption(internal.columnar.mode=TRUE) in R).\n"); \
+	printf("\t\t-P\t: Write timings per phase and routine to timings.json in the results-directory.\n"); \
 	printf("\t\t-s\t: Be silent.\n");				\
 	printf("\t\t-c\t: Create core-file if needed (and allowed). (Linux/MacOSX only.)\n"); \
 	printf("\t\t-R\t: Restart using previous mode.\n");		\
@@ -26023,7 +26950,7 @@ int main(int argc, char **argv)
 
 #define BUGS_intern(fp) fprintf(fp, "Report bugs to <help@r-inla.org>\n")
 #define BUGS BUGS_intern(stdout)
-	int i, verbose = 0, silent = 0, opt, report = 0, arg, nt, err, ncpu, enable_core_file = 0;
+	int i, verbose = 0, silent = 0, opt, report = 0, profile = 0, arg, nt, err, ncpu, enable_core_file = 0;
 	char *program = argv[0];
 	double time_used[3];
 	inla_tp *mb = NULL;
@@ -26059,12 +26986,21 @@ int main(int argc, char **argv)
 	signal(SIGUSR1, inla_signal);
 	signal(SIGUSR2, inla_signal);
 #endif
-	while ((opt = getopt(argc, argv, "bvVe:fhist:m:S:T:N:r:FYz:cp")) != -1) {
+	while ((opt = getopt(argc, argv, "bBPvVe:fhist:m:S:T:N:r:FYz:cp")) != -1) {
 		switch (opt) {
 		case 'b':
 			G.binary = 1;
 			break;
 
+		case 'B':
+			G.columnar = 1;
+			break;
+
+		case 'P':
+			GMRFLib_collect_timer_statistics = GMRFLib_TRUE;
+			profile = 1;
+			break;
+
 		case 'v':
 			silent = 1;
 			verbose++;
@@ -26374,6 +27310,9 @@ int main(int argc, char **argv)
 				printf("\tTotal           : %7.3f seconds\n", time_used[0] + time_used[1] + time_used[2]);
 				printf("\n");
 			}
+			if (profile) {
+				inla_output_timings(mb, time_used);
+			}
 
 			/*
 			 * close fifo-pipes
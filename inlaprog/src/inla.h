@@ -132,6 +132,7 @@ typedef struct {
 	double *d;					       /* the d-array */
 	int ndata;					       /* length of data (from file) */
 	double *y;					       /* general responce */
+	double *logl_const;				       /* theta-independent part of the log-likelihood; family dependent */
 
 	/*
 	 * y ~ Poisson(E*exp(x)) 
@@ -748,6 +749,9 @@ struct inla_tp_struct {
 	void **loglikelihood_arg;
 	Data_section_tp *data_sections;
 	GMRFLib_logl_tp **loglikelihood;
+	int *logl_group;				       /* the run table: the group of each observation, see inla_build() */
+	int logl_ngroups;				       /* the number of groups in logl_group */
+	int logl_group_use;				       /* use the grouping with the batch-likelihood? */
 
 	/*
 	 * type Ffield 
@@ -1190,6 +1194,35 @@ typedef struct {
 #define IDW(a, b)  {IW(a); DW(b);}
 #define ID2W(a, b, c)  {IW(a); D2W(b, c);}
 
+/* 
+   the columnar results-file, see inla_output_detail_columnar()
+ */
+#define INLA_COLUMNAR_MAGIC "INLACOL1"
+#define INLA_COLUMNAR_VERSION 1
+#define INLA_COLUMNAR_NAME_LEN 32			       /* fixed width of each column-name */
+#define INLA_COLUMNAR_LOCATIONS (1 << 0)		       /* first column is `location' and not `ID' */
+#define INLA_COLUMNAR_POINTS    (1 << 1)		       /* the marginal densities are stored */
+#define INLA_COLUMNAR_GAUSSIAN  (1 << 2)		       /* the second density-set is the gaussian approximation */
+
+typedef struct {
+	char magic[8];
+	int64_t version;
+	int64_t n;					       /* number of nodes */
+	int64_t nrep;
+	int64_t ncol;					       /* number of columns, each of length n */
+	int64_t nset;					       /* number of density-sets (0, 1 or 2) */
+	int64_t flags;
+	int64_t npoints;				       /* number of (x, density) pairs */
+	int64_t off_tag;				       /* byte-offsets from the start of the file */
+	int64_t tag_len;
+	int64_t off_model;
+	int64_t model_len;
+	int64_t off_names;
+	int64_t off_columns;
+	int64_t off_index;				       /* nset * (n+1) prefix-sums into the points */
+	int64_t off_points;
+} inla_columnar_header_tp;
+
 
 /* 
    functions
@@ -1370,6 +1403,9 @@ int inla_output_Q(inla_tp * mb, const char *dir, GMRFLib_graph_tp * graph);
 int inla_output_detail(const char *dir, GMRFLib_density_tp ** density, GMRFLib_density_tp ** gdensity, double *locations, int n, int nrep, Output_tp * output,
 		       const char *sdir, map_func_tp * func, void *func_arg, GMRFLib_transform_array_func_tp ** tfunc, const char *tag, const char *modelname,
 		       int verbose);
+int inla_output_detail_columnar(const char *ndir, GMRFLib_density_tp ** density, GMRFLib_density_tp ** gdensity, double *locations, int n, int nrep,
+				Output_tp * output, const char *sdir, map_func_tp * func, void *func_arg, GMRFLib_transform_array_func_tp ** tfunc,
+				const char *tag, const char *modelname, int verbose);
 int inla_output_detail_cpo(const char *dir, GMRFLib_ai_cpo_tp * cpo, int predictor_n, int verbose);
 int inla_output_detail_dic(const char *dir, GMRFLib_ai_dic_tp * dic, double *family_idx, int len_family_idx, int verbose);
 int inla_output_detail_mlik(const char *dir, GMRFLib_ai_marginal_likelihood_tp * mlik, int verbose);
@@ -1383,6 +1419,7 @@ int inla_output_hgid(const char *dir);
 int inla_output_id_names(const char *dir, const char *sdir, inla_file_contents_tp * fc);
 int inla_output_linkfunctions(const char *dir, inla_tp * mb);
 int inla_output_matrix(const char *dir, const char *sdir, const char *filename, int n, double *matrix, int *order);
+int inla_output_timings(inla_tp * mb, double *time_used);
 int inla_output_misc(const char *dir, GMRFLib_ai_misc_output_tp * mo, int ntheta, char **theta_tag, char **from_theta, char **to_theta, double *lc_order,
 		     int verbose, inla_tp * mb);
 int inla_output_names(const char *dir, const char *sdir, int n, const char **names, const char *suffix);
@@ -1405,6 +1442,8 @@ int inla_qsample(const char *filename, const char *outfile, const char *nsamples
 		 const char *mufile, const char *constr_file);
 int inla_qsolve(const char *Qfilename, const char *Afilename, const char *Bfilename, const char *method);
 int inla_read_data_all(double **x, int *n, const char *filename);
+int inla_read_data_ascii(double **x, int *n, const char *filename);
+int inla_parse_double(double *x, const char *s, size_t len);
 int inla_read_data_general(double **xx, int **ix, int *nndata, const char *filename, int n, int column, int n_columns, int verbose, double default_value);
 int inla_read_data_likelihood(inla_tp * mb, dictionary * ini, int sec);
 int inla_read_fileinfo(inla_tp * mb, dictionary * ini, int sec, File_tp * file, const char *FILENAME);
@@ -1451,12 +1490,19 @@ int loglikelihood_cbinomial(double *logll, double *x, int m, int idx, double *x_
 int loglikelihood_circular_normal(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_exp(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_gaussian(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
+int loglikelihood_gamma(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_gammacount(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_gev(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_gpoisson(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_iid_gamma(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_iid_logitbeta(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_inla(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
+int loglikelihood_inla_batch(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, double *x_vec, void *arg);
+int loglikelihood_batch_binomial(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds);
+int loglikelihood_batch_gamma(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds);
+int loglikelihood_batch_gaussian(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds);
+int loglikelihood_batch_negative_binomial(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds);
+int loglikelihood_batch_poisson(double *f0, double *df, double *ddf, char *done, int n, int *idx, double *x0, Data_section_tp * ds);
 int loglikelihood_laplace(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_loggamma_frailty(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
 int loglikelihood_logistic(double *logll, double *x, int m, int idx, double *x_vec, void *arg);
@@ -1510,6 +1556,7 @@ double Qfunc_rw2diid(int i, int j, void *arg);
 
 typedef struct {
 	int binary;					       /* use binary output-files */
+	int columnar;					       /* use one columnar results-file per component */
 	int fast_mode;					       /* avoid detailed calculations but use ok approximations */
 	inla_mode_tp mode;				       /* which mode to run in */
 	double log_prec_initial;			       /* inititial value for log-precisions */
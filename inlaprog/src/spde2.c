@@ -53,9 +53,14 @@ double inla_spde2_Qfunction(int i, int j, void *arg)
 	int k, kk;
 
 	/*
-	 * to hold the i'th and j'th row of the B-matrices. use one storage only 
+	 * to hold the i'th and j'th row of the B-matrices. use one storage only, from the arena of this thread as this is called
+	 * for every element of Q.
 	 */
-	double *row_i = Calloc(2 * model->B[0]->ncol, double);
+	GMRFLib_arena_tp *arena = GMRFLib_arena_thread();
+	GMRFLib_arena_mark_tp arena_mark;
+
+	GMRFLib_arena_mark(arena, &arena_mark);
+	double *row_i = Arena_Calloc(arena, 2 * model->B[0]->ncol, double);
 	double *row_j = &row_i[model->B[0]->ncol];
 
 	for (k = 0; k < 3; k++) {
@@ -89,7 +94,7 @@ double inla_spde2_Qfunction(int i, int j, void *arg)
 			}
 		}
 	}
-	Free(row_i);
+	GMRFLib_arena_release(arena, &arena_mark);
 
 	for (k = 0; k < 2; k++) {
 		d_i[k] = exp(phi_i[k]);
@@ -217,9 +217,14 @@ double inla_spde3_Qfunction(int i, int j, void *arg)
 	int k, kk, use_store = 1, debug = 0;
 
 	/*
-	 * to hold the i'th and j'th and k'th row of the B-matrices. use one storage only
+	 * to hold the i'th and j'th and k'th row of the B-matrices. use one storage only, from the arena of this thread as this is
+	 * called for every element of Q.
 	 */
-	double *row_i = Calloc(3 * model->B[0]->ncol, double), *row_j, *row_k;
+	GMRFLib_arena_tp *arena = GMRFLib_arena_thread();
+	GMRFLib_arena_mark_tp arena_mark;
+
+	GMRFLib_arena_mark(arena, &arena_mark);
+	double *row_i = Arena_Calloc(arena, 3 * model->B[0]->ncol, double), *row_j, *row_k;
 	row_j = &row_i[model->B[0]->ncol];
 	row_k = &row_i[2 * model->B[0]->ncol];
 
@@ -389,7 +394,7 @@ double inla_spde3_Qfunction(int i, int j, void *arg)
 		value += d_i[0] * d_j[0] * m3_value;
 	}
 #undef D3
-	Free(row_i);
+	GMRFLib_arena_release(arena, &arena_mark);
 
 	return value;
 }